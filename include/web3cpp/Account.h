@@ -2,6 +2,8 @@
 #define ACCOUNTS_H
 
 #include <future>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -25,7 +27,8 @@ class Account {
     std::string _address;                                        ///< Address for the account.
     std::string _name;                                           ///< Custom name/label for the account.
     std::string _privateKey;                                     ///< Private key for the account..
-    uint64_t _nonce;                                             ///< Current nonce for the account.
+    mutable std::optional<uint64_t> _nonce;                      ///< Current nonce for the account, if known.
+    mutable std::mutex _nonceLock;                               ///< Mutex for loading _nonce.
     const std::unique_ptr<Provider>& provider;                   ///< Pointer to Web3::defaultProvider.
 
   public:
@@ -37,11 +40,13 @@ class Account {
      * @param __privateKey Full private key for the account.
      * @param __isLedger Flag to set whether the account comes from a Ledger device or not.
      * @param *_provider Pointer to the provider used by the account.
+     * @param nonce (optional) The account's nonce, if known. Otherwise it's
+     *              requested the first time nonce() is called. Makes no requests.
      */
     Account(
       const std::string& __address, const std::string& __name,
       const std::string& __privateKey, const std::unique_ptr<Provider>& __provider,
-      uint64_t nonce = 0
+      std::optional<uint64_t> nonce = std::nullopt
     );
 
     /// Copy constructor.
@@ -49,7 +54,7 @@ class Account {
       _address(other._address),
       _name(other._name),
       _privateKey(other._privateKey),
-      _nonce(other._nonce),
+      _nonce(other.knownNonce()),
       provider(other.provider)
     {}
 
@@ -58,14 +63,26 @@ class Account {
       _address(other->_address),
       _name(other->_name),
       _privateKey(other->_privateKey),
-      _nonce(other->_nonce),
+      _nonce(other->knownNonce()),
       provider(other->provider)
     {}
 
     const std::string& address()        const { return _address; }           ///< Getter for the address.
     const std::string& name()           const { return _name; }              ///< Getter for the custom name/label.
     const std::string& privateKey()     const { return _privateKey; }       ///< Getter for the private key..
-    const uint64_t& nonce()             const { return _nonce; }             ///< Getter for the nonce.
+
+    /**
+     * Get the nonce, requesting it (at `latest`) the first time if it
+     * wasn't given. Blocks during that request.
+     * @return The nonce, or 0 if it couldn't be requested.
+     */
+    uint64_t nonce() const;
+
+    /// Get the nonce only if it's already known, without any request.
+    std::optional<uint64_t> knownNonce() const;
+
+    /// Set the nonce, e.g. after loading it in bulk or sending a transaction.
+    void setNonce(uint64_t nonce);
 
     /**
      * Request the account's balance from the network.
@@ -1,6 +1,8 @@
 #ifndef BIP3X_H
 #define BIP3X_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include <bip3x/bip39.h>
@@ -40,15 +42,63 @@ namespace BIP39 {
   bool wordExists(std::string word);
 
   /**
-   * Generate a list with 10 addresses based on a given seed and a starting index.
+   * Generate a list of addresses based on a given seed and a starting index.
    * @param &phrase The full BIP39 mnemonic phrase string.
    * @param derivPath The derivation path **without** the last digit (e.g. "m/44'/60'/0'/0/").
    * @param start The derivation index to start counting from (e.g. "10" will count from indexes 10-19).
+   * @param count (optional) How many addresses to generate. Defaults to 10.
    * @return A vector of pairs of generated addresses and their respective full derivation paths.
    */
   std::vector<std::pair<std::string,std::string>> generateAccountsFromSeed(
-    std::string &phrase, std::string derivPath, int64_t start
+    std::string &phrase, std::string derivPath, int64_t start, int64_t count = 10
   );
+
+  /// An account derived by AccountDeriver.
+  struct DerivedAccount {
+    uint32_t index = 0;   ///< The last index of the derivation path.
+    std::string address;  ///< The address, "0x"-prefixed and lowercase.
+    dev::Secret secret;   ///< The private key.
+  };
+
+  /**
+   * Derives many accounts under one parent path.
+   * The BIP39 seed (2048 rounds of PBKDF2) and the parent extended key are
+   * computed once on construction, so each account only costs its last
+   * derivation step and its address, instead of the whole path from the
+   * mnemonic like createKey().
+   */
+  class AccountDeriver {
+    private:
+      bip3x::HDKey _parent;   ///< The extended key at the parent path.
+      std::string _path;      ///< The parent path, without a trailing "/".
+
+    public:
+      /**
+       * Constructor.
+       * @param phrase The full BIP39 mnemonic phrase string.
+       * @param derivPath (optional) The parent derivation path, with or without
+       *                  a trailing "/". Defaults to "m/44'/60'/0'/0".
+       */
+      AccountDeriver(const std::string& phrase, std::string derivPath = "m/44'/60'/0'/0");
+
+      const std::string& path() const { return this->_path; } ///< Getter for the parent path.
+
+      /**
+       * Derive one account.
+       * @param index The index under the parent path (non-hardened).
+       * @return The derived account.
+       */
+      DerivedAccount derive(uint32_t index) const;
+
+      /**
+       * Derive a range of accounts in parallel.
+       * @param start The index to start from.
+       * @param count How many accounts to derive.
+       * @param threads (optional) Number of threads, or 0 for one per core. Defaults to 0.
+       * @return The derived accounts, for indexes `start` to `start + count - 1` in order.
+       */
+      std::vector<DerivedAccount> derive(uint32_t start, uint32_t count, unsigned int threads = 0) const;
+  };
 }
 
 #endif  // BIP3X_H
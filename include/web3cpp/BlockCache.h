@@ -0,0 +1,116 @@
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/HeadTracker.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Cache for state reads (`eth_call`, `eth_getBalance`, `eth_getStorageAt`,
+ * `eth_getCode`) that only lives for one block.
+ * Reads at `latest` are pinned to the head reported by a HeadTracker, and
+ * sent to the node at that block number, so the cached result always
+ * matches its key. Everything is dropped as soon as a new head (or a
+ * reorg) comes in, so nothing is ever served across blocks.
+ */
+
+class BlockCache {
+  public:
+    /// Options for the cache.
+    class Options {
+      public:
+        std::size_t maxEntries = 100000; ///< Maximum number of results kept per block. Defaults to 100000.
+    };
+
+    /// Cache statistics.
+    struct Stats {
+      uint64_t hits = 0;        ///< Lookups that found a value.
+      uint64_t misses = 0;      ///< Lookups that didn't.
+      uint64_t clears = 0;      ///< Times the cache was dropped for a new head.
+      std::size_t entries = 0;  ///< Entries currently stored.
+    };
+
+    /// A block resolved for caching.
+    struct Pin {
+      BlockTag block;   ///< The block to send the request at, and to key it with.
+      uint64_t epoch;   ///< The head the pin was made at. Results from older heads aren't stored.
+    };
+
+  private:
+    HeadTracker& _heads;                            ///< The tracker for new heads.
+    Options _options;                               ///< The cache options.
+    mutable std::mutex _lock;                       ///< Mutex for everything below.
+    std::unordered_map<std::string, json> _entries; ///< Results for the current head, by key.
+    Stats _stats;                                   ///< Cache statistics.
+    std::optional<uint64_t> _head;                  ///< The current head number, once known.
+    uint64_t _epoch = 0;                            ///< Incremented with each head.
+    uint64_t _listenerId = 0;                       ///< Id of the head listener, or 0 if not listening yet.
+
+    /// Subscribe to the head tracker, if not done yet.
+    void _listen();
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param heads The head tracker. Must outlive the cache.
+     */
+    BlockCache(HeadTracker& heads);
+
+    /**
+     * Constructor.
+     * @param heads The head tracker. Must outlive the cache.
+     * @param options The cache options.
+     */
+    BlockCache(HeadTracker& heads, Options options);
+
+    /// Destructor. Stops listening to the head tracker.
+    ~BlockCache();
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Resolve a block for caching. The head tracker is subscribed to (and
+     * started) on the first call.
+     * @param block The requested block.
+     * @return `latest` pinned to the current head number, numbers and hashes
+     *         as they are, or an empty optional if the block can't be cached
+     *         (other named tags, or no head known yet).
+     */
+    std::optional<Pin> pin(const BlockTag& block);
+
+    /**
+     * Look up a result.
+     * @param key The key, built with the pinned block.
+     * @return The result, or an empty optional if it isn't cached.
+     */
+    std::optional<json> get(const std::string& key);
+
+    /**
+     * Store a result. Ignored if a new head came in since the pin was made.
+     * @param key The key, built with the pinned block.
+     * @param value The result.
+     * @param pin The pin the request was made with.
+     */
+    void put(const std::string& key, json value, const Pin& pin);
+
+    /// Drop every entry.
+    void clear();
+
+    /// Get the cache statistics.
+    Stats stats() const;
+};
+
+#endif  // BLOCKCACHE_H
@@ -0,0 +1,131 @@
+#ifndef BLOCKFETCHER_H
+#define BLOCKFETCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BoundedQueue.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Fetcher for a range of blocks, delivered strictly in block order.
+ * Blocks are requested in batches (one HTTP round trip per batch) by
+ * several workers at once. Each batch goes to a reorder buffer first, and
+ * blocks leave it in order. Workers stop claiming new batches while the
+ * consumer is behind, so memory is bounded by Options::bufferSize blocks
+ * no matter how long the range is.
+ *
+ * Fetching starts as soon as the object is built. Blocks are pulled with
+ * next() or a range-for loop.
+ */
+
+class BlockFetcher {
+  public:
+    /// Options for fetching.
+    class Options {
+      public:
+        std::size_t batchSize = 20;      ///< Blocks requested per batch. Defaults to 20.
+        std::size_t parallelism = 4;     ///< Maximum number of batches in flight. Defaults to 4.
+        std::size_t bufferSize = 256;    ///< Maximum number of blocks fetched ahead of the consumer. Defaults to 256.
+        bool fullTransactions = false;   ///< If enabled, blocks contain transaction objects instead of hashes. Defaults to false.
+        bool receipts = false;           ///< If enabled, also fetches the receipts of every transaction. Defaults to false.
+        unsigned int maxRetries = 3;     ///< Retries for a batch that failed. Defaults to 3.
+    };
+
+    /// A fetched block.
+    struct Block {
+      uint64_t number = 0;  ///< The block number.
+      json block;           ///< The block object, as returned by `eth_getBlockByNumber`.
+      json receipts;        ///< Array of transaction receipts, if Options::receipts is enabled. `null` otherwise.
+    };
+
+  private:
+    struct Range;                       ///< Shared state of the fetch. Defined in the source file.
+    std::unique_ptr<Range> _range;      ///< The fetch state.
+    BoundedQueue<Block> _queue;         ///< Blocks ready for the consumer, in order.
+    json _response;                     ///< Final result. Only set once fetching is done.
+    std::thread _fetcher;               ///< Background thread that coordinates the workers.
+
+    /// Fetch and order the range. Runs on _fetcher.
+    void _run(const std::unique_ptr<Provider>& provider);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     * @param fromBlock The first block of the range.
+     * @param toBlock The last block of the range.
+     */
+    BlockFetcher(const std::unique_ptr<Provider>& provider, uint64_t fromBlock, uint64_t toBlock);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param fromBlock The first block of the range.
+     * @param toBlock The last block of the range.
+     * @param options The fetch options.
+     */
+    BlockFetcher(
+      const std::unique_ptr<Provider>& provider, uint64_t fromBlock, uint64_t toBlock,
+      Options options
+    );
+
+    /// Destructor. Stops fetching if the range wasn't fully consumed.
+    ~BlockFetcher();
+
+    BlockFetcher(const BlockFetcher&) = delete;
+    BlockFetcher& operator=(const BlockFetcher&) = delete;
+
+    /**
+     * Get the next block, blocking until it arrives.
+     * @param out The next block.
+     * @return `true` if a block was read, `false` if there are no more blocks.
+     */
+    bool next(Block& out);
+
+    /**
+     * Get the final result: `{"result": <number of blocks fetched>}`, or the
+     * `error` object of the batch that failed, plus its block range.
+     * Blocks until fetching is done, so call it after next() returns `false`
+     * unless the remaining blocks should be discarded.
+     */
+    const json& response();
+
+    /// Single-pass iterator over the remaining blocks.
+    class iterator {
+      private:
+        BlockFetcher* _fetcher = nullptr;  ///< The fetcher, or `nullptr` for the end iterator.
+        Block _block;                      ///< The current block.
+
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Block;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Block*;
+        using reference = const Block&;
+
+        iterator() = default; ///< End iterator.
+        explicit iterator(BlockFetcher* fetcher) : _fetcher(fetcher) { ++*this; }
+
+        reference operator*() const { return _block; }
+        pointer operator->() const { return &_block; }
+        iterator& operator++() {
+          if (_fetcher && !_fetcher->next(_block)) _fetcher = nullptr;
+          return *this;
+        }
+        bool operator==(const iterator& other) const { return _fetcher == other._fetcher; }
+        bool operator!=(const iterator& other) const { return _fetcher != other._fetcher; }
+    };
+
+    iterator begin() { return iterator(this); } ///< Get an iterator to the next block.
+    iterator end() { return iterator(); }       ///< Get the end iterator.
+};
+
+#endif  // BLOCKFETCHER_H
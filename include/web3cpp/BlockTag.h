@@ -0,0 +1,138 @@
+#ifndef BLOCKTAG_H
+#define BLOCKTAG_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/devcore/FixedHash.h>
+
+using json = nlohmann::ordered_json;
+using BigNumber = dev::u256;
+
+/**
+ * A JSON-RPC quantity (an unsigned number sent as a "0x"-prefixed hex string).
+ * Holds the number itself, so it is only converted to hex once, when the
+ * request is serialized, and never validated again.
+ */
+
+class Quantity {
+  private:
+    BigNumber _value; ///< The number itself.
+
+  public:
+    /// Constructor. Defaults to zero.
+    Quantity(const BigNumber& value = 0) : _value(value) {}
+
+    /// Constructor overload for native integers.
+    Quantity(uint64_t value) : _value(value) {}
+
+    /**
+     * Parse a quantity from a hex string.
+     * @param hex The hex string, with or without the "0x" prefix.
+     * @return The parsed quantity, or an empty optional if the string is not valid hex.
+     */
+    static std::optional<Quantity> fromHex(const std::string& hex);
+
+    const BigNumber& value() const { return _value; } ///< Getter for the number.
+
+    /**
+     * Append the quantity to a string in its JSON-RPC form, without quotes.
+     * @param out The string to append to.
+     */
+    void appendHex(std::string& out) const;
+
+    /// Get the quantity in its JSON-RPC form (e.g. `"0x1b4"`, `"0x0"`).
+    std::string hex() const;
+
+    bool operator==(const Quantity& other) const { return _value == other._value; }
+    bool operator!=(const Quantity& other) const { return _value != other._value; }
+};
+
+/**
+ * A block reference, as accepted by the `defaultBlock` parameter of the
+ * JSON-RPC state methods.
+ * Can be one of the named tags (latest/pending/safe/finalized/earliest),
+ * a block number, or a block hash ([EIP-1898](https://eips.ethereum.org/EIPS/eip-1898)).
+ * Build one through the named factories (e.g. `BlockTag::latest()`,
+ * `BlockTag::number(1234)`) or, for user input, through BlockTag::parse().
+ */
+
+class BlockTag {
+  public:
+    /// Enum for the kinds of block references.
+    enum Kind { Latest, Pending, Safe, Finalized, Earliest, Number, Hash };
+
+  private:
+    Kind _kind;           ///< The kind of block reference.
+    uint64_t _number = 0; ///< The block number, if kind is Number.
+    dev::h256 _hash;      ///< The block hash, if kind is Hash.
+
+    explicit BlockTag(Kind kind) : _kind(kind) {}
+
+  public:
+    /// Default constructor. Defaults to the "latest" tag.
+    BlockTag() : _kind(Kind::Latest) {}
+
+    static BlockTag latest()    { return BlockTag(Kind::Latest); }    ///< Build a "latest" tag.
+    static BlockTag pending()   { return BlockTag(Kind::Pending); }   ///< Build a "pending" tag.
+    static BlockTag safe()      { return BlockTag(Kind::Safe); }      ///< Build a "safe" tag.
+    static BlockTag finalized() { return BlockTag(Kind::Finalized); } ///< Build a "finalized" tag.
+    static BlockTag earliest()  { return BlockTag(Kind::Earliest); }  ///< Build an "earliest" tag.
+
+    /**
+     * Build a reference to a block number.
+     * @param number The block number.
+     */
+    static BlockTag number(uint64_t number) {
+      BlockTag ret(Kind::Number); ret._number = number; return ret;
+    }
+
+    /**
+     * Build a reference to a block hash.
+     * @param hash The block hash.
+     */
+    static BlockTag hash(const dev::h256& hash) {
+      BlockTag ret(Kind::Hash); ret._hash = hash; return ret;
+    }
+
+    /**
+     * Parse a block reference from a string.
+     * Accepts the named tags, a hex block number ("0x"-prefixed),
+     * a decimal block number, or a 32 bytes block hash ("0x"-prefixed).
+     * @param block The string to parse.
+     * @return The parsed block reference, or an empty optional if the string is invalid.
+     */
+    static std::optional<BlockTag> parse(const std::string& block);
+
+    Kind kind() const { return _kind; }                     ///< Getter for the kind.
+    uint64_t blockNumber() const { return _number; }        ///< Getter for the block number. Only meaningful for Number.
+    const dev::h256& blockHash() const { return _hash; }    ///< Getter for the block hash. Only meaningful for Hash.
+    bool isNamed() const { return _kind < Kind::Number; }   ///< Check if the reference is one of the named tags.
+
+    /**
+     * Append the block reference to a request, already formatted as JSON.
+     * Named tags and numbers become strings, hashes become an EIP-1898 object.
+     * @param out The string to append to.
+     */
+    void appendJSON(std::string& out) const;
+
+    /// Get the block reference as a JSON value, same format as appendJSON().
+    json toJSON() const;
+
+    /**
+     * Get the block reference as a plain string (e.g. `"latest"`, `"0x1b4"`).
+     * Hashes are returned as the "0x"-prefixed hash.
+     */
+    std::string toString() const;
+
+    bool operator==(const BlockTag& other) const {
+      return _kind == other._kind && _number == other._number && _hash == other._hash;
+    }
+    bool operator!=(const BlockTag& other) const { return !(*this == other); }
+};
+
+#endif  // BLOCKTAG_H
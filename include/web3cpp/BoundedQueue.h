@@ -0,0 +1,99 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * Fixed-capacity blocking FIFO queue, used to hand items from a network
+ * thread to a consumer without buffering an unbounded amount of them.
+ * push() blocks while the queue is full, pop() blocks while it is empty.
+ * Closing the queue wakes up everyone: pending items can still be popped,
+ * but new pushes are rejected.
+ */
+
+template <typename T> class BoundedQueue {
+  private:
+    std::deque<T> _items;             ///< The queued items.
+    std::size_t _capacity;            ///< Maximum number of queued items.
+    bool _closed = false;             ///< Whether the queue was closed.
+    mutable std::mutex _lock;         ///< Mutex for managing read/write access to the queue.
+    std::condition_variable _notFull; ///< Signaled when an item is popped or the queue is closed.
+    std::condition_variable _notEmpty; ///< Signaled when an item is pushed or the queue is closed.
+
+  public:
+    /**
+     * Constructor.
+     * @param capacity The maximum number of queued items. Zero is treated as one.
+     */
+    explicit BoundedQueue(std::size_t capacity) : _capacity((capacity) ? capacity : 1) {}
+
+    /**
+     * Push an item, blocking while the queue is full.
+     * @param item The item to push.
+     * @return `true` if the item was queued, `false` if the queue was closed.
+     */
+    bool push(T item) {
+      std::unique_lock lock(_lock);
+      _notFull.wait(lock, [&]{ return _closed || _items.size() < _capacity; });
+      if (_closed) return false;
+      _items.push_back(std::move(item));
+      lock.unlock();
+      _notEmpty.notify_one();
+      return true;
+    }
+
+    /**
+     * Pop an item, blocking while the queue is empty.
+     * @param out The popped item.
+     * @return `true` if an item was popped, `false` if the queue is closed and drained.
+     */
+    bool pop(T& out) {
+      std::unique_lock lock(_lock);
+      _notEmpty.wait(lock, [&]{ return _closed || !_items.empty(); });
+      if (_items.empty()) return false;
+      out = std::move(_items.front());
+      _items.pop_front();
+      lock.unlock();
+      _notFull.notify_one();
+      return true;
+    }
+
+    /**
+     * Pop an item only if one is queued, without blocking. Used to fill a
+     * batch with whatever else is waiting after a blocking pop().
+     * @param out The popped item.
+     * @return `true` if an item was popped, `false` if the queue is empty.
+     */
+    bool tryPop(T& out) {
+      std::unique_lock lock(_lock);
+      if (_items.empty()) return false;
+      out = std::move(_items.front());
+      _items.pop_front();
+      lock.unlock();
+      _notFull.notify_one();
+      return true;
+    }
+
+    /// Close the queue, waking up every blocked producer and consumer.
+    void close() {
+      {
+        std::scoped_lock lock(_lock);
+        _closed = true;
+      }
+      _notFull.notify_all();
+      _notEmpty.notify_all();
+    }
+
+    /// Check if the queue was closed.
+    bool closed() const { std::scoped_lock lock(_lock); return _closed; }
+
+    /// Get the number of queued items.
+    std::size_t size() const { std::scoped_lock lock(_lock); return _items.size(); }
+
+    std::size_t capacity() const { return _capacity; } ///< Getter for the capacity.
+};
+
+#endif  // BOUNDEDQUEUE_H
@@ -57,6 +57,10 @@ class Error {
      * \arg \c 36 - **Transaction Estimate Error**
      * \arg \c 37 - **Transaction Drop Error**
      * \arg \c 38 - **Invalid Reward Percentiles**
+     * \arg \c 39 - **Invalid RPC Response**
+     * \arg \c 40 - **Invalid Subscription Type**
+     * \arg \c 41 - **Nonce Sync %Error**
+     * \arg \c 42 - **Transaction Pipeline Closed**
      * \arg \c 999 - **Unknown %Error**
      */
     static const std::map<uint64_t, std::string> codeMap;
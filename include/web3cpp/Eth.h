@@ -2,12 +2,18 @@
 #define ETH_H
 
 #include <future>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include <web3cpp/BlockCache.h>
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/ImmutableCache.h>
+#include <web3cpp/LogStream.h>
 #include <web3cpp/Net.h>
 #include <web3cpp/Provider.h>
 #include <web3cpp/RPC.h>
@@ -29,6 +35,21 @@ class Eth {
     const std::unique_ptr<Provider>& provider; ///< Pointer to Web3::defaultProvider.
 
   public:
+    /// Options for bulk state reads.
+    class BulkOptions {
+      public:
+        std::size_t batchSize = 500;    ///< Maximum number of reads per JSON-RPC batch. Defaults to 500.
+        unsigned int parallelism = 4;   ///< Maximum number of batches in flight at once. Defaults to 4.
+    };
+
+    /// Result of a bulk state read.
+    struct BulkResult {
+      std::vector<BigNumber> values;  ///< One value per key, in order. 0 for failed reads.
+      std::vector<bool> ok;           ///< Whether each read succeeded.
+      std::size_t failed = 0;         ///< Number of failed reads.
+      BlockTag block;                 ///< The block every read was made at (named tags are resolved to a number).
+    };
+
     /**
      * Constructor.
      * @param _provider Pointer to the provider that will be used.
@@ -47,10 +68,32 @@ class Eth {
     /**
      * Default block used for certain methods, if no block is specified
      * when calling those methods.
-     * Can be set to **"latest"**, **"earliest"**, **"pending"**, or a number.
-     * Defaults to "latest".
+     * Can be set to any BlockTag (a named tag, a number or a hash).
+     * Defaults to BlockTag::latest().
+     */
+    BlockTag defaultBlock = BlockTag::latest();
+
+    /**
+     * Cache for data that doesn't change once mined, used by getCode(),
+     * getBlock(), getTransaction() and getTransactionReceipt().
+     * Blocks by hash and code at a block hash are always cached. Data
+     * looked up by block number, transactions and receipts are only cached
+     * once the cache follows a HeadTracker (see ImmutableCache::track()),
+     * so entries from orphaned blocks can be dropped. That is opt-in, since
+     * the tracker then polls the node on a thread of its own, e.g.
+     * `web3.eth.cache->track(web3.heads)`.
+     * Can be shared between instances, or set to `nullptr` to disable caching.
+     */
+    std::shared_ptr<ImmutableCache> cache = std::make_shared<ImmutableCache>();
+
+    /**
+     * Optional cache for state reads within the current block, used by
+     * call(), getBalance(), getStorageAt() and getCode() at `latest`, a
+     * block number or a block hash. Reads at `latest` are pinned to the
+     * cache's current head. Disabled (`nullptr`) by default, e.g.
+     * `web3.eth.blockCache = std::make_shared<BlockCache>(web3.heads)`.
      */
-    std::string defaultBlock = "latest";
+    std::shared_ptr<BlockCache> blockCache;
 
     /**
      * Get the protocol version of the node.
@@ -111,6 +154,26 @@ class Eth {
       const std::string& address, const std::string& defaultBlock = ""
     );
 
+    /// Overload of getBalance() that takes a BlockTag as the block.
+    std::future<json> getBalance(const std::string& address, const BlockTag& defaultBlock);
+
+    /**
+     * Get the balances of many addresses at the same block.
+     * Reads are sent as JSON-RPC batches of BulkOptions::batchSize, with up
+     * to BulkOptions::parallelism batches in flight. Named tags (except
+     * `pending` and `earliest`) are resolved to a block number first, so
+     * every batch reads the same block.
+     * @param addresses The addresses.
+     * @param defaultBlock The block to use as reference.
+     * @return The balances in Wei, in the same order as the addresses.
+     */
+    std::future<BulkResult> getBalance(const std::vector<std::string>& addresses, const BlockTag& defaultBlock);
+
+    /// Overload of getBalance() for many addresses, with custom batching options.
+    std::future<BulkResult> getBalance(
+      const std::vector<std::string>& addresses, const BlockTag& defaultBlock, BulkOptions options
+    );
+
     /**
      * Get the value in storage at a specific position of an address.
      * @param address The address to get the storage from.
@@ -130,6 +193,28 @@ class Eth {
       const std::string& address, const BigNumber& position, const std::string& defaultBlock = ""
     );
 
+    /// Overload of getStorageAt() that takes a Quantity as the position and a BlockTag as the block.
+    std::future<json> getStorageAt(
+      const std::string& address, const Quantity& position, const BlockTag& defaultBlock
+    );
+
+    /**
+     * Get many storage values at the same block. Batched like the bulk
+     * overload of getBalance().
+     * @param slots The (address, position) pairs.
+     * @param defaultBlock The block to use as reference.
+     * @return The storage values, in the same order as the slots.
+     */
+    std::future<BulkResult> getStorageAt(
+      const std::vector<std::pair<std::string, Quantity>>& slots, const BlockTag& defaultBlock
+    );
+
+    /// Overload of getStorageAt() for many slots, with custom batching options.
+    std::future<BulkResult> getStorageAt(
+      const std::vector<std::pair<std::string, Quantity>>& slots, const BlockTag& defaultBlock,
+      BulkOptions options
+    );
+
     /**
      * Get the code at a specific address.
      * @param address The address to get the code from.
@@ -138,6 +223,9 @@ class Eth {
      */
     std::future<json> getCode(const std::string& address, const std::string& defaultBlock = "");
 
+    /// Overload of getCode() that takes a BlockTag as the block.
+    std::future<json> getCode(const std::string& address, const BlockTag& defaultBlock);
+
     /**
      * Get a block matching the given block number or hash.
      * @param blockHashOrBlockNumber The block number in hex, or the block hash.
@@ -154,6 +242,13 @@ class Eth {
       bool returnTransactionObjects = false
     );
 
+    /**
+     * Overload of getBlock() that takes a BlockTag.
+     * Hashes are fetched with `eth_getBlockByHash`, everything else with
+     * `eth_getBlockByNumber`, so there is no need for an `isHash` flag.
+     */
+    std::future<json> getBlock(const BlockTag& block, bool returnTransactionObjects = false);
+
     /**
      * Get the number of transactions in a given block.
      * @param blockHashOrBlockNumber The block number in hex, or the block hash.
@@ -230,6 +325,25 @@ class Eth {
       const std::string& address, std::string defaultBlock = ""
     );
 
+    /// Overload of getTransactionCount() that takes a BlockTag as the block.
+    std::future<json> getTransactionCount(const std::string& address, const BlockTag& defaultBlock);
+
+    /**
+     * Get the transaction counts of many addresses at the same block.
+     * Batched like the bulk overload of getBalance().
+     * @param addresses The addresses.
+     * @param defaultBlock The block to use as reference.
+     * @return The transaction counts, in the same order as the addresses.
+     */
+    std::future<BulkResult> getTransactionCount(
+      const std::vector<std::string>& addresses, const BlockTag& defaultBlock
+    );
+
+    /// Overload of getTransactionCount() for many addresses, with custom batching options.
+    std::future<BulkResult> getTransactionCount(
+      const std::vector<std::string>& addresses, const BlockTag& defaultBlock, BulkOptions options
+    );
+
     /**
      * Get the transaction fee history.
      * @param blockCount Requested range of blocks.
@@ -242,6 +356,12 @@ class Eth {
         const std::vector<uint64_t>& rewardPercentiles = { 10, 50, 90}
     );
 
+    /// Overload of feeHistory() that takes a BlockTag as the block.
+    std::future<json> feeHistory(
+        uint64_t blockCount, const BlockTag& defaultBlock,
+        const std::vector<uint64_t>& rewardPercentiles = { 10, 50, 90}
+    );
+
     /**
      * Get the maxPriorityFeePerGas.
      * @return The current maxPriorityFeePerGase in wei.
@@ -296,6 +416,9 @@ class Eth {
      */
     std::future<json> call(const json& callObject,const std::string& defaultBlock = "");
 
+    /// Overload of call() that takes a BlockTag as the block.
+    std::future<json> call(const json& callObject, const BlockTag& defaultBlock);
+
     /**
      * Execute a message call or transaction and return the amount of gas used.
      * @param callObject A transaction object. The `from` address MUST be
@@ -311,6 +434,27 @@ class Eth {
      */
     std::future<json> getPastLogs(const json& options);
 
+    /**
+     * Get past logs matching the given options, one at a time, as the
+     * response arrives. Memory use does not depend on the number of logs.
+     * @param options The filter options.
+     * @param onLog Function that receives each decoded log, called from the
+     *              future's thread. Return `false` to stop early.
+     * @return The response without the logs (see LogStream::parse()).
+     */
+    std::future<json> streamPastLogs(const json& options, LogStream::Callback onLog);
+
+    /**
+     * Open a pull stream over past logs matching the given options.
+     * The request is sent right away and read in the background.
+     * @param options The filter options.
+     * @param capacity (optional) Maximum number of logs buffered ahead of
+     *                 the consumer. Defaults to 1024.
+     * @return The log stream. Invalid options give an empty stream whose
+     *         response() holds the error.
+     */
+    std::unique_ptr<LogStream> openPastLogs(const json& options, std::size_t capacity = 1024);
+
     /**
      * Get work for miners to mine on.
      * @return The mining work as an array with the following structure:
@@ -0,0 +1,114 @@
+#ifndef FEEORACLE_H
+#define FEEORACLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/HeadTracker.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Shared source of EIP-1559 fee estimates.
+ * Keeps the next block's base fee and a rolling window of priority fee
+ * percentiles (10th, 50th and 90th, one per `dev::eth::FeeLevel`), with
+ * running sums so estimates are O(1). The window is seeded with a
+ * single `eth_feeHistory` call, then moved one block per new head reported
+ * by a HeadTracker, so estimating fees for any number of transactions costs
+ * no extra requests. Reorgs and gaps reseed the window.
+ */
+
+class FeeOracle {
+  public:
+    /// Options for the oracle.
+    class Options {
+      public:
+        std::size_t window = 5; ///< Number of blocks the priority fees are averaged over. Defaults to 5.
+    };
+
+    /// A fee estimate.
+    struct Fees {
+      uint64_t block = 0;                     ///< The latest block in the window.
+      dev::u256 baseFee;                      ///< Base fee of the next block.
+      std::array<dev::u256, 3> priorityFee;   ///< Average priority fee over the window, indexed by `dev::eth::FeeLevel`.
+
+      /// Get the priority fee for a level.
+      const dev::u256& priority(dev::eth::FeeLevel level) const { return this->priorityFee[level]; }
+    };
+
+  private:
+    /// Fee data of a block.
+    struct Sample {
+      uint64_t number;                        ///< The block number.
+      std::array<dev::u256, 3> reward;        ///< Priority fee percentiles of the block.
+    };
+
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    HeadTracker& _heads;                        ///< The tracker for new heads.
+    Options _options;                           ///< The oracle options.
+
+    std::mutex _seedLock;                       ///< Held while seeding, so concurrent first calls wait for it.
+    std::mutex _lock;                           ///< Mutex for everything below.
+    std::deque<Sample> _samples;                ///< The window, oldest first.
+    std::array<dev::u256, 3> _sums;             ///< Sum of the window's rewards, per level.
+    dev::u256 _nextBaseFee;                     ///< Base fee of the block after the window.
+    uint64_t _listenerId = 0;                   ///< Id of the head listener, or 0 if not listening yet.
+
+    /**
+     * Fetch fee history and add it to the window.
+     * @param blocks The number of blocks to fetch.
+     * @param newest The newest block to fetch, or an empty optional for `latest`.
+     * @param reset If enabled, replace the window instead of extending it.
+     * @return `true` on success, `false` otherwise.
+     */
+    bool _fetch(uint64_t blocks, std::optional<uint64_t> newest, bool reset);
+
+    /// Take a new head.
+    void _onHead(const HeadTracker::Event& event);
+
+    /// Get the current estimate. Must be called with _lock held.
+    std::optional<Fees> _fees() const;
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker. Must outlive the oracle.
+     */
+    FeeOracle(const std::unique_ptr<Provider>& provider, HeadTracker& heads);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker. Must outlive the oracle.
+     * @param options The oracle options.
+     */
+    FeeOracle(const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options);
+
+    /// Destructor. Stops listening to the head tracker.
+    ~FeeOracle();
+
+    FeeOracle(const FeeOracle&) = delete;
+    FeeOracle& operator=(const FeeOracle&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Get the current fee estimate. The first call seeds the window and
+     * starts following the head tracker; later calls make no requests.
+     * @return The estimate, or an empty optional if the fee history couldn't be fetched.
+     */
+    std::optional<Fees> fees();
+};
+
+#endif  // FEEORACLE_H
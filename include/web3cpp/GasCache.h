@@ -0,0 +1,108 @@
+#ifndef GASCACHE_H
+#define GASCACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Common.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Cache for `eth_estimateGas` results, keyed by the shape of the call
+ * instead of the exact transaction: the target, the 4-byte selector,
+ * whether it sends value and, optionally, a hash of the whole calldata and
+ * a sender class. Repeated calls of the same kind (e.g. token transfers
+ * to the same contract) reuse one estimate until it expires.
+ * Estimates can be re-validated by sampling: every Nth hit of an entry is
+ * reported as a miss so the caller estimates again and refreshes it.
+ * Contract creations are never cached.
+ */
+
+class GasCache {
+  public:
+    /// Options for the cache.
+    class Options {
+      public:
+        std::chrono::milliseconds ttl{60000};  ///< How long an estimate is used for. Defaults to 60s.
+        bool keyByCalldata = false;            ///< If enabled, calls with different arguments get different entries. Defaults to false.
+        unsigned int revalidateEvery = 0;      ///< Re-estimate on every Nth hit of an entry, or 0 to never. Defaults to 0.
+        std::size_t maxEntries = 10000;        ///< Maximum number of entries. Defaults to 10000.
+        /// Optional sender class for a transaction object (e.g. "contract" or
+        /// "eoa"), for calls whose gas depends on the sender. Defaults to
+        /// none (every sender shares the same entries).
+        std::function<std::string(const json&)> senderClass;
+    };
+
+    /// Cache statistics.
+    struct Stats {
+      uint64_t hits = 0;           ///< Lookups that found a live estimate.
+      uint64_t misses = 0;         ///< Lookups that didn't (missing or expired).
+      uint64_t revalidations = 0;  ///< Hits turned into misses by sampling.
+      std::size_t entries = 0;     ///< Entries currently stored.
+    };
+
+  private:
+    /// A cached estimate.
+    struct Entry {
+      dev::u256 gas;                                   ///< The estimate.
+      std::chrono::steady_clock::time_point expires;   ///< When the estimate stops being used.
+      unsigned int hits = 0;                           ///< Hits since it was stored.
+    };
+
+    Options _options;                                  ///< The cache options.
+    std::mutex _lock;                                  ///< Mutex for everything below.
+    std::unordered_map<std::string, Entry> _entries;   ///< Estimates, by key.
+    Stats _stats;                                      ///< Cache statistics.
+
+  public:
+    /// Constructor. Uses the default options.
+    GasCache();
+
+    /**
+     * Constructor.
+     * @param options The cache options.
+     */
+    GasCache(Options options);
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Build the key for a transaction object.
+     * @param txObj The transaction object, as sent to `eth_estimateGas`.
+     * @return The key, or an empty string if the transaction can't be cached
+     *         (e.g. a contract creation).
+     */
+    std::string key(const json& txObj) const;
+
+    /**
+     * Look up an estimate.
+     * @param key The key from key().
+     * @return The estimate, or an empty optional if it's missing, expired or
+     *         due for re-validation.
+     */
+    std::optional<dev::u256> get(const std::string& key);
+
+    /**
+     * Store an estimate, replacing any previous one.
+     * @param key The key from key().
+     * @param gas The estimate.
+     */
+    void put(const std::string& key, const dev::u256& gas);
+
+    /// Drop every entry.
+    void clear();
+
+    /// Get the cache statistics.
+    Stats stats();
+};
+
+#endif  // GASCACHE_H
@@ -0,0 +1,194 @@
+#ifndef HEADTRACKER_H
+#define HEADTRACKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Shared follower of the chain head.
+ * A single background thread follows the head and every listener gets the
+ * same view of it, instead of each component polling the node on its own.
+ * The head is followed with the first backend that works, in this order:
+ * - an `eth_subscribe` `newHeads` subscription over a WebSocket
+ * - an `eth_newBlockFilter` filter, polled with `eth_getFilterChanges`
+ * - plain polling of the latest block
+ *
+ * The most recent headers are kept in a ring buffer. A new header whose
+ * parent hash doesn't match the stored header below it is a reorg: the
+ * tracker walks the new branch back to the common ancestor, drops the
+ * orphaned headers and reports them along with the new ones.
+ */
+
+class HeadTracker {
+  public:
+    /// Options for tracking.
+    class Options {
+      public:
+        bool subscribe = true;                           ///< If enabled, tries a WebSocket subscription first. Defaults to true.
+        uint64_t wsPort = 0;                             ///< WebSocket port, or 0 to use the provider's port. Defaults to 0.
+        std::chrono::milliseconds pollInterval{1000};    ///< Time between polls for the filter and polling backends. Defaults to 1s.
+        std::size_t historySize = 64;                    ///< Number of recent headers kept. Also the deepest reorg that can be followed. Defaults to 64.
+    };
+
+    /// The ways the head can be followed.
+    enum class Backend { None, Subscription, Filter, Polling };
+
+    /// A block header.
+    struct Header {
+      uint64_t number = 0;      ///< The block number.
+      std::string hash;         ///< The block hash.
+      std::string parentHash;   ///< The hash of the parent block.
+      json header;              ///< The full header, as sent by the node.
+
+      /**
+       * Build a header from a block or `newHeads` JSON object.
+       * @param block The JSON object.
+       * @return The header, or an empty optional if a required field is missing.
+       */
+      static std::optional<Header> fromJSON(const json& block);
+    };
+
+    /// A change of the chain head, sent to every listener.
+    struct Event {
+      Header head;                  ///< The new head.
+      std::vector<Header> removed;  ///< Headers dropped by a reorg, newest first. Empty if there was no reorg.
+      bool isReorg() const { return !this->removed.empty(); } ///< Whether the new head came with a reorg.
+    };
+
+    /// Function that receives head changes. Always called from the tracker thread, in order.
+    using Listener = std::function<void(const Event&)>;
+
+  private:
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    Options _options;                           ///< The tracking options.
+
+    mutable std::mutex _lock;                   ///< Mutex for the headers and the backend.
+    std::vector<Header> _ring;                  ///< Ring buffer with the most recent headers.
+    std::size_t _ringFirst = 0;                 ///< Index of the oldest header in _ring.
+    std::size_t _ringCount = 0;                 ///< Number of headers in _ring.
+    Backend _backend = Backend::None;           ///< The backend in use.
+
+    std::mutex _listenersLock;                  ///< Mutex for the listeners.
+    std::recursive_mutex _dispatchLock;         ///< Held while listeners are being called.
+    std::map<uint64_t, Listener> _listeners;    ///< Listeners, by id.
+    uint64_t _nextListenerId = 1;               ///< Id for the next listener.
+
+    mutable std::mutex _runLock;                ///< Mutex for starting and stopping.
+    std::condition_variable _wake;              ///< Wakes the tracker thread up when stopping.
+    std::atomic<bool> _stop = false;            ///< Tells the tracker thread to stop.
+    std::thread _tracker;                       ///< The tracker thread.
+
+    /// Follow the head until stopped. Runs on _tracker.
+    void _run();
+
+    /// Follow the head with each backend. Return `false` if it isn't supported.
+    bool _runSubscription();
+    bool _runFilter();
+    void _runPolling();
+
+    /// Sleep for the poll interval. Returns `false` if stopped meanwhile.
+    bool _sleep();
+
+    /// Send a request and return the parsed response. Throws std::runtime_error on network errors.
+    json _request(const json& request);
+
+    /// Fetch the latest header and take it in.
+    void _fetchLatest();
+
+    /// Take a new header into the ring, following reorgs and filling gaps, and notify listeners.
+    void _onHeader(Header header);
+
+    /// Ring buffer helpers. Must be called with _lock held.
+    const Header& _ringAt(std::size_t i) const;  ///< Header at position `i`, 0 being the oldest.
+    void _ringPush(Header header);               ///< Append a header, overwriting the oldest when full.
+    void _ringPop();                             ///< Remove the newest header.
+    std::optional<Header> _ringFind(uint64_t number) const; ///< Find a header by number.
+
+    /// Send an event to every listener.
+    void _notify(const Event& event);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to follow.
+     */
+    HeadTracker(const std::unique_ptr<Provider>& provider);
+
+    /**
+     * Constructor.
+     * @param provider The provider to follow.
+     * @param options The tracking options.
+     */
+    HeadTracker(const std::unique_ptr<Provider>& provider, Options options);
+
+    /// Destructor. Stops tracking.
+    ~HeadTracker();
+
+    HeadTracker(const HeadTracker&) = delete;
+    HeadTracker& operator=(const HeadTracker&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Start following the head, if not already started.
+     * Listeners start it automatically, so this is only needed
+     * to use head() and history() without any listener.
+     */
+    void start();
+
+    /// Stop following the head. Listeners are kept, and start() resumes.
+    void stop();
+
+    /// Check whether the head is being followed.
+    bool running() const;
+
+    /// Get the backend in use, or Backend::None if not started yet.
+    Backend backend() const;
+
+    /**
+     * Add a listener, starting the tracker if needed.
+     * @param listener The function that will receive head changes.
+     * @return The listener id, used to remove it.
+     */
+    uint64_t subscribe(Listener listener);
+
+    /**
+     * Remove a listener. Once this returns the listener won't be called
+     * again, so whatever it refers to can be safely destroyed.
+     * @param id The id returned by subscribe().
+     * @return `true` if the listener was removed, `false` if it didn't exist.
+     */
+    bool unsubscribe(uint64_t id);
+
+    /// Get the current head, or an empty optional if none was seen yet.
+    std::optional<Header> head() const;
+
+    /**
+     * Get a recent header by number.
+     * @param number The block number.
+     * @return The header, or an empty optional if it isn't in the history.
+     */
+    std::optional<Header> header(uint64_t number) const;
+
+    /// Get every header in the history, oldest first.
+    std::vector<Header> history() const;
+};
+
+#endif  // HEADTRACKER_H
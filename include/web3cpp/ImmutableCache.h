@@ -0,0 +1,158 @@
+#ifndef IMMUTABLECACHE_H
+#define IMMUTABLECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/HeadTracker.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Byte-budgeted LRU cache for data that can't change once known, like
+ * blocks by hash, or receipts and code from finalized blocks.
+ * Values are stored already parsed, so a hit costs no request and no
+ * parsing. Entries are either final (never invalidated) or tied to a
+ * recent block, in which case they are dropped if a reorg removes it.
+ *
+ * Reorgs and the current head come from a HeadTracker given to track().
+ * Until a head is known, nothing tied to a block number can be told
+ * apart from data that may still change, so only final data is cached.
+ */
+
+class ImmutableCache {
+  public:
+    /// Options for the cache.
+    class Options {
+      public:
+        std::size_t maxBytes = 64 * 1024 * 1024;  ///< Approximate memory budget for the cached values. Defaults to 64 MiB.
+        uint64_t finalityDepth = 64;              ///< Blocks on top of a block for its data to be considered final. Should not exceed the tracker's HeadTracker::Options::historySize. Defaults to 64.
+    };
+
+    /// Cache statistics.
+    struct Stats {
+      uint64_t hits = 0;          ///< Lookups that found a value.
+      uint64_t misses = 0;        ///< Lookups that didn't.
+      uint64_t evictions = 0;     ///< Entries dropped to stay within the budget.
+      uint64_t invalidations = 0; ///< Entries dropped by reorgs.
+      std::size_t entries = 0;    ///< Entries currently stored.
+      std::size_t bytes = 0;      ///< Approximate size of the stored entries.
+    };
+
+  private:
+    /// A cached value.
+    struct Entry {
+      std::string key;          ///< The key, also stored in _index.
+      json value;               ///< The cached value.
+      std::size_t bytes;        ///< Approximate size of the entry.
+      bool final;               ///< Whether the entry survives reorgs.
+      uint64_t blockNumber;     ///< The block the value belongs to, if not final.
+    };
+
+    Options _options;                                                   ///< The cache options.
+    mutable std::mutex _lock;                                           ///< Mutex for everything below.
+    std::list<Entry> _entries;                                          ///< Entries, most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index; ///< Entries by key.
+    Stats _stats;                                                       ///< Cache statistics.
+    std::optional<uint64_t> _head;                                      ///< The latest head number, once known.
+    HeadTracker* _heads = nullptr;                                      ///< The tracker for heads and reorgs, if any.
+    uint64_t _listenerId = 0;                                           ///< Id of the head listener, or 0 if not listening yet.
+
+    /// Subscribe to the head tracker, if not done yet.
+    void _listen();
+
+    /// Take a head change, dropping entries from orphaned blocks.
+    void _onHead(const HeadTracker::Event& event);
+
+    /// Drop least recently used entries until within the budget. Must be called with _lock held.
+    void _evict();
+
+  public:
+    /// Constructor. Uses the default options.
+    ImmutableCache();
+
+    /**
+     * Constructor.
+     * @param options The cache options.
+     */
+    ImmutableCache(Options options);
+
+    /// Destructor. Stops listening to the head tracker.
+    ~ImmutableCache();
+
+    ImmutableCache(const ImmutableCache&) = delete;
+    ImmutableCache& operator=(const ImmutableCache&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Follow heads and reorgs from a head tracker. The tracker is only
+     * subscribed to (and started) the first time finality is asked for.
+     * @param heads The head tracker. Must outlive the cache, or be
+     *              detached with untrack() before it is destroyed.
+     */
+    void track(HeadTracker& heads);
+
+    /// Stop following the head tracker. Entries that aren't final are dropped.
+    void untrack();
+
+    /**
+     * Build a cache key for a request.
+     * @param method The method name.
+     * @param params The request parameters. Strings are lowercased, so
+     *               hashes and addresses match in any case.
+     * @return The key.
+     */
+    static std::string key(const std::string& method, const json& params);
+
+    /**
+     * Look up a value.
+     * @param key The key.
+     * @return The value, or an empty optional if it isn't cached.
+     */
+    std::optional<json> get(const std::string& key);
+
+    /**
+     * Store a value that will never change.
+     * @param key The key.
+     * @param value The value.
+     */
+    void put(const std::string& key, json value);
+
+    /**
+     * Store a value that belongs to a given block. It's stored as final if
+     * the block is deep enough, tied to the block if it's in the head
+     * tracker's history, and not stored at all otherwise.
+     * @param key The key.
+     * @param value The value.
+     * @param blockNumber The block the value belongs to.
+     * @param blockHash (optional) The hash of the block. If given, the value
+     *                  is only tied to the block if the tracker has the same
+     *                  one, so data from an already orphaned block is skipped.
+     * @return `true` if the value was stored, `false` otherwise.
+     */
+    bool put(const std::string& key, json value, uint64_t blockNumber, const std::string& blockHash = "");
+
+    /**
+     * Check if data from a block is final.
+     * @param blockNumber The block number.
+     * @return Whether the block is at least Options::finalityDepth blocks
+     *         below the head, or an empty optional if the head isn't known yet.
+     */
+    std::optional<bool> isFinal(uint64_t blockNumber);
+
+    /// Drop every entry.
+    void clear();
+
+    /// Get the cache statistics.
+    Stats stats() const;
+};
+
+#endif  // IMMUTABLECACHE_H
@@ -0,0 +1,127 @@
+#ifndef KEYSTORE_H
+#define KEYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Error.h>
+#include <web3cpp/Signer.h>
+#include <web3cpp/devcrypto/Common.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Namespace for encrypted keystore files.
+ * Implements the [Web3 Secret Storage](https://ethereum.org/en/developers/docs/data-structures-and-encoding/web3-secret-storage/)
+ * (V3) format used by geth, Foundry and most wallets: the private key is
+ * encrypted with AES-128-CTR under a key derived from the password with
+ * scrypt or PBKDF2-HMAC-SHA256, and authenticated with a Keccak-256 MAC.
+ */
+
+namespace Keystore {
+  /// Options for encrypting a key.
+  class Options {
+    public:
+      uint64_t scryptN = 262144;  ///< scrypt CPU/memory cost, a power of two. Defaults to 2^18.
+      uint32_t scryptR = 8;       ///< scrypt block size. Defaults to 8.
+      uint32_t scryptP = 1;       ///< scrypt parallelization. Defaults to 1.
+  };
+
+  /// Options for load().
+  class LoadOptions {
+    public:
+      unsigned int threads = 0;                         ///< Number of threads, or 0 for one per core. Defaults to 0.
+      std::size_t memoryBudget = std::size_t(1) << 30; ///< Bytes the running scrypt derivations may use together. Defaults to 1 GiB.
+  };
+
+  /// A keystore file to load with load().
+  struct Entry {
+    boost::filesystem::path path; ///< The path of the keystore file.
+    std::string password;         ///< The password it was encrypted with.
+  };
+
+  /// Keys loaded by load().
+  struct LoadResult {
+    std::vector<std::optional<Signer>> signers; ///< The signer of each file, in order, or empty if it couldn't be loaded.
+    std::vector<uint64_t> errors;               ///< The Error code of each file, 0 if it was loaded.
+    std::size_t failed = 0;                     ///< Number of files that couldn't be loaded.
+    std::size_t peakDerivations = 0;            ///< Most scrypt derivations that ran at the same time.
+  };
+
+  /**
+   * Encrypt a private key.
+   * @param secret The private key.
+   * @param password The password to encrypt it with.
+   * @param error Error object. Set to "Key Derivation Failed" or
+   *              "Key Encryption Failed" on failure.
+   * @param options (optional) The scrypt parameters.
+   * @return The V3 keystore, or an empty object on failure.
+   */
+  json encrypt(
+    const dev::Secret& secret, const std::string& password,
+    Error &error, Options options = Options()
+  );
+
+  /**
+   * Decrypt a private key. Both the scrypt and PBKDF2 key derivations are supported.
+   * @param keystore The V3 keystore.
+   * @param password The password it was encrypted with.
+   * @param error Error object. Set to "Key Decryption MAC Mismatch" if the
+   *              password is wrong, "Key Derivation Failed" if the key
+   *              derivation failed, or "Key Decryption Failed" if the
+   *              keystore is malformed, unsupported or for another address.
+   * @return The private key, or an empty optional on failure.
+   */
+  std::optional<dev::Secret> decrypt(const json& keystore, const std::string& password, Error &error);
+
+  /**
+   * Get the memory a keystore's key derivation needs.
+   * @param keystore The V3 keystore.
+   * @return The bytes scrypt allocates for it, or 0 for PBKDF2 and malformed keystores.
+   */
+  std::size_t memoryCost(const json& keystore);
+
+  /**
+   * Encrypt a private key to a keystore file.
+   * @param secret The private key.
+   * @param password The password to encrypt it with.
+   * @param filePath The path of the file to write.
+   * @param error Error object. Set like encrypt(), or to "JSON File Write Error".
+   * @param options (optional) The scrypt parameters.
+   */
+  void exportFile(
+    const dev::Secret& secret, const std::string& password,
+    boost::filesystem::path filePath, Error &error, Options options = Options()
+  );
+
+  /**
+   * Decrypt a keystore file.
+   * @param filePath The path of the keystore file.
+   * @param password The password it was encrypted with.
+   * @param error Error object. Set like decrypt(), or to "JSON File Does Not Exist"
+   *              or "JSON File Read Error".
+   * @return The signer for the key, or an empty optional on failure.
+   */
+  std::optional<Signer> importFile(boost::filesystem::path filePath, const std::string& password, Error &error);
+
+  /**
+   * Decrypt many keystore files at once.
+   * Files are decrypted in parallel, but a derivation only starts once
+   * its memory (see memoryCost()) fits in LoadOptions::memoryBudget next
+   * to the ones already running, so e.g. 2^18 scrypt keystores (256 MiB
+   * each) run 4 at a time with the default budget no matter the number of
+   * cores. A derivation larger than the whole budget runs alone.
+   * @param entries The keystore files and their passwords.
+   * @param options (optional) The threading and memory options.
+   * @return The signer of each file, in the same order.
+   */
+  LoadResult load(const std::vector<Entry>& entries, LoadOptions options = LoadOptions());
+}
+
+#endif  // KEYSTORE_H
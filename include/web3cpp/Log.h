@@ -0,0 +1,45 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/devcore/FixedHash.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * A decoded event log, as returned by `eth_getLogs`, `eth_getFilterLogs`
+ * and `eth_getFilterChanges`.
+ * Fields that are `null` for pending logs (block number/hash, indexes)
+ * are left at their defaults.
+ */
+
+struct Log {
+  dev::Address address;           ///< Address of the contract that emitted the log.
+  std::vector<dev::h256> topics;  ///< Indexed topics. The first one is usually the event signature.
+  dev::bytes data;                ///< Non-indexed data.
+  uint64_t blockNumber = 0;       ///< Number of the block that included the log.
+  dev::h256 blockHash;            ///< Hash of the block that included the log.
+  dev::h256 transactionHash;      ///< Hash of the transaction that emitted the log.
+  uint64_t transactionIndex = 0;  ///< Index of the transaction in the block.
+  uint64_t logIndex = 0;          ///< Index of the log in the block.
+  bool removed = false;           ///< `true` if the log was removed by a chain reorganization.
+
+  /**
+   * Decode a log from its JSON-RPC object.
+   * @param log The log object.
+   * @return The decoded log, or an empty optional if the object is malformed.
+   */
+  static std::optional<Log> fromJSON(const json& log);
+
+  /// Encode the log back to its JSON-RPC object.
+  json toJSON() const;
+};
+
+#endif  // LOG_H
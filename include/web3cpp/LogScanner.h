@@ -0,0 +1,87 @@
+#ifndef LOGSCANNER_H
+#define LOGSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Log.h>
+#include <web3cpp/LogStream.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Scanner for historical logs over large block ranges.
+ * Nodes reject `eth_getLogs` calls that span too many blocks or match too
+ * many logs, so the range is split into chunks that are requested
+ * concurrently. The chunk size adapts as the scan goes: a chunk that is
+ * rejected for being too big is bisected (and the chunk size shrinks for the
+ * rest of the scan), and chunks that come back sparse make it grow again.
+ * Logs are always delivered in block order, from a single thread at a time.
+ */
+
+class LogScanner {
+  public:
+    /// Options for a scan.
+    class Options {
+      public:
+        uint64_t initialChunk = 2000;       ///< Blocks per request at the start of the scan. Defaults to 2000.
+        uint64_t minChunk = 1;              ///< Chunk size will never shrink below this. Defaults to 1.
+        uint64_t maxChunk = 100000;         ///< Chunk size will never grow above this. Defaults to 100000.
+        std::size_t parallelism = 4;        ///< Maximum number of concurrent requests. Defaults to 4.
+        std::size_t sparseThreshold = 1000; ///< Chunks with fewer logs than this double the chunk size. Defaults to 1000.
+        unsigned int maxRetries = 3;        ///< Retries for a chunk that failed with a network or node error. Defaults to 3.
+    };
+
+  private:
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    Options _options;                           ///< The scan options.
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     */
+    LogScanner(const std::unique_ptr<Provider>& provider);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param options The scan options.
+     */
+    LogScanner(const std::unique_ptr<Provider>& provider, Options options);
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Check if a node error means the request covered too many blocks or
+     * logs, and should be retried with a smaller range.
+     * Recognizes the messages used by geth, Erigon, Infura, Alchemy and others.
+     * @param error The `error` object of the response.
+     * @return `true` if the range should be split, `false` otherwise.
+     */
+    static bool isRangeTooLarge(const json& error);
+
+    /**
+     * Scan a block range for logs matching a filter.
+     * @param filter The filter options (`address`, `topics`). Any
+     *               `fromBlock`, `toBlock` or `blockhash` is ignored.
+     * @param fromBlock The first block of the range.
+     * @param toBlock The last block of the range.
+     * @param onLog Function that receives each log, in block order.
+     *              Return `false` to stop the scan.
+     * @return `{"result": <number of logs delivered>}`, or an `error` object
+     *         with the range that could not be fetched.
+     */
+    std::future<json> scan(
+      json filter, uint64_t fromBlock, uint64_t toBlock, LogStream::Callback onLog
+    );
+};
+
+#endif  // LOGSCANNER_H
@@ -0,0 +1,128 @@
+#ifndef LOGSTREAM_H
+#define LOGSTREAM_H
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BoundedQueue.h>
+#include <web3cpp/Log.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Incremental reader for `eth_getLogs` responses.
+ * The `result` array is parsed one element at a time as bytes arrive from
+ * the network, and each element is decoded to a Log and handed over before
+ * the next one is read. Only one log is ever held in memory, so ranges that
+ * return hundreds of thousands of logs use the same memory as a single one.
+ *
+ * Logs can be consumed either by a callback (parse(), Eth::streamPastLogs())
+ * or by pulling them from a LogStream object (next() or a range-for loop),
+ * in which case the network is read on a background thread and at most
+ * `capacity` logs are buffered ahead of the consumer.
+ */
+
+class LogStream {
+  public:
+    /**
+     * Function that receives each decoded log.
+     * Return `false` to stop reading the rest of the response.
+     */
+    using Callback = std::function<bool(const Log&)>;
+
+    /**
+     * Parse an `eth_getLogs` response from a stream, one log at a time.
+     * @param in The stream with the raw response.
+     * @param onLog Function that receives each decoded log.
+     * @return The response without the logs, i.e. `{"jsonrpc", "id", "result"}`
+     *         where `result` is the number of logs delivered, or the node's
+     *         `error` object. Malformed responses or logs return
+     *         `{"error": {"message": "..."}}`.
+     */
+    static json parse(std::istream& in, const Callback& onLog);
+
+  private:
+    BoundedQueue<Log> _queue; ///< Logs read ahead of the consumer.
+    json _response;           ///< The response without the logs. Only set once the reader is done.
+    std::thread _reader;      ///< Background thread that reads the network.
+
+  public:
+    /**
+     * Constructor. Starts reading the response in the background right away.
+     * @param provider The provider to send the request to.
+     * @param reqBody The `eth_getLogs` request, already serialized.
+     * @param capacity (optional) Maximum number of logs buffered ahead of
+     *                 the consumer. Defaults to 1024.
+     */
+    LogStream(
+      const std::unique_ptr<Provider>& provider, const std::string& reqBody,
+      std::size_t capacity = 1024
+    );
+
+    /**
+     * Constructor for a stream that is already done, with no logs.
+     * Used to report errors found before sending the request.
+     * @param response The response to report (e.g. a validation error).
+     */
+    explicit LogStream(const json& response);
+
+    /// Destructor. Stops reading the network if the stream wasn't fully consumed.
+    ~LogStream();
+
+    LogStream(const LogStream&) = delete;
+    LogStream& operator=(const LogStream&) = delete;
+
+    /**
+     * Get the next log, blocking until it arrives.
+     * @param out The next log.
+     * @return `true` if a log was read, `false` if there are no more logs.
+     */
+    bool next(Log& out);
+
+    /**
+     * Get the response without the logs, same format as parse().
+     * Blocks until the whole response was read, so call it after next()
+     * returns `false` unless the remaining logs should be discarded.
+     */
+    const json& response();
+
+    /// Single-pass iterator over the remaining logs.
+    class iterator {
+      private:
+        LogStream* _stream = nullptr; ///< The stream, or `nullptr` for the end iterator.
+        Log _log;                     ///< The current log.
+
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Log;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Log*;
+        using reference = const Log&;
+
+        iterator() = default; ///< End iterator.
+        explicit iterator(LogStream* stream) : _stream(stream) { ++*this; }
+
+        reference operator*() const { return _log; }
+        pointer operator->() const { return &_log; }
+        iterator& operator++() {
+          if (_stream && !_stream->next(_log)) _stream = nullptr;
+          return *this;
+        }
+        bool operator==(const iterator& other) const { return _stream == other._stream; }
+        bool operator!=(const iterator& other) const { return _stream != other._stream; }
+    };
+
+    iterator begin() { return iterator(this); } ///< Get an iterator to the next log.
+    iterator end() { return iterator(); }       ///< Get the end iterator.
+};
+
+#endif  // LOGSTREAM_H
@@ -0,0 +1,141 @@
+#ifndef LOGSUBSCRIPTION_H
+#define LOGSUBSCRIPTION_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Error.h>
+#include <web3cpp/HeadTracker.h>
+#include <web3cpp/Log.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/ethcore/Common.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Live feed of the logs matching a filter, following the chain head
+ * through a HeadTracker.
+ * Every new block's `logsBloom` is tested against the filter first, and
+ * `eth_getLogs` is only called (by block hash) for blocks that may have
+ * matching logs. Blooms have no false negatives, so nothing is missed, and
+ * filters for contracts that rarely emit events skip most blocks without
+ * a request.
+ * Logs of blocks dropped by a reorg are sent again with `removed` set,
+ * newest first, before the logs of the new branch.
+ */
+
+class LogSubscription {
+  public:
+    /// Options for the subscription.
+    class Options {
+      public:
+        bool useBloom = true;             ///< If enabled, skips blocks whose bloom can't match the filter. Defaults to true.
+        unsigned int maxRetries = 3;      ///< Retries for a block whose logs failed to be fetched. Defaults to 3.
+    };
+
+    /// Subscription statistics.
+    struct Stats {
+      uint64_t blocks = 0;    ///< New blocks seen.
+      uint64_t skipped = 0;   ///< Blocks skipped because their bloom can't match.
+      uint64_t requests = 0;  ///< `eth_getLogs` requests made.
+      uint64_t logs = 0;      ///< Logs delivered.
+      uint64_t removed = 0;   ///< Logs delivered again as removed.
+      uint64_t failed = 0;    ///< Blocks whose logs couldn't be fetched.
+    };
+
+    /// Function that receives each log, or its removal. Always called from the tracker thread, in order.
+    using Callback = std::function<void(const Log&)>;
+
+  private:
+    const std::unique_ptr<Provider>& _provider;   ///< Pointer to the provider used for the requests.
+    HeadTracker& _heads;                          ///< The tracker for new heads.
+    json _filter;                                 ///< The filter (`address` and `topics` only).
+    Callback _onLog;                              ///< The function that receives the logs.
+    Options _options;                             ///< The subscription options.
+
+    /// Bloom bits of each filter address. Empty if any address matches.
+    std::vector<dev::eth::LogBloom> _addressBits;
+    /// Bloom bits of each topic option, per position. Empty positions match anything.
+    std::vector<std::vector<dev::eth::LogBloom>> _topicBits;
+
+    mutable std::mutex _lock;                     ///< Mutex for _listenerId and _stats.
+    uint64_t _listenerId = 0;                     ///< Id of the head listener, or 0 if not started.
+    Stats _stats;                                 ///< Subscription statistics.
+
+    /// Logs delivered for recent blocks, by block hash, oldest first. Only touched by the tracker thread.
+    std::deque<std::pair<std::string, std::vector<Log>>> _delivered;
+
+    /// Take a new head.
+    void _onHead(const HeadTracker::Event& event);
+
+    /// Fetch the logs of a block. Returns `false` if they couldn't be fetched.
+    bool _fetch(const std::string& blockHash, std::vector<Log>& logs);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker. Must outlive the subscription.
+     * @param filter The filter options (`address`, `topics`). Any
+     *               `fromBlock`, `toBlock` or `blockHash` is ignored.
+     * @param onLog Function that receives each log.
+     */
+    LogSubscription(
+      const std::unique_ptr<Provider>& provider, HeadTracker& heads,
+      json filter, Callback onLog
+    );
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker. Must outlive the subscription.
+     * @param filter The filter options (`address`, `topics`). Any
+     *               `fromBlock`, `toBlock` or `blockHash` is ignored.
+     * @param onLog Function that receives each log.
+     * @param options The subscription options.
+     */
+    LogSubscription(
+      const std::unique_ptr<Provider>& provider, HeadTracker& heads,
+      json filter, Callback onLog, Options options
+    );
+
+    /// Destructor. Stops the subscription.
+    ~LogSubscription();
+
+    LogSubscription(const LogSubscription&) = delete;
+    LogSubscription& operator=(const LogSubscription&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Start delivering logs from the next new block on, if not already started.
+     * @param &err Error object. Set if the filter is invalid.
+     */
+    void start(Error &err);
+
+    /// Stop delivering logs. Once this returns the callback won't be called again.
+    void stop();
+
+    /// Check whether the subscription is running.
+    bool running() const;
+
+    /**
+     * Check if a block may have logs matching the filter.
+     * @param bloom The block's `logsBloom`.
+     * @return `true` if it may, `false` if it definitely doesn't.
+     */
+    bool mayMatch(const dev::eth::LogBloom& bloom) const;
+
+    /// Get the subscription statistics.
+    Stats stats() const;
+};
+
+#endif  // LOGSUBSCRIPTION_H
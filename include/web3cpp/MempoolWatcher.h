@@ -0,0 +1,181 @@
+#ifndef MEMPOOLWATCHER_H
+#define MEMPOOLWATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/MpmcQueue.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Stream of pending transactions from the node's mempool.
+ * Pending transaction hashes are followed with the first backend that works:
+ * - an `eth_subscribe` `newPendingTransactions` subscription over a WebSocket
+ * - an `eth_newPendingTransactionFilter` filter, polled with `eth_getFilterChanges`
+ *
+ * New hashes are handed to a fixed pool of fetch threads, so at most
+ * `maxInFlight` batch requests are in flight at once. Each thread takes
+ * whatever hashes are waiting (up to `batchSize`) as soon as it's free
+ * instead of waiting for a batch to fill, fetches them with
+ * `eth_getRawTransactionByHash` and decodes the raw bytes with the RLP
+ * constructor of `dev::eth::TransactionBase`. Nodes without the raw method
+ * get `eth_getTransactionByHash` instead, and only the JSON object is delivered.
+ * Results go to a lock-free queue, so consumers can spin on tryPop()
+ * without ever waiting on a lock held by the network threads. When the
+ * queue is full, new transactions are dropped and counted.
+ */
+
+class MempoolWatcher {
+  public:
+    /// Options for watching.
+    class Options {
+      public:
+        bool subscribe = true;                          ///< If enabled, tries a WebSocket subscription first. Defaults to true.
+        uint64_t wsPort = 0;                            ///< WebSocket port, or 0 to use the provider's port. Defaults to 0.
+        std::chrono::milliseconds pollInterval{100};    ///< Time between filter polls. Defaults to 100ms.
+        std::size_t batchSize = 100;                    ///< Maximum number of transactions fetched per request. Defaults to 100.
+        std::size_t maxInFlight = 4;                    ///< Maximum number of fetch requests in flight. Defaults to 4.
+        std::size_t queueCapacity = 65536;              ///< Capacity of the output queue, rounded up to a power of two. Defaults to 65536.
+        std::size_t seenSize = 100000;                  ///< Number of recent hashes remembered to skip duplicates. Defaults to 100000.
+        bool seedFromTxPool = false;                    ///< If enabled, also fetches what's already pending (`txpool_content`) on start. Defaults to false.
+        dev::eth::CheckTransaction check = dev::eth::CheckTransaction::None; ///< Signature checks done when decoding. Defaults to none.
+    };
+
+    /// The ways pending transactions can be followed.
+    enum class Backend { None, Subscription, Filter };
+
+    /// A pending transaction.
+    struct Pending {
+      std::string hash;                                          ///< The transaction hash.
+      dev::bytes raw;                                            ///< The signed transaction, if the node sent it.
+      std::optional<dev::eth::TransactionBase> transaction;      ///< The decoded transaction. Empty if there was no raw data or it couldn't be decoded.
+      json object;                                               ///< The transaction object, if fetched as JSON instead of raw.
+      std::chrono::steady_clock::time_point announced;           ///< When the hash was received.
+      std::chrono::steady_clock::time_point ready;               ///< When the transaction was fetched and decoded.
+    };
+
+    /// Watcher statistics.
+    struct Stats {
+      uint64_t announced = 0;     ///< New hashes received.
+      uint64_t duplicates = 0;    ///< Hashes skipped because they were already seen.
+      uint64_t fetched = 0;       ///< Transactions fetched.
+      uint64_t decoded = 0;       ///< Transactions decoded from raw data.
+      uint64_t missing = 0;       ///< Transactions gone before they could be fetched (mined or evicted).
+      uint64_t dropped = 0;       ///< Transactions dropped because the queue was full.
+    };
+
+  private:
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    Options _options;                           ///< The watching options.
+    MpmcQueue<Pending> _queue;                  ///< Fetched transactions, ready for consumers.
+
+    mutable std::mutex _lock;                   ///< Mutex for everything below, down to _stats.
+    std::condition_variable _hashReady;         ///< Signaled when hashes are added or when stopping.
+    std::deque<std::pair<std::string, std::chrono::steady_clock::time_point>> _hashes; ///< Hashes waiting to be fetched, with when they were received.
+    std::unordered_set<std::string> _seen;      ///< Recently seen hashes.
+    std::deque<std::string> _seenOrder;         ///< Recently seen hashes, oldest first, to forget them in order.
+    Backend _backend = Backend::None;           ///< The backend in use.
+    Stats _stats;                               ///< Watcher statistics.
+
+    std::atomic<bool> _raw = true;              ///< Whether the node supports `eth_getRawTransactionByHash`.
+
+    mutable std::mutex _runLock;                ///< Mutex for starting and stopping.
+    std::condition_variable _wake;              ///< Wakes the watcher thread up when stopping.
+    std::atomic<bool> _stop = false;            ///< Tells every thread to stop.
+    std::thread _watcher;                       ///< The thread following new hashes.
+    std::vector<std::thread> _fetchers;         ///< The threads fetching transactions.
+
+    /// Follow new hashes until stopped. Runs on _watcher.
+    void _run();
+
+    /// Follow new hashes with each backend. Return `false` if it isn't supported.
+    bool _runSubscription();
+    bool _runFilter();
+
+    /// Add the pending transactions from `txpool_content`.
+    void _seed();
+
+    /// Sleep for the poll interval. Returns `false` if stopped meanwhile.
+    bool _sleep();
+
+    /// Send a request and return the parsed response. Throws std::runtime_error on network errors.
+    json _request(const json& request);
+
+    /// Queue new hashes for fetching, skipping the ones already seen.
+    void _onHashes(const std::vector<std::string>& hashes);
+
+    /// Fetch queued hashes until stopped. Runs on each of _fetchers.
+    void _runFetcher();
+
+    /// Fetch a batch of transactions and queue them for consumers.
+    void _fetch(std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>>& batch);
+
+    /// Queue a transaction for consumers, or count it as dropped.
+    void _deliver(Pending pending);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to watch.
+     */
+    MempoolWatcher(const std::unique_ptr<Provider>& provider);
+
+    /**
+     * Constructor.
+     * @param provider The provider to watch.
+     * @param options The watching options.
+     */
+    MempoolWatcher(const std::unique_ptr<Provider>& provider, Options options);
+
+    /// Destructor. Stops watching.
+    ~MempoolWatcher();
+
+    MempoolWatcher(const MempoolWatcher&) = delete;
+    MempoolWatcher& operator=(const MempoolWatcher&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /// Start watching, if not already started.
+    void start();
+
+    /// Stop watching. Transactions already queued can still be popped, and start() resumes.
+    void stop();
+
+    /// Check whether the mempool is being watched.
+    bool running() const;
+
+    /// Get the backend in use, or Backend::None if not started yet.
+    Backend backend() const;
+
+    /**
+     * Pop a pending transaction without blocking. Safe to call from any number of threads.
+     * @param out The popped transaction.
+     * @return `true` if a transaction was popped, `false` if there was none ready.
+     */
+    bool tryPop(Pending& out) { return this->_queue.tryPop(out); }
+
+    /// Get the number of transactions ready to be popped.
+    std::size_t size() const { return this->_queue.size(); }
+
+    /// Get the watcher statistics.
+    Stats stats() const;
+};
+
+#endif  // MEMPOOLWATCHER_H
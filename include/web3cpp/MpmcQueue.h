@@ -0,0 +1,119 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * Fixed-capacity lock-free FIFO queue for any number of producers and
+ * consumers, used where a consumer can't afford to block on a mutex held
+ * by a network thread (e.g. a bot reacting to pending transactions).
+ * Each slot carries a sequence number that tells producers and consumers
+ * whose turn it is, so a push or pop is a single compare-and-swap on the
+ * shared position plus one store. Nothing ever blocks: tryPush() fails
+ * when the queue is full and tryPop() fails when it is empty.
+ * The capacity is rounded up to a power of two.
+ */
+
+template <typename T> class MpmcQueue {
+  private:
+    /// A slot in the ring.
+    struct Slot {
+      std::atomic<std::size_t> seq;   ///< Position the slot is ready for: equal to it for a push, one above for a pop.
+      T item;                         ///< The stored item.
+    };
+
+    /// Keeps the producer and consumer positions on separate cache lines.
+    static constexpr std::size_t _lineSize = 64;
+
+    std::size_t _mask;                                  ///< Capacity minus one, to wrap positions around.
+    std::unique_ptr<Slot[]> _slots;                     ///< The ring.
+    alignas(_lineSize) std::atomic<std::size_t> _head{0}; ///< Position of the next push.
+    alignas(_lineSize) std::atomic<std::size_t> _tail{0}; ///< Position of the next pop.
+
+  public:
+    /**
+     * Constructor.
+     * @param capacity The minimum number of queued items. Rounded up to a
+     *                 power of two, zero is treated as one.
+     */
+    explicit MpmcQueue(std::size_t capacity) {
+      std::size_t size = 1;
+      while (size < capacity) size <<= 1;
+      _mask = size - 1;
+      _slots.reset(new Slot[size]);
+      for (std::size_t i = 0; i < size; i++) _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * Push an item without blocking.
+     * @param item The item to push. Left untouched if the queue is full.
+     * @return `true` if the item was queued, `false` if the queue is full.
+     */
+    bool tryPush(T&& item) {
+      std::size_t pos = _head.load(std::memory_order_relaxed);
+      for (;;) {
+        Slot& slot = _slots[pos & _mask];
+        std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+          if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            slot.item = std::move(item);
+            slot.seq.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;  // The slot still holds an item from the previous lap
+        } else {
+          pos = _head.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /// Copying overload of tryPush().
+    bool tryPush(const T& item) { T copy(item); return tryPush(std::move(copy)); }
+
+    /**
+     * Pop an item without blocking.
+     * @param out The popped item.
+     * @return `true` if an item was popped, `false` if the queue is empty.
+     */
+    bool tryPop(T& out) {
+      std::size_t pos = _tail.load(std::memory_order_relaxed);
+      for (;;) {
+        Slot& slot = _slots[pos & _mask];
+        std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+          if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            out = std::move(slot.item);
+            slot.item = T();
+            slot.seq.store(pos + _mask + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (diff < 0) {
+          return false;  // Nothing pushed to this slot yet
+        } else {
+          pos = _tail.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /// Get the number of queued items. Only a snapshot while other threads are using the queue.
+    std::size_t size() const {
+      std::size_t head = _head.load(std::memory_order_acquire);
+      std::size_t tail = _tail.load(std::memory_order_acquire);
+      return (head > tail) ? head - tail : 0;
+    }
+
+    /// Check if the queue is empty. Only a snapshot while other threads are using the queue.
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return _mask + 1; } ///< Getter for the capacity.
+};
+
+#endif  // MPMCQUEUE_H
@@ -0,0 +1,138 @@
+#ifndef MULTICALL_H
+#define MULTICALL_H
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Contract.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Aggregator for read-only contract calls.
+ * Calls are queued with add() and sent together by execute(), packed into
+ * `aggregate3` calls to the [Multicall3](https://github.com/mds1/multicall)
+ * contract, so thousands of reads take a handful of `eth_call`s.
+ * If Multicall3 is not deployed on the chain, the calls are sent as
+ * batched `eth_call`s instead, which is still one HTTP round trip per
+ * batch. On a local anvil node without Multicall3, it can be installed on
+ * the fly by giving its runtime bytecode in Options::runtimeCode.
+ */
+
+class Multicall {
+  public:
+    /// The address Multicall3 is deployed at on most chains.
+    static constexpr const char* address = "0xcA11bde05977b3631167028862bE2a173976CA11";
+
+    /// Options for the calls.
+    class Options {
+      public:
+        std::size_t maxCalls = 500;           ///< Maximum number of calls packed into a single `aggregate3`. Defaults to 500.
+        BlockTag block = BlockTag::latest();  ///< Block the calls are executed at. Defaults to BlockTag::latest().
+        std::string from = "0x0000000000000000000000000000000000000000"; ///< "from" address of the calls. Defaults to the zero address.
+        std::string runtimeCode;              ///< Runtime bytecode to install with `anvil_setCode` when Multicall3 is missing on an anvil node, i.e. the canonical one returned by `eth_getCode` at #address on mainnet. Defaults to empty (never install).
+    };
+
+  private:
+    /// A queued call.
+    struct Call {
+      std::string target;             ///< The contract to call.
+      std::string data;               ///< The calldata, in hex.
+      bool allowFailure;              ///< If disabled, a revert fails the whole `aggregate3` it is packed in.
+      std::promise<json> promise;     ///< Resolved with the call's result.
+      bool resolved = false;          ///< Whether the promise was set.
+    };
+
+    const std::unique_ptr<Provider>& _provider;  ///< Pointer to the provider used for the requests.
+    Options _options;                            ///< The call options.
+    std::mutex _lock;                            ///< Mutex for the queue.
+    std::vector<Call> _queue;                    ///< Calls waiting for execute().
+    std::optional<bool> _deployed;               ///< Whether Multicall3 is available, once checked.
+
+    /// Check (once) if Multicall3 is available, installing it on anvil if possible.
+    bool _checkDeployed();
+
+    /// Send calls packed into `aggregate3` calls.
+    void _aggregate(std::vector<Call>& calls);
+
+    /// Send calls as batched `eth_call`s.
+    void _batch(std::vector<Call>& calls);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the calls to.
+     */
+    Multicall(const std::unique_ptr<Provider>& provider);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the calls to.
+     * @param options The call options.
+     */
+    Multicall(const std::unique_ptr<Provider>& provider, Options options);
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Encode the calldata for an `aggregate3` call.
+     * @param calls The calls as (target, calldata, allowFailure) tuples.
+     * @return The calldata, in hex.
+     */
+    static std::string encodeAggregate3(
+      const std::vector<std::tuple<std::string, std::string, bool>>& calls
+    );
+
+    /**
+     * Decode the data returned by an `aggregate3` call.
+     * @param data The returned data, in hex.
+     * @return A list of (success, returnData) pairs, or an empty optional if
+     *         the data is malformed.
+     */
+    static std::optional<std::vector<std::pair<bool, std::string>>> decodeAggregate3(
+      const std::string& data
+    );
+
+    /**
+     * Queue a call.
+     * @param target The address of the contract to call.
+     * @param data The calldata, in hex.
+     * @param allowFailure (optional) If disabled, a revert fails every call
+     *                     packed with it. Defaults to true.
+     * @return A future with `{"result": <returned data>}`, or an `error`
+     *         object (with the revert `data`, if any), once execute() is done.
+     */
+    std::future<json> add(const std::string& target, const std::string& data, bool allowFailure = true);
+
+    /**
+     * Queue a call to a contract function, encoded with the contract's ABI.
+     * @param contract The contract. Its `options.address` is the target.
+     * @param arguments The function's arguments, as in Contract::operator().
+     * @param function The function's name.
+     * @return Same as add(const std::string&, const std::string&, bool). Fails
+     *         right away if the arguments can't be encoded.
+     */
+    std::future<json> add(Contract& contract, const json& arguments, const std::string& function);
+
+    /// Get the number of calls waiting for execute().
+    std::size_t size();
+
+    /**
+     * Send every queued call and resolve their futures.
+     * @return `{"result": <number of calls sent>}`.
+     */
+    std::future<json> execute();
+};
+
+#endif  // MULTICALL_H
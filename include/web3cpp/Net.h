@@ -1,8 +1,11 @@
 #ifndef NET_H
 #define NET_H
 
+#include <chrono>
 #include <future>
+#include <functional>
 #include <string>
+#include <vector>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -36,6 +39,82 @@ namespace Net {
     const std::unique_ptr<Provider>& provider, const RequestTypes& requestType, const std::string& reqBody
   );
 
+  /**
+   * Make an HTTP request to a given provider and read the response body as a stream.
+   * The body is pulled from the socket in fixed-size chunks as the stream is
+   * consumed, so it is never held in memory as a whole, no matter its size.
+   * Throws std::runtime_error on network errors, same as HTTPRequest().
+   * @param *provider The provider to send the request to.
+   * @param requestType The type of network request.
+   * @param reqBody The body of the request.
+   * @param onBody Function that consumes the response body. Called once,
+   *               on the calling thread, while the connection is open.
+   *               Anything left unread when it returns is discarded.
+   */
+  void HTTPStreamRequest(
+    const std::unique_ptr<Provider>& provider, const RequestTypes& requestType,
+    const std::string& reqBody, const std::function<void(std::istream&)>& onBody
+  );
+
+  /**
+   * Send several JSON-RPC requests to a given provider as a single batch.
+   * Each request is given a unique id, and the responses (which nodes may
+   * send in any order) are matched back to their requests by that id.
+   * Throws std::runtime_error on network errors, same as HTTPRequest().
+   * @param *provider The provider to send the requests to.
+   * @param requests The requests to send. Their ids are overwritten.
+   * @return The responses, in the same order as the requests. Requests left
+   *         without a response (e.g. the node rejected the whole batch)
+   *         get an `error` object instead.
+   */
+  std::vector<json> HTTPBatchRequest(
+    const std::unique_ptr<Provider>& provider, std::vector<json> requests
+  );
+
+  /**
+   * Send many JSON-RPC requests as batches over parallel connections.
+   * Batches are handed out to the threads as they finish, so a slow batch
+   * doesn't hold back the rest. Batches that fail on the network count as
+   * failed, they aren't retried.
+   * @param *provider The provider to send the requests to.
+   * @param count The number of requests.
+   * @param batchSize The maximum number of requests per batch.
+   * @param parallelism The maximum number of batches in flight at once.
+   * @param build Builds the request at an index. Requests it sets an error
+   *              for are skipped and count as failed.
+   * @param onResponse Takes the response for an index and returns whether
+   *                   it succeeded. Called from several threads at once,
+   *                   but never twice for the same index.
+   * @return Whether each request succeeded, in order.
+   */
+  std::vector<bool> HTTPBulkRequest(
+    const std::unique_ptr<Provider>& provider, std::size_t count,
+    std::size_t batchSize, unsigned int parallelism,
+    const std::function<json(std::size_t, Error&)>& build,
+    const std::function<bool(std::size_t, json&)>& onResponse
+  );
+
+  /**
+   * Open a JSON-RPC subscription to a given provider over a WebSocket.
+   * Connects to the provider's host and target (as "ws" for "http" providers
+   * and "wss" for "https" ones), sends the request and passes every message
+   * received to a consumer until either side closes the connection.
+   * Throws std::runtime_error on network errors.
+   * @param *provider The provider to connect to.
+   * @param port The WebSocket port, or 0 to use the provider's port.
+   * @param request The subscription request (e.g. from RPC::eth_subscribe()).
+   * @param onMessage Function that receives each message, starting with the
+   *                  response to the request. Return `false` to close.
+   * @param keepOpen Function checked every `checkInterval` while waiting
+   *                 for messages. Return `false` to close.
+   * @param checkInterval How often `keepOpen` is checked.
+   */
+  void WSSubscribe(
+    const std::unique_ptr<Provider>& provider, uint64_t port, const json& request,
+    const std::function<bool(const json&)>& onMessage,
+    const std::function<bool()>& keepOpen, std::chrono::milliseconds checkInterval
+  );
+
   /**
    * Make an HTTP request to a custom target.
    * @param reqBody The body of the request.
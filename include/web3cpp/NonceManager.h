@@ -0,0 +1,165 @@
+#ifndef NONCEMANAGER_H
+#define NONCEMANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Error.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Local nonce bookkeeping for senders that send many transactions at once.
+ * Each address is synced from the node once, with `eth_getTransactionCount`,
+ * and nonces are then handed out locally with an atomic fetch-add, so any
+ * number of threads can reserve nonces for the same sender without a
+ * request or a lock per transaction.
+ * Nonces whose transaction never reached the node are released back: the
+ * last one handed out is simply taken back, and older ones are kept as gaps
+ * that the next reservations fill first, so no nonce is left unused.
+ * A "nonce too low" or "nonce too high" error from the node means the local
+ * count drifted (e.g. another process sent from the same account), so the
+ * sender is synced again on its next reservation.
+ */
+
+class NonceManager {
+  public:
+    /// Options for the manager.
+    class Options {
+      public:
+        /// If enabled, syncs from the `pending` count, so transactions already
+        /// in the mempool are accounted for. Otherwise uses `latest`. Defaults to true.
+        bool includePending = true;
+    };
+
+  private:
+    /// Nonce state of a sender.
+    struct Sender {
+      std::mutex lock;                      ///< Held while syncing and for the gaps.
+      std::atomic<bool> synced = false;     ///< Whether `next` came from the node.
+      std::atomic<uint64_t> next = 0;       ///< The next nonce never handed out.
+      std::atomic<std::size_t> gapCount = 0; ///< Size of `gaps`, to skip the lock when there are none.
+      std::set<uint64_t> gaps;              ///< Released nonces below `next`, handed out first.
+    };
+
+    const std::unique_ptr<Provider>& _provider;   ///< Pointer to the provider used for the requests.
+    Options _options;                             ///< The manager options.
+
+    mutable std::shared_mutex _sendersLock;       ///< Mutex for the sender map (not the senders themselves).
+    std::unordered_map<std::string, std::unique_ptr<Sender>> _senders; ///< Senders, by lowercase address.
+
+    /// Get the state of a sender, creating it if needed.
+    Sender& _sender(const std::string& address);
+
+    /// Find the state of a sender, or `nullptr` if it was never used.
+    Sender* _find(const std::string& address) const;
+
+    /// Sync a sender from the node if needed. Returns `false` on failure.
+    bool _sync(const std::string& address, Sender& sender, Error &err);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to sync from.
+     */
+    NonceManager(const std::unique_ptr<Provider>& provider);
+
+    /**
+     * Constructor.
+     * @param provider The provider to sync from.
+     * @param options The manager options.
+     */
+    NonceManager(const std::unique_ptr<Provider>& provider, Options options);
+
+    NonceManager(const NonceManager&) = delete;
+    NonceManager& operator=(const NonceManager&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Check if a node error is about the transaction's nonce.
+     * Recognizes the messages used by geth, Nethermind, Erigon, Anvil and others.
+     * @param error The `error` object of the response.
+     * @return `true` if the nonce was too low or too high, `false` otherwise.
+     */
+    static bool isNonceError(const json& error);
+
+    /**
+     * Check if a node error proves a transaction's nonce was left unused.
+     * Only rejections from checks that run before the transaction gets a
+     * slot in the pool count (e.g. insufficient funds or gas too low);
+     * "already known" and underpriced replacements mean the nonce is taken.
+     * @param error The `error` object of the response.
+     * @return `true` if the nonce can be given back with release(), `false` otherwise.
+     */
+    static bool isNonceUnused(const json& error);
+
+    /**
+     * Reserve the next nonce for a sender. The first call for an address
+     * syncs it from the node, later ones make no requests.
+     * @param address The sender address.
+     * @param &err Error object. Set if the sender couldn't be synced.
+     * @return The nonce, or an empty optional on error.
+     */
+    std::optional<uint64_t> reserve(const std::string& address, Error &err);
+
+    /**
+     * Give back a reserved nonce whose transaction never reached the node
+     * (e.g. it failed to sign or the request failed), so it's used again.
+     * @param address The sender address.
+     * @param nonce The nonce from reserve().
+     */
+    void release(const std::string& address, uint64_t nonce);
+
+    /**
+     * Take an error from sending a transaction. Nonce errors make the sender
+     * sync again on its next reservation, anything else is ignored.
+     * @param address The sender address.
+     * @param error The `error` object of the response.
+     * @return `true` if it was a nonce error, `false` otherwise.
+     */
+    bool handleError(const std::string& address, const json& error);
+
+    /**
+     * Make a sender sync from the node again on its next reservation,
+     * dropping its gaps.
+     * @param address The sender address.
+     */
+    void resync(const std::string& address);
+
+    /**
+     * Set the next nonce of a sender by hand, e.g. after sending from
+     * elsewhere. Drops its gaps.
+     * @param address The sender address.
+     * @param next The next nonce to hand out.
+     */
+    void set(const std::string& address, uint64_t next);
+
+    /**
+     * Get the next nonce that would be handed out, without reserving it.
+     * @param address The sender address.
+     * @return The nonce, or an empty optional if the sender isn't synced.
+     */
+    std::optional<uint64_t> peek(const std::string& address) const;
+
+    /**
+     * Get the released nonces waiting to be used again.
+     * @param address The sender address.
+     * @return The nonces, lowest first.
+     */
+    std::vector<uint64_t> gaps(const std::string& address) const;
+};
+
+#endif  // NONCEMANAGER_H
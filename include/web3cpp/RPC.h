@@ -6,6 +6,7 @@
 #include <string>
 #include <sstream>
 
+#include <web3cpp/BlockTag.h>
 #include <web3cpp/Error.h>
 #include <web3cpp/Utils.h>
 
@@ -61,7 +62,8 @@ namespace RPC {
 
   /**
    * Check if a given string is a valid block number.
-   * A "valid block number" is either `"latest"`, `"earliest"`, `"pending"` or a digit.
+   * A "valid block number" is either `"latest"`, `"earliest"`, `"pending"`,
+   * `"safe"`, `"finalized"` or a hex number.
    * @param block The block number to check.
    * @return `true` if block number is valid, `false` otherwise.
    */
@@ -75,6 +77,22 @@ namespace RPC {
    */
   bool _checkRewardPercentiles(const std::vector<uint64_t>& rewardPercentiles);
 
+  /**
+   * Check the fields of a call object (as used by eth_call).
+   * @param callObject The call object to check.
+   * @return The error code for the first invalid field, or `0` if all fields are valid.
+   */
+  int _checkCallObject(const json& callObject);
+
+  /**
+   * Check if a given JSON array is a valid list of log filter topics.
+   * Each position can be `null` (any topic), a hex topic, or an array of
+   * hex topics (any of them).
+   * @param topics The topics to check.
+   * @return `true` if the topics are valid, `false` otherwise.
+   */
+  bool _checkTopics(const json& topics);
+
   json web3_clientVersion(); ///< Build data for `web3_clientVersion`.
 
   /**
@@ -108,6 +126,9 @@ namespace RPC {
   /// Overload of getBalance() that takes a BigNumber as the block.
   json eth_getBalance(const std::string& address, BigNumber defaultBlock, Error &err);
 
+  /// Overload of getBalance() that takes a BlockTag as the block.
+  json eth_getBalance(const std::string& address, const BlockTag& defaultBlock, Error &err);
+
   /**
    * Build data for `eth_getStorageAt`.
    * @param address The address to check for storage.
@@ -120,6 +141,9 @@ namespace RPC {
   /// Overload of getStorageAt() that takes a BigNumber as the block.
   json eth_getStorageAt(const std::string& address, const std::string& position, BigNumber defaultBlock, Error &err);
 
+  /// Overload of getStorageAt() that takes a Quantity as the position and a BlockTag as the block.
+  json eth_getStorageAt(const std::string& address, const Quantity& position, const BlockTag& defaultBlock, Error &err);
+
   /**
    * Build data for `eth_getTransactionCount`.
    * @param address The address to check for number of sent transactions.
@@ -131,6 +155,9 @@ namespace RPC {
   /// Overload of getTransactionCount() that takes a BigNumber as the block.
   json eth_getTransactionCount(const std::string& address, BigNumber defaultBlock, Error &err);
 
+  /// Overload of getTransactionCount() that takes a BlockTag as the block.
+  json eth_getTransactionCount(const std::string& address, const BlockTag& defaultBlock, Error &err);
+
   /**
    * Build data for `eth_getBlockTransactionCountByHash`.
    * @param hash The hash of a block.
@@ -148,6 +175,10 @@ namespace RPC {
   /// Overload of eth_getBlockTransactionCountByNumber() that takes a BigNumber as the block.
   json eth_getBlockTransactionCountByNumber(BigNumber number, Error &err);
 
+  /// Overload of eth_getBlockTransactionCountByNumber() that takes a BlockTag as the block.
+  /// Block hashes are sent to the matching "ByHash" method instead.
+  json eth_getBlockTransactionCountByNumber(const BlockTag& number);
+
   /**
    * Build data for `eth_getUncleCountByBlockHash`.
    * @param hash The hash of a block.
@@ -165,6 +196,10 @@ namespace RPC {
   /// Overload of eth_getUncleCountByBlockNumber() that takes a BigNumber as the block.
   json eth_getUncleCountByBlockNumber(BigNumber number, Error &err);
 
+  /// Overload of eth_getUncleCountByBlockNumber() that takes a BlockTag as the block.
+  /// Block hashes are sent to the matching "ByHash" method instead.
+  json eth_getUncleCountByBlockNumber(const BlockTag& number);
+
   /**
    * Build data for `eth_getCode`.
    * @param address The address to check for data.
@@ -176,6 +211,9 @@ namespace RPC {
   /// Overload of eth_getCode() that takes a BigNumber as the block.
   json eth_getCode(const std::string& address, BigNumber defaultBlock, Error &err);
 
+  /// Overload of eth_getCode() that takes a BlockTag as the block.
+  json eth_getCode(const std::string& address, const BlockTag& defaultBlock, Error &err);
+
   /**
    * Build data for `eth_sign`.
    * @param address The address to use for signing.
@@ -216,6 +254,9 @@ namespace RPC {
   /// Overload of eth_call() that takes a BigNumber as the block.
   json eth_call(const json& callObject, BigNumber defaultBlock, Error &err);
 
+  /// Overload of eth_call() that takes a BlockTag as the block.
+  json eth_call(const json& callObject, const BlockTag& defaultBlock, Error &err);
+
   /**
    * Build data for `eth_estimateGas`.
    * @param callObject The transaction call object.
@@ -244,6 +285,10 @@ namespace RPC {
   /// Overload of eth_getBlockByNumber() that takes a BigNumber as the block.
   json eth_getBlockByNumber(BigNumber number, bool returnTransactionObjects, Error &err);
 
+  /// Overload of eth_getBlockByNumber() that takes a BlockTag as the block.
+  /// Block hashes are sent to the matching "ByHash" method instead.
+  json eth_getBlockByNumber(const BlockTag& number, bool returnTransactionObjects);
+
   /**
    * Build data for `eth_getTransactionByHash`.
    * @param hash The hash of a transaction.
@@ -251,6 +296,13 @@ namespace RPC {
    */
   json eth_getTransactionByHash(const std::string& hash, Error &err);
 
+  /**
+   * Build data for `eth_getRawTransactionByHash`.
+   * @param hash The hash of a transaction.
+   * @param &err Error object.
+   */
+  json eth_getRawTransactionByHash(const std::string& hash, Error &err);
+
   /**
    * Build data for `eth_getTransactionByBlockHashAndIndex`.
    * @param hash The hash of a block.
@@ -270,6 +322,10 @@ namespace RPC {
   /// Overload of eth_getTransactionByBlockNumberAndIndex() that takes a BigNumber as the block.
   json eth_getTransactionByBlockNumberAndIndex(BigNumber number, const std::string& index, Error &err);
 
+  /// Overload of eth_getTransactionByBlockNumberAndIndex() that takes a BlockTag as the block and a Quantity as the index.
+  /// Block hashes are sent to the matching "ByHash" method instead.
+  json eth_getTransactionByBlockNumberAndIndex(const BlockTag& number, const Quantity& index);
+
   /**
    * Build data for `eth_getTransactionReceipt`.
    * @param hash The hash of a transaction.
@@ -277,6 +333,14 @@ namespace RPC {
    */
   json eth_getTransactionReceipt(const std::string& hash, Error &err);
 
+  /**
+   * Build data for `eth_getBlockReceipts`.
+   * Not every node supports this method, callers should be ready to fall
+   * back to eth_getTransactionReceipt() for each transaction.
+   * @param block The block to get all transaction receipts from.
+   */
+  json eth_getBlockReceipts(const BlockTag& block);
+
   /**
    * Build data for `eth_getUncleByBlockHashAndIndex`.
    * @param hash The hash of a block.
@@ -296,6 +360,10 @@ namespace RPC {
   /// Overload of eth_getUncleByBlockNumberAndIndex() that takes a BigNumber as the block.
   json eth_getUncleByBlockNumberAndIndex(BigNumber number, const std::string& index, Error &err);
 
+  /// Overload of eth_getUncleByBlockNumberAndIndex() that takes a BlockTag as the block and a Quantity as the index.
+  /// Block hashes are sent to the matching "ByHash" method instead.
+  json eth_getUncleByBlockNumberAndIndex(const BlockTag& number, const Quantity& index);
+
   json eth_getCompilers();  ///< Build data for `eth_getCompilers`.
 
   /**
@@ -336,6 +404,27 @@ namespace RPC {
    */
   json eth_getLogs(json filterOptions, Error &err);
 
+  /**
+   * Build data for `eth_subscribe`. Only works over a WebSocket connection.
+   * @param type The subscription type (`newHeads`, `logs`,
+   *             `newPendingTransactions` or `syncing`).
+   * @param &err Error object.
+   */
+  json eth_subscribe(const std::string& type, Error &err);
+
+  /**
+   * Overload of eth_subscribe() that takes extra parameters
+   * (e.g. the filter options for a `logs` subscription).
+   */
+  json eth_subscribe(const std::string& type, json params, Error &err);
+
+  /**
+   * Build data for `eth_unsubscribe`.
+   * @param subscriptionId The subscription id.
+   * @param &err Error object.
+   */
+  json eth_unsubscribe(const std::string& subscriptionId, Error &err);
+
   json eth_getWork(); ///< Build data for `eth_getWork`.
 
   /**
@@ -378,6 +467,10 @@ namespace RPC {
    */
   json eth_feeHistory(uint64_t blockCount, const std::string& defaultBlock, std::vector<uint64_t> rewardPercentiles, Error &err);
 
+  /// Overload of eth_feeHistory() that takes a BlockTag as the block.
+  /// Block hashes are not accepted by the node and set error 9.
+  json eth_feeHistory(uint64_t blockCount, const BlockTag& defaultBlock, std::vector<uint64_t> rewardPercentiles, Error &err);
+
   /**
    * Removes transaction from the pool.
    * @param transactionHash The transaction hash.
@@ -413,6 +506,14 @@ namespace RPC {
    */
   json anvil_addBalance(const std::string& address, BigNumber amount, Error &err);
 
+  /**
+   * Sets the runtime bytecode of an account.
+   * @param address The address of an account.
+   * @param code The new runtime bytecode, in hex.
+   * @param &err Error object.
+   */
+  json anvil_setCode(const std::string& address, const std::string& code, Error &err);
+
   /**
    * Query the number of transactions currently pending for inclusion in the next
    * block, as weel as the ones that are being scheduled for future execution.
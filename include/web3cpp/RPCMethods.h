@@ -0,0 +1,352 @@
+#ifndef RPCMETHODS_H
+#define RPCMETHODS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/FixedHash.h>
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Single source of truth for every JSON-RPC method the library knows about.
+ * Each entry in #WEB3CPP_RPC_METHODS declares, in order:
+ * - the method id (same as the matching builder in namespace %RPC)
+ * - the method name as sent over the wire
+ * - whether the method is read-only (never changes node or chain state)
+ * - whether the method is idempotent (safe to resend as-is)
+ * - a relative cost weight, used by rate limiters
+ * - the C++ type the `result` field decodes to
+ * - the C++ types of each positional parameter
+ *
+ * Everything else in this header (the Method enum, the descriptor table,
+ * the typed serializer and the typed decoder) is generated from that list,
+ * so layers like retries, caching or rate limiting can consult the flags
+ * through RPC::methodInfo() instead of matching method name strings.
+ */
+#define WEB3CPP_RPC_METHODS(X) \
+  X(web3_clientVersion, "web3_clientVersion", true, true, 1, std::string) \
+  X(web3_sha3, "web3_sha3", true, true, 1, dev::h256, dev::bytes) \
+  X(net_version, "net_version", true, true, 1, std::string) \
+  X(net_listening, "net_listening", true, true, 1, bool) \
+  X(net_peerCount, "net_peerCount", true, true, 1, BigNumber) \
+  X(eth_protocolVersion, "eth_protocolVersion", true, true, 1, std::string) \
+  X(eth_syncing, "eth_syncing", true, true, 1, json) \
+  X(eth_coinbase, "eth_coinbase", true, true, 1, dev::Address) \
+  X(eth_mining, "eth_mining", true, true, 1, bool) \
+  X(eth_hashrate, "eth_hashrate", true, true, 1, BigNumber) \
+  X(eth_gasPrice, "eth_gasPrice", true, true, 2, BigNumber) \
+  X(eth_accounts, "eth_accounts", true, true, 1, std::vector<dev::Address>) \
+  X(eth_blockNumber, "eth_blockNumber", true, true, 1, uint64_t) \
+  X(eth_getBalance, "eth_getBalance", true, true, 2, BigNumber, dev::Address, BlockTag) \
+  X(eth_getStorageAt, "eth_getStorageAt", true, true, 2, dev::h256, dev::Address, Quantity, BlockTag) \
+  X(eth_getTransactionCount, "eth_getTransactionCount", true, true, 3, BigNumber, dev::Address, BlockTag) \
+  X(eth_getBlockTransactionCountByHash, "eth_getBlockTransactionCountByHash", true, true, 2, BigNumber, dev::h256) \
+  X(eth_getBlockTransactionCountByNumber, "eth_getBlockTransactionCountByNumber", true, true, 2, BigNumber, BlockTag) \
+  X(eth_getUncleCountByBlockHash, "eth_getUncleCountByBlockHash", true, true, 2, BigNumber, dev::h256) \
+  X(eth_getUncleCountByBlockNumber, "eth_getUncleCountByBlockNumber", true, true, 2, BigNumber, BlockTag) \
+  X(eth_getCode, "eth_getCode", true, true, 3, dev::bytes, dev::Address, BlockTag) \
+  X(eth_sign, "eth_sign", true, true, 5, dev::bytes, dev::Address, dev::bytes) \
+  X(eth_signTransaction, "eth_signTransaction", true, true, 5, json, json) \
+  X(eth_sendTransaction, "eth_sendTransaction", false, false, 25, dev::h256, json) \
+  X(eth_sendRawTransaction, "eth_sendRawTransaction", false, true, 25, dev::h256, dev::bytes) \
+  X(eth_call, "eth_call", true, true, 3, dev::bytes, json, BlockTag) \
+  X(eth_estimateGas, "eth_estimateGas", true, true, 9, BigNumber, json) \
+  X(eth_getBlockByHash, "eth_getBlockByHash", true, true, 2, json, dev::h256, bool) \
+  X(eth_getBlockByNumber, "eth_getBlockByNumber", true, true, 2, json, BlockTag, bool) \
+  X(eth_getTransactionByHash, "eth_getTransactionByHash", true, true, 2, json, dev::h256) \
+  X(eth_getRawTransactionByHash, "eth_getRawTransactionByHash", true, true, 2, dev::bytes, dev::h256) \
+  X(eth_getTransactionByBlockHashAndIndex, "eth_getTransactionByBlockHashAndIndex", true, true, 2, json, dev::h256, BigNumber) \
+  X(eth_getTransactionByBlockNumberAndIndex, "eth_getTransactionByBlockNumberAndIndex", true, true, 2, json, BlockTag, Quantity) \
+  X(eth_getTransactionReceipt, "eth_getTransactionReceipt", true, true, 2, json, dev::h256) \
+  X(eth_getBlockReceipts, "eth_getBlockReceipts", true, true, 8, json, BlockTag) \
+  X(eth_getUncleByBlockHashAndIndex, "eth_getUncleByBlockHashAndIndex", true, true, 2, json, dev::h256, BigNumber) \
+  X(eth_getUncleByBlockNumberAndIndex, "eth_getUncleByBlockNumberAndIndex", true, true, 2, json, BlockTag, Quantity) \
+  X(eth_getCompilers, "eth_getCompilers", true, true, 1, json) \
+  X(eth_newFilter, "eth_newFilter", false, false, 2, std::string, json) \
+  X(eth_newBlockFilter, "eth_newBlockFilter", false, false, 2, std::string) \
+  X(eth_newPendingTransactionFilter, "eth_newPendingTransactionFilter", false, false, 2, std::string) \
+  X(eth_uninstallFilter, "eth_uninstallFilter", false, true, 1, bool, std::string) \
+  X(eth_getFilterChanges, "eth_getFilterChanges", false, false, 2, json, std::string) \
+  X(eth_getFilterLogs, "eth_getFilterLogs", true, true, 8, json, std::string) \
+  X(eth_getLogs, "eth_getLogs", true, true, 8, json, json) \
+  X(eth_subscribe, "eth_subscribe", false, false, 2, std::string, std::string) \
+  X(eth_unsubscribe, "eth_unsubscribe", false, true, 1, bool, std::string) \
+  X(eth_getWork, "eth_getWork", true, true, 1, json) \
+  X(eth_submitWork, "eth_submitWork", false, true, 1, bool, dev::h64, dev::h256, dev::h256) \
+  X(eth_submitHashrate, "eth_submitHashrate", false, true, 1, bool, dev::h256, dev::h256) \
+  X(eth_maxPriorityFeePerGas, "eth_maxPriorityFeePerGas", true, true, 1, BigNumber) \
+  X(eth_feeHistory, "eth_feeHistory", true, true, 1, json, uint64_t, BlockTag, std::vector<uint64_t>) \
+  X(anvil_dropTransaction, "anvil_dropTransaction", false, true, 1, json, dev::h256) \
+  X(anvil_dropAllTransactions, "anvil_dropAllTransactions", false, true, 1, json) \
+  X(anvil_setNextBlockBaseFeePerGas, "anvil_setNextBlockBaseFeePerGas", false, true, 1, json, BigNumber) \
+  X(anvil_setBalance, "anvil_setBalance", false, true, 1, json, dev::Address, BigNumber) \
+  X(anvil_addBalance, "anvil_addBalance", false, false, 1, json, dev::Address, BigNumber) \
+  X(anvil_setCode, "anvil_setCode", false, true, 1, json, dev::Address, dev::bytes) \
+  X(geth_txPoolStatus, "txpool_status", true, true, 2, json) \
+  X(geth_txPoolContent, "txpool_content", true, true, 20, json)
+
+namespace RPC {
+  /// Identifier for every method listed in #WEB3CPP_RPC_METHODS.
+  enum class Method : uint16_t {
+    #define WEB3CPP_RPC_ENUM(id, ...) id,
+    WEB3CPP_RPC_METHODS(WEB3CPP_RPC_ENUM)
+    #undef WEB3CPP_RPC_ENUM
+  };
+
+  /// Static description of a single JSON-RPC method.
+  struct MethodInfo {
+    Method id;              ///< The method's identifier.
+    std::string_view name;  ///< The method name as sent over the wire.
+    bool readOnly;          ///< `true` if the method never changes node or chain state.
+    bool idempotent;        ///< `true` if the exact same request can be safely resent.
+    uint16_t cost;          ///< Relative cost weight of the method (1 = cheapest).
+  };
+
+  /// Descriptor table, indexed by the underlying value of Method.
+  inline constexpr std::array methodTable = {
+    #define WEB3CPP_RPC_INFO(id, name, readOnly, idempotent, cost, ...) \
+      MethodInfo{Method::id, name, readOnly, idempotent, cost},
+    WEB3CPP_RPC_METHODS(WEB3CPP_RPC_INFO)
+    #undef WEB3CPP_RPC_INFO
+  };
+
+  /**
+   * Get the descriptor for a given method.
+   * @param method The method identifier.
+   * @return The method's descriptor.
+   */
+  constexpr const MethodInfo& methodInfo(Method method) {
+    return methodTable[static_cast<std::size_t>(method)];
+  }
+
+  /**
+   * Find the descriptor for a given wire method name.
+   * @param name The method name (e.g. `"eth_getBalance"`).
+   * @return A pointer to the method's descriptor, or `nullptr` if the method is unknown.
+   */
+  constexpr const MethodInfo* findMethod(std::string_view name) {
+    for (const MethodInfo& info : methodTable) {
+      if (info.name == name) return &info;
+    }
+    return nullptr;
+  }
+
+  /**
+   * Find the descriptor for an already built request, as returned by the
+   * builder functions in namespace %RPC.
+   * @param request The request object.
+   * @return A pointer to the method's descriptor, or `nullptr` if the method is unknown.
+   */
+  const MethodInfo* findRequestMethod(const json& request);
+
+  /**
+   * Compile-time traits for a given method.
+   * Exposes `Result` (the type `result` decodes to) and `Params`
+   * (a tuple with the type of each positional parameter).
+   */
+  template <Method M> struct MethodTraits;
+
+  #define WEB3CPP_RPC_TRAITS(id, name, readOnly, idempotent, cost, result, ...) \
+    template <> struct MethodTraits<Method::id> { \
+      using Result = result; \
+      using Params = std::tuple<__VA_ARGS__>; \
+    };
+  WEB3CPP_RPC_METHODS(WEB3CPP_RPC_TRAITS)
+  #undef WEB3CPP_RPC_TRAITS
+
+  /**
+   * Append a number to a request as a JSON-RPC quantity (e.g. `"0x1a"`, `"0x0"`).
+   * @param out The string to append to.
+   * @param value The number to append.
+   */
+  void _writeQuantity(std::string& out, const BigNumber& value);
+
+  /// Overload of _writeQuantity() for native integers.
+  void _writeQuantity(std::string& out, uint64_t value);
+
+  /**
+   * Append a string to a request as a quoted JSON string.
+   * Strings that need escaping go through nlohmann::json, everything else is copied directly.
+   * @param out The string to append to.
+   * @param value The string to append.
+   */
+  void _writeString(std::string& out, std::string_view value);
+
+  /**
+   * Parse a JSON-RPC quantity (e.g. `"0x1a"`) without going through a stream.
+   * @param hex The quantity string, with or without the "0x" prefix.
+   * @return The parsed number.
+   * @throw std::invalid_argument if the string contains non-hex characters.
+   */
+  BigNumber _parseQuantity(std::string_view hex);
+
+  /// Serialization rules for each parameter type used in #WEB3CPP_RPC_METHODS.
+  template <typename T> struct ParamTraits;
+
+  template <unsigned N> struct ParamTraits<dev::FixedHash<N>> {
+    static void write(std::string& out, const dev::FixedHash<N>& value) {
+      out += "\"0x"; out += dev::toHex(value); out += '"';
+    }
+  };
+
+  template <> struct ParamTraits<BigNumber> {
+    static void write(std::string& out, const BigNumber& value) { _writeQuantity(out, value); }
+  };
+
+  template <> struct ParamTraits<uint64_t> {
+    static void write(std::string& out, uint64_t value) { _writeQuantity(out, value); }
+  };
+
+  template <> struct ParamTraits<bool> {
+    static void write(std::string& out, bool value) { out += (value) ? "true" : "false"; }
+  };
+
+  template <> struct ParamTraits<std::string> {
+    static void write(std::string& out, std::string_view value) { _writeString(out, value); }
+  };
+
+  template <> struct ParamTraits<dev::bytes> {
+    static void write(std::string& out, const dev::bytes& value) {
+      out += "\"0x"; out += dev::toHex(value); out += '"';
+    }
+  };
+
+  template <> struct ParamTraits<std::vector<uint64_t>> {
+    static void write(std::string& out, const std::vector<uint64_t>& value) {
+      out += '[';
+      for (std::size_t i = 0; i < value.size(); i++) {
+        if (i != 0) out += ',';
+        out += std::to_string(value[i]);
+      }
+      out += ']';
+    }
+  };
+
+  template <> struct ParamTraits<json> {
+    static void write(std::string& out, const json& value) { out += value.dump(); }
+  };
+
+  template <> struct ParamTraits<Quantity> {
+    static void write(std::string& out, const Quantity& value) { _writeQuantity(out, value.value()); }
+  };
+
+  template <> struct ParamTraits<BlockTag> {
+    static void write(std::string& out, const BlockTag& value) { value.appendJSON(out); }
+  };
+
+  /// Decoding rules for each result type used in #WEB3CPP_RPC_METHODS.
+  template <typename T> struct ResultTraits {
+    static T read(const json& value) { return value.get<T>(); }
+  };
+
+  template <unsigned N> struct ResultTraits<dev::FixedHash<N>> {
+    static dev::FixedHash<N> read(const json& value) {
+      return dev::FixedHash<N>(value.get_ref<const std::string&>());
+    }
+  };
+
+  template <> struct ResultTraits<BigNumber> {
+    static BigNumber read(const json& value) {
+      return _parseQuantity(value.get_ref<const std::string&>());
+    }
+  };
+
+  template <> struct ResultTraits<uint64_t> {
+    static uint64_t read(const json& value) {
+      return static_cast<uint64_t>(_parseQuantity(value.get_ref<const std::string&>()));
+    }
+  };
+
+  template <> struct ResultTraits<dev::bytes> {
+    static dev::bytes read(const json& value) {
+      return dev::fromHex(value.get_ref<const std::string&>(), dev::WhenError::Throw);
+    }
+  };
+
+  template <> struct ResultTraits<std::vector<dev::Address>> {
+    static std::vector<dev::Address> read(const json& value) {
+      std::vector<dev::Address> ret;
+      ret.reserve(value.size());
+      for (const json& item : value) ret.emplace_back(item.get_ref<const std::string&>());
+      return ret;
+    }
+  };
+
+  template <> struct ResultTraits<json> {
+    static json read(const json& value) { return value; }
+  };
+
+  /// @cond
+  template <typename Params, std::size_t... I, typename... Args>
+  void _writeParams(std::string& out, std::index_sequence<I...>, const Args&... args) {
+    ((out += (I == 0) ? "" : ",",
+      ParamTraits<std::tuple_element_t<I, Params>>::write(out, args)), ...);
+  }
+  /// @endcond
+
+  /**
+   * Serialize a request for a given method straight to its wire format,
+   * without building an intermediate JSON object.
+   * Parameters are type-checked at compile time against the method's
+   * declared parameter types, so no further validation is done here.
+   * @param id The request id.
+   * @param args The method's positional parameters.
+   * @return The request body, ready to be sent through Net::HTTPRequest().
+   */
+  template <Method M, typename... Args>
+  std::string serialize(uint64_t id, const Args&... args) {
+    using Params = typename MethodTraits<M>::Params;
+    static_assert(
+      sizeof...(Args) == std::tuple_size_v<Params>,
+      "Wrong number of parameters for this RPC method"
+    );
+    constexpr const MethodInfo& info = methodInfo(M);
+    std::string out;
+    out.reserve(64 + info.name.size());
+    out += R"({"jsonrpc":"2.0","method":")";
+    out += info.name;
+    out += R"(","params":[)";
+    _writeParams<Params>(out, std::index_sequence_for<Args...>{}, args...);
+    out += R"(],"id":)";
+    out += std::to_string(id);
+    out += '}';
+    return out;
+  }
+
+  /**
+   * Decode the `result` field of a response into the method's declared result type.
+   * @param response The parsed response object.
+   * @param &err Error object. Set to 39 if the response carries an error,
+   *             has no result or the result doesn't match the declared type.
+   * @return The decoded result, or a default constructed value on failure.
+   */
+  template <Method M>
+  typename MethodTraits<M>::Result decode(const json& response, Error &err) {
+    using Result = typename MethodTraits<M>::Result;
+    if (response.contains("error") || !response.contains("result")) {
+      err.setCode(39); return Result{}; // Invalid RPC Response
+    }
+    try {
+      Result ret = ResultTraits<Result>::read(response["result"]);
+      err.setCode(0);
+      return ret;
+    } catch (std::exception &e) {
+      err.setCode(39); return Result{}; // Invalid RPC Response
+    }
+  }
+};
+
+#endif  // RPCMETHODS_H
@@ -0,0 +1,134 @@
+#ifndef RECEIPTWAITER_H
+#define RECEIPTWAITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Contract.h>
+#include <web3cpp/HeadTracker.h>
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Waiter for the receipts of many transactions at once.
+ * Pending transactions are polled together, as batched
+ * `eth_getTransactionReceipt` calls, once per new head reported by a
+ * HeadTracker (plus once right after each one is added), instead of each
+ * transaction polling the node on its own timer.
+ * A transaction is resolved once its receipt is buried under enough
+ * blocks. Receipts from blocks dropped by a reorg are fetched again.
+ */
+
+class ReceiptWaiter {
+  public:
+    /// Options for waiting.
+    class Options {
+      public:
+        unsigned int confirmations = 1;     ///< Blocks required to confirm a transaction, counting its own. Defaults to 1.
+        std::chrono::seconds timeout{750};  ///< Time to wait for a confirmed receipt. Defaults to 750s.
+        unsigned int blockTimeout = 50;     ///< New blocks to wait for the receipt to show up, or 0 to not limit. Defaults to 50.
+        std::size_t batchSize = 500;        ///< Maximum number of receipts requested per batch. Defaults to 500.
+
+        /**
+         * Build options from a contract's transaction options
+         * (`transactionConfirmationBlocks`, `transactionPollingTimeout`
+         * and `transactionBlockTimeout`).
+         * @param options The contract options.
+         * @return The matching waiter options.
+         */
+        static Options fromContract(const Contract::Options& options);
+    };
+
+  private:
+    /// A transaction being waited for.
+    struct Pending {
+      std::string hash;                                 ///< The transaction hash.
+      std::promise<json> promise;                       ///< Resolved with the receipt or an error.
+      unsigned int confirmations;                       ///< Blocks required to confirm.
+      std::chrono::steady_clock::time_point deadline;   ///< When to give up.
+      bool checked = false;                             ///< Whether it was polled at least once.
+      bool hasStart = false;                            ///< Whether startBlock is known.
+      uint64_t startBlock = 0;                          ///< Head when it was added.
+      json receipt;                                     ///< The receipt, once found. `null` before that.
+      uint64_t receiptBlock = 0;                        ///< The block that included the transaction.
+    };
+
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    HeadTracker& _heads;                        ///< The head tracker that drives the polling.
+    Options _options;                           ///< The default options.
+
+    std::mutex _lock;                           ///< Mutex for everything below.
+    std::condition_variable _wake;              ///< Wakes the worker up.
+    std::list<Pending> _pending;                ///< Transactions being waited for.
+    bool _haveHead = false;                     ///< Whether a head was seen yet.
+    uint64_t _head = 0;                         ///< The latest head number.
+    bool _newHead = false;                      ///< Whether a head arrived since the last poll.
+    bool _newPending = false;                   ///< Whether transactions were added since the last poll.
+    std::vector<std::string> _orphaned;         ///< Hashes of blocks dropped by reorgs since the last poll.
+    bool _stop = false;                         ///< Tells the worker to stop.
+    uint64_t _listenerId = 0;                   ///< Id of the head listener, or 0 if not listening yet.
+    std::thread _worker;                        ///< Thread that polls the receipts.
+
+    /// Poll and resolve pending transactions until stopped. Runs on _worker.
+    void _run();
+
+    /// Fetch the receipts for a list of hashes. Missing ones and failed requests are `null`.
+    std::vector<json> _fetch(const std::vector<std::string>& hashes);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker that drives the polling.
+     */
+    ReceiptWaiter(const std::unique_ptr<Provider>& provider, HeadTracker& heads);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker that drives the polling.
+     * @param options The default options.
+     */
+    ReceiptWaiter(const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options);
+
+    /// Destructor. Transactions still pending are resolved with an error.
+    ~ReceiptWaiter();
+
+    ReceiptWaiter(const ReceiptWaiter&) = delete;
+    ReceiptWaiter& operator=(const ReceiptWaiter&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Wait for a transaction receipt, with the default options.
+     * @param txHash The transaction hash.
+     * @return `{"result": <receipt>}` once confirmed, or an `error` object
+     *         (with the `transactionHash`) if the hash is invalid or it timed out.
+     */
+    std::future<json> wait(const std::string& txHash);
+
+    /**
+     * Wait for a transaction receipt with a given number of confirmations.
+     * @param txHash The transaction hash.
+     * @param confirmations Blocks required to confirm, counting its own.
+     * @return Same as wait(const std::string&).
+     */
+    std::future<json> wait(const std::string& txHash, unsigned int confirmations);
+
+    /// Get the number of transactions being waited for.
+    std::size_t pending();
+};
+
+#endif  // RECEIPTWAITER_H
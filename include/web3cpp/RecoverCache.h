@@ -0,0 +1,96 @@
+#ifndef RECOVERCACHE_H
+#define RECOVERCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/FixedHash.h>
+#include <web3cpp/devcrypto/Common.h>
+
+/**
+ * LRU cache of recovered signers, keyed by the signed hash and the
+ * signature. Recovering a public key is by far the most expensive part of
+ * checking a signature, and the same signed message is often checked more
+ * than once (e.g. an order seen again in every book update), so a hit
+ * skips the elliptic curve math altogether.
+ * Only successful recoveries should be stored.
+ */
+
+class RecoverCache {
+  public:
+    /// Options for the cache.
+    class Options {
+      public:
+        std::size_t maxEntries = 100000;  ///< Maximum number of entries. Defaults to 100000.
+    };
+
+    /// Cache statistics.
+    struct Stats {
+      uint64_t hits = 0;        ///< Lookups that found an address.
+      uint64_t misses = 0;      ///< Lookups that didn't.
+      uint64_t evictions = 0;   ///< Entries dropped to stay within Options::maxEntries.
+      std::size_t entries = 0;  ///< Entries currently stored.
+    };
+
+  private:
+    using Key = dev::FixedHash<32 + 65>;  ///< The hash followed by the signature.
+
+    /// A cached address.
+    struct Entry {
+      Key key;                ///< The key, also stored in _index.
+      dev::Address address;   ///< The recovered address.
+    };
+
+    Options _options;                                                       ///< The cache options.
+    mutable std::mutex _lock;                                               ///< Mutex for everything below.
+    std::list<Entry> _entries;                                              ///< Entries, most recently used first.
+    std::unordered_map<Key, std::list<Entry>::iterator, Key::hash> _index;  ///< Entries by key.
+    Stats _stats;                                                           ///< Cache statistics.
+
+    /// Build the key for a hash and a signature.
+    static Key _key(const dev::h256& hash, const dev::Signature& signature);
+
+  public:
+    /// Constructor. Uses the default options.
+    RecoverCache();
+
+    /**
+     * Constructor.
+     * @param options The cache options.
+     */
+    RecoverCache(Options options);
+
+    RecoverCache(const RecoverCache&) = delete;
+    RecoverCache& operator=(const RecoverCache&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Look up the signer of a hash.
+     * @param hash The signed hash.
+     * @param signature The signature (r + s + v).
+     * @return The address, or an empty optional if it isn't cached.
+     */
+    std::optional<dev::Address> get(const dev::h256& hash, const dev::Signature& signature);
+
+    /**
+     * Store the signer of a hash, dropping the least recently used entry if full.
+     * @param hash The signed hash.
+     * @param signature The signature (r + s + v).
+     * @param address The address recovered from them.
+     */
+    void put(const dev::h256& hash, const dev::Signature& signature, const dev::Address& address);
+
+    /// Drop every entry.
+    void clear();
+
+    /// Get the cache statistics.
+    Stats stats() const;
+};
+
+#endif  // RECOVERCACHE_H
@@ -0,0 +1,155 @@
+#ifndef REPLACER_H
+#define REPLACER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/HeadTracker.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/Signer.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Fee bumper for stuck transactions.
+ * Tracked transactions are checked together once per new head reported by
+ * a HeadTracker: the nonces of their senders and the receipts of every
+ * version sent are read with one batched request each. A transaction that
+ * stays pending for Options::stuckBlocks blocks is signed again with the
+ * same nonce and both fees raised by Options::bumpPercent (nodes require at
+ * least 10% to replace a pending transaction), and every replacement of a
+ * head is sent in one batched request.
+ * Once one of the versions is mined, the transaction is resolved with its
+ * receipt and hash. If the nonce was used by a transaction that isn't one
+ * of them, it's resolved with an error.
+ */
+
+class Replacer {
+  public:
+    /// Options for replacing.
+    class Options {
+      public:
+        unsigned int stuckBlocks = 3;       ///< New blocks a version may stay pending before it's replaced. Defaults to 3.
+        unsigned int bumpPercent = 12;      ///< Percentage both fees are raised by on each replacement, at least 10. Defaults to 12.
+        unsigned int maxBumps = 10;         ///< Maximum replacements per transaction. Defaults to 10.
+        dev::u256 maxFeePerGas = 0;         ///< Highest `maxFeePerGas` to replace with, or 0 to not limit. Defaults to 0.
+        unsigned int blockTimeout = 100;    ///< New blocks to wait for any version to be mined, or 0 to not limit. Defaults to 100.
+        std::size_t batchSize = 500;        ///< Maximum number of calls per batched request. Defaults to 500.
+    };
+
+    /// Replacer statistics.
+    struct Stats {
+      uint64_t tracked = 0;       ///< Transactions tracked.
+      uint64_t replacements = 0;  ///< Replacements accepted by the node.
+      uint64_t mined = 0;         ///< Transactions with a mined version.
+      uint64_t replaced = 0;      ///< Mined transactions whose mined version was a replacement.
+      uint64_t failed = 0;        ///< Transactions resolved with an error.
+    };
+
+  private:
+    /// A transaction being tracked. Only touched by the worker once added.
+    struct Pending {
+      dev::eth::TransactionBase tx;           ///< The latest version.
+      std::shared_ptr<const Signer> signer;   ///< The sender's signer.
+      uint64_t nonce = 0;                     ///< The transaction nonce.
+      std::vector<std::string> hashes;        ///< Hash of every version sent, oldest first.
+      std::promise<json> promise;             ///< Resolved once a version is mined, or with an error.
+      bool hasStart = false;                  ///< Whether startBlock and sentBlock are known.
+      uint64_t startBlock = 0;                ///< Head when it was tracked.
+      uint64_t sentBlock = 0;                 ///< Head when the latest version was sent.
+      unsigned int bumps = 0;                 ///< Replacements the node accepted.
+      bool capped = false;                    ///< Whether Options::maxFeePerGas stops any more replacements.
+    };
+
+    const std::unique_ptr<Provider>& _provider; ///< Pointer to the provider used for the requests.
+    HeadTracker& _heads;                        ///< The head tracker that drives the checks.
+    Options _options;                           ///< The replacer options.
+
+    std::mutex _lock;                           ///< Mutex for everything below.
+    std::condition_variable _wake;              ///< Wakes the worker up.
+    std::list<Pending> _pending;                ///< Transactions being tracked.
+    bool _haveHead = false;                     ///< Whether a head was seen yet.
+    uint64_t _head = 0;                         ///< The latest head number.
+    dev::u256 _baseFee = 0;                     ///< Base fee of the latest head, or 0 if unknown.
+    bool _newHead = false;                      ///< Whether a head arrived since the last check.
+    bool _stop = false;                         ///< Tells the worker to stop.
+    uint64_t _listenerId = 0;                   ///< Id of the head listener, or 0 if not listening yet.
+    std::thread _worker;                        ///< Thread that checks and replaces.
+    Stats _stats;                               ///< Replacer statistics.
+
+    /// Check, replace and resolve tracked transactions until stopped. Runs on _worker.
+    void _run();
+
+    /// Send a list of batched requests. Failed requests get an `error` object.
+    std::vector<json> _send(std::vector<json> requests);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker that drives the checks.
+     */
+    Replacer(const std::unique_ptr<Provider>& provider, HeadTracker& heads);
+
+    /**
+     * Constructor.
+     * @param provider The provider to send the requests to.
+     * @param heads The head tracker that drives the checks.
+     * @param options The replacer options.
+     */
+    Replacer(const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options);
+
+    /// Destructor. Transactions still tracked are resolved with an error.
+    ~Replacer();
+
+    Replacer(const Replacer&) = delete;
+    Replacer& operator=(const Replacer&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Raise the fees of a transaction for a replacement, clearing its
+     * signature. Both fees go up by at least Options::bumpPercent, and
+     * `maxFeePerGas` also covers twice the given base fee on top of the
+     * new priority fee, so the replacement keeps up with a fee spike.
+     * @param tx The transaction. Left as is if it can't be bumped.
+     * @param baseFee The current base fee, or 0 if unknown.
+     * @return `true` if the fees were raised, `false` if the transaction
+     *         has no fees or Options::maxFeePerGas doesn't allow it.
+     */
+    bool bumpFees(dev::eth::TransactionBase& tx, const dev::u256& baseFee) const;
+
+    /**
+     * Track a transaction that was already signed and sent.
+     * @param tx The signed transaction.
+     * @param signer The sender's signer, used to sign the replacements.
+     * @return `{"result": <receipt>, "transactionHash", "replacements"}` with
+     *         the mined version, or an `error` object (with the
+     *         `transactionHash` of the latest version) if the transaction
+     *         isn't signed, its nonce was used by another transaction, or
+     *         no version was mined in Options::blockTimeout blocks.
+     */
+    std::future<json> track(const dev::eth::TransactionBase& tx, std::shared_ptr<const Signer> signer);
+
+    /// Overload of track() that takes the sender's private key.
+    std::future<json> track(const dev::eth::TransactionBase& tx, const std::string& privateKey);
+
+    /// Get the number of transactions being tracked.
+    std::size_t pending();
+
+    /// Get the replacer statistics.
+    Stats stats();
+};
+
+#endif  // REPLACER_H
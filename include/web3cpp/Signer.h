@@ -0,0 +1,80 @@
+#ifndef SIGNER_H
+#define SIGNER_H
+
+#include <optional>
+#include <string>
+
+#include <web3cpp/Error.h>
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/FixedHash.h>
+#include <web3cpp/devcrypto/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+
+/**
+ * Handle for signing with one private key.
+ * The key is parsed once and kept as a `dev::Secret`, which wipes its
+ * memory when destroyed, next to the public key and address derived from
+ * it. Signing then costs just the signature: no hex parsing and no EC
+ * point multiplication per call.
+ * A signer is immutable, so one instance can be shared by any number of
+ * threads (e.g. through a `std::shared_ptr<const Signer>`).
+ */
+
+class Signer {
+  private:
+    dev::Secret _secret;          ///< The private key.
+    dev::Public _public;          ///< The public key.
+    dev::Address _address;        ///< The address.
+    std::string _addressHex;      ///< The address, checksummed and "0x"-prefixed.
+
+  public:
+    /**
+     * Constructor.
+     * @param secret The private key. Must be valid, see fromPrivateKey().
+     */
+    explicit Signer(const dev::Secret& secret);
+
+    /**
+     * Create a signer from a hex private key.
+     * @param privateKey The private key, with or without "0x".
+     * @return The signer, or an empty optional if the key isn't a valid
+     *         32-byte secp256k1 key.
+     */
+    static std::optional<Signer> fromPrivateKey(const std::string& privateKey);
+
+    const dev::Secret& secret() const { return this->_secret; }       ///< Getter for the private key.
+    const dev::Public& publicKey() const { return this->_public; }    ///< Getter for the public key.
+    const dev::Address& address() const { return this->_address; }    ///< Getter for the address.
+    const std::string& addressHex() const { return this->_addressHex; } ///< Getter for the checksummed address.
+
+    /**
+     * Check if an address is this signer's, in any case.
+     * @param address The address, "0x"-prefixed.
+     * @return `true` if it is, `false` otherwise.
+     */
+    bool isAddress(const std::string& address) const;
+
+    /**
+     * Sign a hash.
+     * @param hash The hash to sign.
+     * @return The 65-byte signature (r + s + v).
+     */
+    dev::Signature signHash(const dev::h256& hash) const;
+
+    /**
+     * Sign data as an "Ethereum Signed Message" (EIP-191).
+     * @param data The data to sign.
+     * @return The hex-encoded signature (65 bytes: r + s + v).
+     */
+    std::string signMessage(const std::string& data) const;
+
+    /**
+     * Sign a transaction.
+     * @param tx The transaction, signed in place.
+     * @param error Error object. Set to "Transaction Sign Error" on failure.
+     * @return The RLP-encoded signed transaction as "0x"-prefixed hex, or empty on failure.
+     */
+    std::string signTransaction(dev::eth::TransactionBase& tx, Error &error) const;
+};
+
+#endif  // SIGNER_H
@@ -0,0 +1,198 @@
+#ifndef TXPIPELINE_H
+#define TXPIPELINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BoundedQueue.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/GasCache.h>
+#include <web3cpp/Signer.h>
+#include <web3cpp/Utils.h>
+#include <web3cpp/Wallet.h>
+#include <web3cpp/ethcore/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Staged pipeline for sending many transactions.
+ * Each transaction goes through four stages, each with its own worker
+ * threads and a bounded queue in front of it:
+ * - **build** reserves a nonce from the wallet's NonceManager and builds the skeleton;
+ * - **estimate** takes the gas from the wallet's GasCache if it has one,
+ *   estimating the rest of a batch in one batched request, and the fees
+ *   from the wallet's FeeOracle or a fee history fetched once and reused
+ *   for a while;
+ * - **sign** signs, on as many threads as there are cores by default;
+ * - **broadcast** sends `eth_sendRawTransaction` for whatever is waiting in
+ *   one batched request.
+ * submit() returns a Ticket with a future per stage, so callers can follow
+ * each transaction without a thread per transaction. Full queues block
+ * submit(), so memory stays bounded however fast transactions come in.
+ * Nonces of transactions that fail before reaching the node are released
+ * back to the NonceManager, and nonce errors from the node make the sender
+ * sync again.
+ */
+
+class TxPipeline {
+  public:
+    /// Options for the pipeline.
+    class Options {
+      public:
+        std::size_t buildWorkers = 1;          ///< Threads building transactions. Defaults to 1.
+        std::size_t estimateWorkers = 2;       ///< Threads estimating gas and fees. Defaults to 2.
+        std::size_t signWorkers = 0;           ///< Threads signing, or 0 for one per core. Defaults to 0.
+        std::size_t broadcastWorkers = 2;      ///< Threads sending transactions. Defaults to 2.
+        std::size_t queueCapacity = 4096;      ///< Capacity of the queue in front of each stage. Defaults to 4096.
+        std::size_t batchSize = 256;           ///< Maximum requests per batched request. Defaults to 256.
+        /// How long a fetched fee history is reused for, if the wallet has no
+        /// fee oracle. Defaults to 1s.
+        std::chrono::milliseconds feeRefresh{1000};
+    };
+
+    /// A transaction to send.
+    struct Request {
+      std::string from;                     ///< The sender address.
+      std::string privateKey;               ///< The sender's private key. Ignored if `signer` is set.
+      std::shared_ptr<const Signer> signer; ///< The sender's signer, which saves parsing the key for every transaction.
+      std::string to;                       ///< The destination address, or empty for a contract creation.
+      std::string data;                     ///< The encoded call data, if any.
+      BigNumber value;                      ///< The amount of Wei to transfer.
+      dev::eth::AccessList accessList;      ///< The access list, if any.
+      dev::eth::FeeLevel feeLevel = dev::eth::FeeLevel::Medium; ///< The priority fee level.
+      std::optional<dev::u256> gas;         ///< A gas estimate to use instead of estimating one.
+    };
+
+    /**
+     * Futures for each stage of a transaction. Once a stage fails, it and
+     * every later future resolve to `{"error": {"code", "message"}}`, with
+     * an Error code (e.g. 36 for a failed estimate).
+     */
+    struct Ticket {
+      /// The transaction object with its `nonce`, `gas` and fees, once estimated.
+      std::shared_future<json> estimated;
+      /// `{"signature", "hash"}` with the signed transaction and its hash, once signed.
+      std::shared_future<json> signedTx;
+      /// Same as Wallet::sendTransaction(): `{"signature", "result"}`
+      /// with the node's result, or `{"signature", "error"}` with its response.
+      std::shared_future<json> submitted;
+    };
+
+    /// Pipeline statistics.
+    struct Stats {
+      uint64_t submitted = 0;         ///< Transactions submitted.
+      uint64_t estimated = 0;         ///< Transactions estimated.
+      uint64_t estimateRequests = 0;  ///< `eth_estimateGas` calls made (cache misses).
+      uint64_t signedTxs = 0;         ///< Transactions signed.
+      uint64_t sent = 0;              ///< Transactions accepted by the node.
+      uint64_t batches = 0;           ///< Batched `eth_sendRawTransaction` requests made.
+      uint64_t failed = 0;            ///< Transactions that failed at any stage.
+    };
+
+  private:
+    /// A transaction going through the pipeline. Only one worker holds it at a time.
+    struct Job {
+      Request request;                        ///< The request.
+      std::optional<uint64_t> nonce;          ///< The reserved nonce.
+      dev::eth::TransactionSkeleton skeleton; ///< The built transaction.
+      dev::eth::TransactionBase tx;           ///< The estimated transaction.
+      std::string signedTx;                   ///< The signed transaction.
+      unsigned int resolved = 0;              ///< Number of promises already set, in stage order.
+      std::promise<json> estimatedPromise;    ///< Promise for Ticket::estimated.
+      std::promise<json> signedPromise;       ///< Promise for Ticket::signedTx.
+      std::promise<json> submittedPromise;    ///< Promise for Ticket::submitted.
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    Wallet& _wallet;                          ///< The wallet the nonces, estimates and fees come from.
+    Options _options;                         ///< The pipeline options.
+    std::shared_ptr<GasCache> _gasCache;      ///< The wallet's gas cache, if any.
+
+    BoundedQueue<JobPtr> _buildQueue;         ///< Transactions waiting to be built.
+    BoundedQueue<JobPtr> _estimateQueue;      ///< Transactions waiting to be estimated.
+    BoundedQueue<JobPtr> _signQueue;          ///< Transactions waiting to be signed.
+    BoundedQueue<JobPtr> _broadcastQueue;     ///< Transactions waiting to be sent.
+
+    std::vector<std::thread> _builders;       ///< The build workers.
+    std::vector<std::thread> _estimators;     ///< The estimate workers.
+    std::vector<std::thread> _signers;        ///< The sign workers.
+    std::vector<std::thread> _broadcasters;   ///< The broadcast workers.
+    std::mutex _closeLock;                    ///< Mutex for closing the pipeline once.
+
+    std::mutex _feeLock;                      ///< Mutex for the cached fee history.
+    json _feeHistory;                         ///< Last fee history fetched, if the wallet has no oracle.
+    std::chrono::steady_clock::time_point _feeTime; ///< When `_feeHistory` was fetched.
+
+    mutable std::mutex _statsLock;            ///< Mutex for _stats.
+    Stats _stats;                             ///< Pipeline statistics.
+
+    /// Worker loops of each stage.
+    void _runBuild();
+    void _runEstimate();
+    void _runSign();
+    void _runBroadcast();
+
+    /// Pop a batch from a queue: blocks for the first item, then takes what is waiting.
+    bool _popBatch(BoundedQueue<JobPtr>& queue, std::vector<JobPtr>& batch);
+
+    /// Get the fee history to price transactions with, fetching it if it's too old.
+    std::optional<json> _fees();
+
+    /// Fail a transaction from its current stage on, releasing its nonce if `release` is set.
+    void _fail(Job& job, const json& error, bool release);
+
+    /// Fail a transaction with an Error code.
+    void _fail(Job& job, uint64_t code, bool release);
+
+  public:
+    /**
+     * Constructor. Uses the default options.
+     * @param wallet The wallet to send with. Must outlive the pipeline.
+     */
+    TxPipeline(Wallet& wallet);
+
+    /**
+     * Constructor.
+     * @param wallet The wallet to send with. Must outlive the pipeline.
+     * @param options The pipeline options.
+     */
+    TxPipeline(Wallet& wallet, Options options);
+
+    /// Destructor. Closes the pipeline, finishing every submitted transaction.
+    ~TxPipeline();
+
+    TxPipeline(const TxPipeline&) = delete;
+    TxPipeline& operator=(const TxPipeline&) = delete;
+
+    const Options& getOptions() const { return this->_options; } ///< Getter for the options.
+
+    /**
+     * Submit a transaction. Blocks while the build queue is full.
+     * @param request The transaction to send.
+     * @return The futures for each stage. If the pipeline was closed, they
+     *         all resolve to a "Transaction Pipeline Closed" error.
+     */
+    Ticket submit(Request request);
+
+    /**
+     * Stop taking transactions and wait until every submitted one has gone
+     * through all the stages. Called by the destructor.
+     */
+    void close();
+
+    /// Get the pipeline statistics.
+    Stats stats() const;
+};
+
+#endif  // TXPIPELINE_H
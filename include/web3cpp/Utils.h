@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdint>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <mutex>
@@ -179,6 +180,61 @@ namespace Utils {
    */
   bool checkAddressChecksum(std::string address);
 
+  /**
+   * Check if a given string is a 2048-bit bloom filter, as found in the
+   * `logsBloom` field of blocks and receipts.
+   * @param bloom The string to be checked.
+   * @return `true` if the string is a bloom filter, `false` otherwise.
+   */
+  bool isBloom(const std::string& bloom);
+
+  /**
+   * Check if a value may be in a bloom filter. Blooms can give false
+   * positives but never false negatives, so `false` means the value is
+   * definitely not in it.
+   * @param bloom The bloom filter.
+   * @param value The value, in hex (e.g. an address or a topic).
+   *              It is hashed with Keccak-256 before testing.
+   * @return `true` if the value may be in the filter, `false` if it isn't
+   *         or either argument is invalid.
+   */
+  bool isInBloom(const std::string& bloom, const std::string& value);
+
+  /// Overload of isInBloom() that takes an already decoded filter and value.
+  bool isInBloom(const dev::eth::LogBloom& bloom, dev::bytesConstRef value);
+
+  /**
+   * Check if an address may be in a bloom filter as the emitter of a log.
+   * @param bloom The bloom filter.
+   * @param address The contract address.
+   * @return `true` if the address may be in the filter, `false` otherwise.
+   */
+  bool isContractAddressInBloom(const std::string& bloom, const std::string& address);
+
+  /**
+   * Check if an address may be in a bloom filter as an indexed event
+   * parameter (i.e. a topic with the address padded to 32 bytes).
+   * @param bloom The bloom filter.
+   * @param address The address.
+   * @return `true` if the address may be in the filter, `false` otherwise.
+   */
+  bool isUserEthereumAddressInBloom(const std::string& bloom, const std::string& address);
+
+  /**
+   * Check if a given string is a valid log topic (32 bytes in hex).
+   * @param topic The string to be checked.
+   * @return `true` if the string is a topic, `false` otherwise.
+   */
+  bool isTopic(const std::string& topic);
+
+  /**
+   * Check if a topic may be in a bloom filter.
+   * @param bloom The bloom filter.
+   * @param topic The topic.
+   * @return `true` if the topic may be in the filter, `false` otherwise.
+   */
+  bool isTopicInBloom(const std::string& bloom, const std::string& topic);
+
   /**
    * Convert any given value to hex. Does NOT prefix with "0x".
    * Number strings will be interpreted as numbers.
@@ -343,6 +399,22 @@ namespace Utils {
    */
   json toJson(dev::eth::AccessList accessList);
 
+  /**
+   * Process a range of items on several threads.
+   * The range is split into one contiguous share per thread. The calling
+   * thread takes the first share, and the call returns once all of them
+   * are done. The same count and threads always give the same shares.
+   * @param count The number of items.
+   * @param threads The number of threads, or 0 for one per core. Capped
+   *                at `count`.
+   * @param work Called once per share with the share's index and its
+   *             range of items, [begin, end).
+   */
+  void parallelFor(
+    std::size_t count, unsigned int threads,
+    const std::function<void(unsigned int, std::size_t, std::size_t)>& work
+  );
+
 };
 
 #endif  // UTILS_H
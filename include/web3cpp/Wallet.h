@@ -5,6 +5,7 @@
 #include <ctime>
 #include <future>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 #include <optional>
@@ -26,7 +27,13 @@
 #include <web3cpp/ethcore/TransactionBase.h>
 #include <web3cpp/Error.h>
 #include <web3cpp/Account.h>
+#include <web3cpp/Eth.h>
+#include <web3cpp/FeeOracle.h>
+#include <web3cpp/GasCache.h>
+#include <web3cpp/NonceManager.h>
 #include <web3cpp/Provider.h>
+#include <web3cpp/RecoverCache.h>
+#include <web3cpp/Signer.h>
 
 using json = nlohmann::ordered_json;
 
@@ -43,6 +50,7 @@ class Wallet {
     {
       dev::u256 gas = dev::Invalid256;
       json feeHistory = {};
+      std::optional<FeeOracle::Fees> fees;
       int errorCode = 0;
     };
 
@@ -51,16 +59,86 @@ class Wallet {
     Estimations fetchEstimations(json& txObj);
 
   public:
+    /// An account to load with loadAccounts().
+    struct AccountEntry {
+      std::string address;      ///< The address of the account.
+      std::string name;         ///< A custom human-readable name/label for the account.
+      std::string privateKey;   ///< The private key for the account.
+    };
+
+    /// Accounts loaded by loadAccounts().
+    struct LoadedAccounts {
+      std::vector<Account> accounts;        ///< The accounts whose key matched their address, in order.
+      std::vector<std::size_t> invalid;     ///< Indexes of the entries whose key didn't match their address.
+      std::vector<BigNumber> balances;      ///< Balance of each account in Wei, if requested. 0 for failed reads.
+      BlockTag block;                       ///< The block the nonces and balances were read at.
+    };
+
+    /// Result of setBalances() and addBalances().
+    struct FundResult {
+      std::vector<bool> ok;               ///< Whether the node accepted each call.
+      std::size_t failed = 0;             ///< Number of failed calls (including invalid addresses).
+      std::vector<BigNumber> balances;    ///< Balance of each address afterwards in Wei, if read back. 0 for failed reads.
+      BlockTag block;                     ///< The block the balances were read at, if read back.
+    };
+
+    /**
+     * Transactions signed by signTransactions(), as "0x"-prefixed hex
+     * strings stored back to back in one buffer.
+     */
+    struct SignedBatch {
+      std::string arena;                  ///< Every signed transaction, back to back.
+      std::vector<std::size_t> offsets;   ///< Start of each transaction in `arena`, plus the end of the last one.
+
+      /// Get the number of transactions.
+      std::size_t size() const { return (offsets.empty()) ? 0 : offsets.size() - 1; }
+
+      /// Get a signed transaction. Empty if it couldn't be signed. Only valid while the batch is.
+      std::string_view operator[](std::size_t i) const {
+        return std::string_view(arena).substr(offsets[i], offsets[i + 1] - offsets[i]);
+      }
+    };
+
     /**
      * Constructor.
      * @param _provider Pointer to the provider that will be used for blockchain operations.
      */
     Wallet(const std::unique_ptr<Provider>& _provider)
-      : provider(_provider)
+      : provider(_provider), nonces(std::make_shared<NonceManager>(_provider))
     {};
 
     const std::unique_ptr<Provider>& getProvider() const { return this->provider; }
 
+    /**
+     * Shared fee oracle used by estimateTransaction(). If set (and able to
+     * estimate), transactions take their fees from it instead of calling
+     * `eth_feeHistory` each. Opt-in, since it follows a HeadTracker that
+     * then polls the node on a thread of its own, e.g.
+     * `web3.wallet.feeOracle = std::make_shared<FeeOracle>(provider, web3.heads)`.
+     * Defaults to `nullptr`.
+     */
+    std::shared_ptr<FeeOracle> feeOracle;
+
+    /**
+     * Optional cache for gas estimates used by estimateTransaction(), so
+     * repeated calls of the same shape skip `eth_estimateGas`.
+     * Defaults to `nullptr` (every transaction is estimated).
+     */
+    std::shared_ptr<GasCache> gasCache;
+
+    /**
+     * Local nonce bookkeeping used by the buildTransaction() overload that
+     * doesn't take a nonce. Each sender is synced from the node once.
+     */
+    std::shared_ptr<NonceManager> nonces;
+
+    /**
+     * Optional cache of recovered signers used by ecRecover(), so a
+     * signature checked again skips the recovery.
+     * Defaults to `nullptr` (every signature is recovered).
+     */
+    std::shared_ptr<RecoverCache> recoverCache;
+
     /**
      * Generate a new account from a seed phrase.
      * The generated account is NOT stored internally; state management is external.
@@ -80,11 +158,64 @@ class Wallet {
      * @param address The address of the account (will be converted to lowercase).
      * @param name A custom human-readable name/label for the account.
      * @param privateKey The private key for the account.
+     * @param nonce (optional) The account's nonce, if known. Otherwise it's
+     *              requested the first time Account::nonce() is called.
      * @return An Account object with the provided details.
      */
     std::optional<Account> getAccount(
         std::string address, std::string name,
-        std::string privateKey, uint64_t nonce
+        std::string privateKey, std::optional<uint64_t> nonce = std::nullopt
+    );
+
+    /**
+     * Overload of getAccount() that takes a Signer, so the key isn't parsed
+     * and the address isn't derived again.
+     * @param signer The signer for the account's private key.
+     */
+    std::optional<Account> getAccount(
+        std::string address, std::string name,
+        const Signer& signer, std::optional<uint64_t> nonce = std::nullopt
+    );
+
+    /**
+     * Load many existing accounts at once. Keys are checked against their
+     * addresses like getAccount(), then every nonce (and balance, if asked)
+     * is read at the same block with batched requests, so a large set of
+     * accounts costs a few round-trips instead of one per account.
+     * The accounts are NOT stored internally; state management is external.
+     * @param entries The accounts to load.
+     * @param error Error object for error reporting. Set to "Invalid RPC Response"
+     *              if any read failed. Accounts whose nonce couldn't be read
+     *              request it when first asked, like getAccount() without a nonce.
+     * @param withBalances (optional) If enabled, reads the balances too. Defaults to false.
+     * @param options (optional) The batching options.
+     * @return The loaded accounts.
+     */
+    LoadedAccounts loadAccounts(
+      const std::vector<AccountEntry>& entries, Error &error,
+      bool withBalances = false, Eth::BulkOptions options = {}
+    );
+
+    /**
+     * Set the balance of many addresses at once (Anvil only).
+     * `anvil_setBalance` calls are sent as JSON-RPC batches of
+     * BulkOptions::batchSize, with up to BulkOptions::parallelism batches
+     * in flight, instead of two requests per address like Account::setBalance().
+     * @param balances The addresses and their new balances in Wei.
+     * @param readBack (optional) If enabled, reads every balance back with
+     *                 batched requests once all of them were set. Defaults to false.
+     * @param options (optional) The batching options.
+     * @return The result of each call, in the same order as the addresses.
+     */
+    std::future<FundResult> setBalances(
+      const std::vector<std::pair<std::string, BigNumber>>& balances,
+      bool readBack = false, Eth::BulkOptions options = {}
+    );
+
+    /// Same as setBalances(), but adds to the balances with `anvil_addBalance`.
+    std::future<FundResult> addBalances(
+      const std::vector<std::pair<std::string, BigNumber>>& amounts,
+      bool readBack = false, Eth::BulkOptions options = {}
     );
 
     /**
@@ -98,17 +229,36 @@ class Wallet {
       std::string dataToSign, std::string privateKey
     );
 
+    /// Overload of sign() that takes a Signer instead of a private key.
+    std::string sign(std::string dataToSign, const Signer& signer);
+
     /**
      * Recover the address of the account that signed a given data string.
      * Implements EIP-191 signature recovery.
      * @param signedData The original data that was signed.
      * @param signature The hex-encoded signature from sign().
-     * @return The address (checksummed) of the signing account, or empty if recovery fails.
+     * @return The address (lowercase) of the signing account, or empty if recovery fails.
      */
     std::string ecRecover(
       std::string signedData, std::string signature
     );
 
+    /**
+     * Recover the signers of many "Ethereum Signed Message"s at once.
+     * Messages are hashed straight from their bytes, signatures are
+     * recovered in parallel and, if `recoverCache` is set, looked up there
+     * first and stored there after.
+     * @param signedMessages Pairs of original data and hex-encoded signature
+     *                       (v as 0/1 or 27/28). Only read during the call.
+     * @param threads (optional) Number of threads, or 0 for one per core. Defaults to 0.
+     * @return The address of each signer, in order, or a zero address for
+     *         signatures that couldn't be parsed or recovered.
+     */
+    std::vector<dev::Address> ecRecover(
+      const std::vector<std::pair<std::string_view, std::string_view>>& signedMessages,
+      unsigned int threads = 0
+    );
+
     /**
      * Build a transaction skeleton ready to be signed.
      * This creates the transaction structure but does NOT sign it.
@@ -128,6 +278,18 @@ class Wallet {
       std::string dataHex = "", BigNumber value = {}, dev::eth::AccessList accessList = {}
     );
 
+    /**
+     * Overload of buildTransaction() that reserves the nonce from `nonces`.
+     * If the transaction is never sent, give the nonce back with
+     * `nonces->release()` so it's used again.
+     * @param error Error object for error reporting. Set to "Nonce Sync Error"
+     *              if the sender's nonce couldn't be fetched.
+     */
+    dev::eth::TransactionSkeleton buildTransaction(
+      std::string from, Error &error, std::string to = "",
+      std::string dataHex = "", BigNumber value = {}, dev::eth::AccessList accessList = {}
+    );
+
     /**
      * Estimates the gas fields of an transaction.
      * @param txObj The transaction skeleton from buildTransaction.
@@ -159,6 +321,35 @@ class Wallet {
       dev::eth::TransactionBase& txObj, std::string privateKey, Error &error
     );
 
+    /// Overload of signTransaction() that takes a Signer instead of a private key.
+    std::string signTransaction(
+      dev::eth::TransactionBase& txObj, const Signer& signer, Error &error
+    );
+
+    /**
+     * Sign many transactions from the same sender across threads.
+     * The key is parsed once, each thread encodes its share into a buffer
+     * of its own, and the hex of every transaction is then written into
+     * one arena allocated at its final size.
+     * @param txs The transactions from estimateTransaction(). Signed in place.
+     * @param privateKey The private key of the transactions' sender.
+     * @param error Error object for error reporting. Set to "Transaction Sign Error"
+     *              if the key is invalid or any transaction couldn't be signed.
+     * @param threads (optional) The number of threads, or 0 for one per core. Defaults to 0.
+     * @return The signed transactions, in the same order. Those that couldn't
+     *         be signed are empty.
+     */
+    SignedBatch signTransactions(
+      std::vector<dev::eth::TransactionBase>& txs, std::string privateKey,
+      Error &error, unsigned int threads = 0
+    );
+
+    /// Overload of signTransactions() that takes a Signer instead of a private key.
+    SignedBatch signTransactions(
+      std::vector<dev::eth::TransactionBase>& txs, const Signer& signer,
+      Error &error, unsigned int threads = 0
+    );
+
     /**
      * Broadcast a signed transaction to the blockchain.
      * @param signedTx The RLP-encoded signed transaction from signTransaction().
@@ -6,7 +6,9 @@
 #include <nlohmann/json.hpp>
 
 #include <web3cpp/Eth.h>
+#include <web3cpp/HeadTracker.h>
 #include <web3cpp/Provider.h>
+#include <web3cpp/ReceiptWaiter.h>
 #include <web3cpp/Utils.h>
 #include <web3cpp/Wallet.h>
 #include <web3cpp/Account.h>
@@ -36,11 +38,16 @@ class Web3 {
     /// Constructor overload that uses a custom Provider.
     Web3(Provider provider);
 
+    /// Destructor. Detaches `eth.cache`, `eth.blockCache` and `wallet.feeOracle` from `heads` before they're destroyed.
+    ~Web3();
+
     /// Constructor overload that uses both custom Provider & custom Path.
 
     std::string version;  ///< Current version of the library.
     Wallet wallet;        ///< Object for accessing the wallet.
     Eth eth;              ///< Object for accessing functions from the Eth class.
+    HeadTracker heads;    ///< Shared follower of the chain head. Starts with its first listener.
+    ReceiptWaiter receipts; ///< Shared waiter for transaction receipts, driven by `heads`.
 
     /**
      * Getter for the library provider.
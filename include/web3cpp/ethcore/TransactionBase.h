@@ -140,6 +140,12 @@ public:
     /// @param _m base fee multiplier
     void setFees(const json& _f, uint64_t _m = BASE_FEE_MULTIPLIER);
 
+    /// Sets maxFeePerGas to _baseFee * _m + _priorityFee. Clears the signature.
+    /// @param _baseFee base fee of the next block
+    /// @param _priorityFee max priority fee per gas
+    /// @param _m base fee multiplier
+    void setFees(u256 const& _baseFee, u256 const& _priorityFee, uint64_t _m = BASE_FEE_MULTIPLIER);
+
     /// @returns the total gas to convert, paid for from sender's account. Any unused gas gets refunded once the contract is ended.
     u256 gasLimit() const { return m_gasLimit; }
 
@@ -6,21 +6,36 @@
 Account::Account(
   const std::string& __address, const std::string& __name,
   const std::string& __privateKey, const std::unique_ptr<Provider>& __provider,
-  uint64_t __nonce
-) : _address(__address), _name(__name), _privateKey(__privateKey), provider(__provider)
-{
+  std::optional<uint64_t> __nonce
+) : _address(__address), _name(__name), _privateKey(__privateKey), _nonce(__nonce), provider(__provider)
+{}
+
+uint64_t Account::nonce() const {
+  std::scoped_lock lock(this->_nonceLock);
+  if (this->_nonce) return *this->_nonce;
   Error error;
-  if (!__nonce)
-  {
-      std::string nonceRequest = Net::HTTPRequest(
-        this->provider, Net::RequestTypes::POST,
-        RPC::eth_getTransactionCount(_address, "latest", error).dump()
-      );
-      json nonceJson = json::parse(nonceRequest);
-      _nonce = boost::lexical_cast<HexTo<uint64_t>>(nonceJson["result"].get<std::string>());
-      return;
+  json request = RPC::eth_getTransactionCount(this->_address, BlockTag::latest(), error);
+  if (error.getCode() != 0) return 0;
+  try {
+    json nonceJson = json::parse(Net::HTTPRequest(this->provider, Net::RequestTypes::POST, request.dump()));
+    std::optional<Quantity> count = Quantity::fromHex(nonceJson["result"].get<std::string>());
+    if (!count) return 0;
+    this->_nonce = static_cast<uint64_t>(count->value());
+  } catch (std::exception &e) {
+    // Not cached, so the next call tries again.
+    return 0;
   }
-  _nonce = __nonce;
+  return *this->_nonce;
+}
+
+std::optional<uint64_t> Account::knownNonce() const {
+  std::scoped_lock lock(this->_nonceLock);
+  return this->_nonce;
+}
+
+void Account::setNonce(uint64_t nonce) {
+  std::scoped_lock lock(this->_nonceLock);
+  this->_nonce = nonce;
 }
 
 std::future<BigNumber> Account::balance() const {
@@ -29,7 +44,7 @@ std::future<BigNumber> Account::balance() const {
     BigNumber ret;
     std::string balanceRequestStr = Net::HTTPRequest(
       this->provider, Net::RequestTypes::POST,
-      RPC::eth_getBalance(this->_address, "latest", error).dump()
+      RPC::eth_getBalance(this->_address, BlockTag::latest(), error).dump()
     );
     if (error.getCode() != 0) {
       std::cout << "Error on getting balance for account " << this->_address
@@ -58,7 +73,7 @@ std::future<BigNumber> Account::addBalance(BigNumber amount) const
     }
     std::string balanceRequestStr = Net::HTTPRequest(
       this->provider, Net::RequestTypes::POST,
-      RPC::eth_getBalance(_address, "latest", error).dump()
+      RPC::eth_getBalance(_address, BlockTag::latest(), error).dump()
     );
     if (error.getCode() != 0) {
       std::cout << "Error on getting balance for account " << _address
@@ -87,7 +102,7 @@ std::future<BigNumber> Account::setBalance(BigNumber amount) const
     }
     std::string balanceRequestStr = Net::HTTPRequest(
       this->provider, Net::RequestTypes::POST,
-      RPC::eth_getBalance(this->_address, "latest", error).dump()
+      RPC::eth_getBalance(this->_address, BlockTag::latest(), error).dump()
     );
     if (error.getCode() != 0) {
       std::cout << "Error on getting balance for account " << this->_address
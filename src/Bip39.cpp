@@ -1,5 +1,7 @@
 #include <web3cpp/Bip39.h>
 
+#include <web3cpp/Utils.h>
+
 bip3x::Bip39Mnemonic::MnemonicResult BIP39::createNewMnemonic() {
   return bip3x::Bip39Mnemonic::generate();
 }
@@ -19,16 +21,42 @@ bool BIP39::wordExists(std::string word) {
 }
 
 std::vector<std::pair<std::string,std::string>> BIP39::generateAccountsFromSeed(
-  std::string &seed, std::string derivPath, int64_t index
+  std::string &seed, std::string derivPath, int64_t index, int64_t count
 ) {
   std::vector<std::pair<std::string,std::string>> ret;
-  for (int64_t i = 0; i < 10; ++i, ++index) {
-    std::string address;
-    std::string deriv = derivPath + boost::lexical_cast<std::string>(index);
-    bip3x::HDKey rootKey = BIP39::createKey(seed, deriv);
-    dev::KeyPair k(dev::Secret::fromBip3x(rootKey.privateKey));
-    address += "0x" + k.address().hex();
-    ret.push_back(std::make_pair(address, deriv));
+  if (count <= 0) return ret;
+  AccountDeriver deriver(seed, derivPath);
+  for (DerivedAccount& acc : deriver.derive(static_cast<uint32_t>(index), static_cast<uint32_t>(count))) {
+    std::string deriv = deriver.path() + "/" + boost::lexical_cast<std::string>(acc.index);
+    ret.push_back(std::make_pair(std::move(acc.address), deriv));
   }
   return ret;
 }
+
+BIP39::AccountDeriver::AccountDeriver(const std::string& phrase, std::string derivPath) {
+  while (derivPath.size() > 1 && derivPath.back() == '/') derivPath.pop_back();
+  this->_path = derivPath;
+  bip3x::bytes_64 seed = bip3x::HDKeyEncoder::makeBip39Seed(phrase);
+  this->_parent = bip3x::HDKeyEncoder::makeBip32RootKey(seed);
+  bip3x::HDKeyEncoder::makeExtendedKey(this->_parent, derivPath);
+}
+
+BIP39::DerivedAccount BIP39::AccountDeriver::derive(uint32_t index) const {
+  // Paths are walked from the key they're applied to, skipping "m".
+  bip3x::HDKey key = this->_parent;
+  bip3x::HDKeyEncoder::makeExtendedKey(key, "m/" + boost::lexical_cast<std::string>(index));
+  DerivedAccount ret{index, "", dev::Secret::fromBip3x(key.privateKey)};
+  ret.address = "0x" + dev::toAddress(dev::toPublic(ret.secret)).hex();
+  return ret;
+}
+
+std::vector<BIP39::DerivedAccount> BIP39::AccountDeriver::derive(
+  uint32_t start, uint32_t count, unsigned int threads
+) const {
+  std::vector<DerivedAccount> ret(count);
+  // Each thread derives a contiguous share from its own copy of the parent.
+  Utils::parallelFor(count, threads, [&](unsigned int, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) ret[i] = this->derive(start + static_cast<uint32_t>(i));
+  });
+  return ret;
+}
@@ -0,0 +1,77 @@
+#include <web3cpp/BlockCache.h>
+
+BlockCache::BlockCache(HeadTracker& heads) : BlockCache(heads, Options()) {}
+
+BlockCache::BlockCache(HeadTracker& heads, Options options)
+  : _heads(heads), _options(options) {}
+
+BlockCache::~BlockCache() {
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    listenerId = this->_listenerId;
+    this->_listenerId = 0;
+  }
+  if (listenerId != 0) this->_heads.unsubscribe(listenerId);
+}
+
+void BlockCache::_listen() {
+  {
+    std::scoped_lock lock(this->_lock);
+    if (this->_listenerId != 0) return;
+    this->_listenerId = UINT64_MAX;  // Reserved while subscribing
+  }
+  uint64_t id = this->_heads.subscribe([this](const HeadTracker::Event& event){
+    std::scoped_lock lock(this->_lock);
+    this->_head = event.head.number;
+    this->_epoch++;
+    if (!this->_entries.empty()) this->_stats.clears++;
+    this->_entries.clear();
+    this->_stats.entries = 0;
+  });
+  std::optional<HeadTracker::Header> head = this->_heads.head();
+  std::scoped_lock lock(this->_lock);
+  this->_listenerId = id;
+  if (head && !this->_head) this->_head = head->number;
+}
+
+std::optional<BlockCache::Pin> BlockCache::pin(const BlockTag& block) {
+  this->_listen();
+  std::scoped_lock lock(this->_lock);
+  if (!this->_head) return std::nullopt;
+  switch (block.kind()) {
+    case BlockTag::Kind::Latest: return Pin{BlockTag::number(*this->_head), this->_epoch};
+    case BlockTag::Kind::Number:
+    case BlockTag::Kind::Hash: return Pin{block, this->_epoch};
+    default: return std::nullopt;
+  }
+}
+
+std::optional<json> BlockCache::get(const std::string& key) {
+  std::scoped_lock lock(this->_lock);
+  auto it = this->_entries.find(key);
+  if (it == this->_entries.end()) {
+    this->_stats.misses++;
+    return std::nullopt;
+  }
+  this->_stats.hits++;
+  return it->second;
+}
+
+void BlockCache::put(const std::string& key, json value, const Pin& pin) {
+  std::scoped_lock lock(this->_lock);
+  if (pin.epoch != this->_epoch || this->_entries.size() >= this->_options.maxEntries) return;
+  this->_entries.insert_or_assign(key, std::move(value));
+  this->_stats.entries = this->_entries.size();
+}
+
+void BlockCache::clear() {
+  std::scoped_lock lock(this->_lock);
+  this->_entries.clear();
+  this->_stats.entries = 0;
+}
+
+BlockCache::Stats BlockCache::stats() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
@@ -0,0 +1,249 @@
+#include <web3cpp/BlockFetcher.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+struct BlockFetcher::Range {
+  uint64_t fromBlock;
+  uint64_t toBlock;
+  Options options;
+  std::mutex lock;
+  std::condition_variable cv;
+  uint64_t cursor;                          // First block not yet claimed by a worker.
+  bool exhausted = false;                   // Whether every block was claimed.
+  uint64_t nextDeliver;                     // Next block to hand to the consumer.
+  std::map<uint64_t, Block> reorder;        // Fetched blocks waiting for the ones before them.
+  std::mutex deliverLock;                   // Serializes delivery to the queue.
+  bool stop = false;                        // Set on error or when the consumer goes away.
+  json error;                               // First error found.
+  bool blockReceipts = true;                // Whether the node supports eth_getBlockReceipts.
+};
+
+namespace {
+  /// Get the hashes of every transaction in a block, be it hashes or full objects.
+  std::vector<std::string> transactionHashes(const json& block) {
+    std::vector<std::string> ret;
+    auto txs = block.find("transactions");
+    if (txs == block.end() || !txs->is_array()) return ret;
+    for (const json& tx : *txs) {
+      if (tx.is_string()) ret.push_back(tx.get<std::string>());
+      else if (tx.is_object() && tx.contains("hash")) ret.push_back(tx["hash"].get<std::string>());
+    }
+    return ret;
+  }
+}
+
+BlockFetcher::BlockFetcher(
+  const std::unique_ptr<Provider>& provider, uint64_t fromBlock, uint64_t toBlock
+) : BlockFetcher(provider, fromBlock, toBlock, Options()) {}
+
+BlockFetcher::BlockFetcher(
+  const std::unique_ptr<Provider>& provider, uint64_t fromBlock, uint64_t toBlock,
+  Options options
+) : _range(std::make_unique<Range>()),
+    _queue((options.batchSize) ? options.batchSize : 1) {
+  if (options.batchSize == 0) options.batchSize = 1;
+  if (options.parallelism == 0) options.parallelism = 1;
+  options.bufferSize = std::max(options.bufferSize, options.batchSize);
+  this->_range->fromBlock = fromBlock;
+  this->_range->toBlock = toBlock;
+  this->_range->options = options;
+  this->_range->cursor = fromBlock;
+  this->_range->nextDeliver = fromBlock;
+  this->_fetcher = std::thread([this, &provider]{ this->_run(provider); });
+}
+
+BlockFetcher::~BlockFetcher() {
+  this->_queue.close();
+  if (this->_fetcher.joinable()) this->_fetcher.join();
+}
+
+bool BlockFetcher::next(Block& out) {
+  return this->_queue.pop(out);
+}
+
+const json& BlockFetcher::response() {
+  this->_queue.close();
+  if (this->_fetcher.joinable()) this->_fetcher.join();
+  return this->_response;
+}
+
+void BlockFetcher::_run(const std::unique_ptr<Provider>& provider) {
+  Range& r = *this->_range;
+  const Options& opts = r.options;
+
+  if (r.fromBlock > r.toBlock) {
+    this->_response["error"]["message"] = "fromBlock is after toBlock";
+    this->_queue.close();
+    return;
+  }
+
+  // Fetch a batch of blocks (and their receipts) in one or two round trips.
+  // Returns false and sets `error` if any block in the batch failed.
+  auto fetchBatch = [&](uint64_t from, uint64_t to, std::vector<Block>& out, json& error) {
+    bool blockReceipts;
+    {
+      std::scoped_lock lock(r.lock);
+      blockReceipts = r.blockReceipts;
+    }
+    std::vector<json> requests;
+    for (uint64_t n = from; n <= to; n++) {
+      requests.push_back(RPC::eth_getBlockByNumber(BlockTag::number(n), opts.fullTransactions));
+      if (opts.receipts && blockReceipts) {
+        requests.push_back(RPC::eth_getBlockReceipts(BlockTag::number(n)));
+      }
+    }
+    std::vector<json> responses = Net::HTTPBatchRequest(provider, std::move(requests));
+
+    std::size_t perBlock = (opts.receipts && blockReceipts) ? 2 : 1;
+    // Method not found: switch to per-transaction receipts for the rest of the range.
+    if (perBlock == 2 && responses[1].contains("error") && responses[1]["error"].is_object()
+      && responses[1]["error"].value("code", 0) == -32601) {
+      std::scoped_lock lock(r.lock);
+      r.blockReceipts = blockReceipts = false;
+    }
+    out.clear();
+    for (uint64_t n = from; n <= to; n++) {
+      std::size_t idx = (n - from) * perBlock;
+      json& blockRes = responses[idx];
+      if (blockRes.contains("error")) { error = blockRes["error"]; return false; }
+      if (!blockRes.contains("result") || blockRes["result"].is_null()) {
+        error["message"] = "Block not found";
+        return false;
+      }
+      Block block;
+      block.number = n;
+      block.block = std::move(blockRes["result"]);
+      if (perBlock == 2 && blockReceipts) {
+        json& receiptsRes = responses[idx + 1];
+        if (receiptsRes.contains("error")) { error = receiptsRes["error"]; return false; }
+        block.receipts = std::move(receiptsRes["result"]);
+      }
+      out.push_back(std::move(block));
+    }
+
+    if (opts.receipts && !blockReceipts) {
+      std::vector<json> receiptReqs;
+      std::vector<std::size_t> counts;
+      for (const Block& block : out) {
+        std::vector<std::string> hashes = transactionHashes(block.block);
+        counts.push_back(hashes.size());
+        for (const std::string& hash : hashes) {
+          Error err;
+          receiptReqs.push_back(RPC::eth_getTransactionReceipt(hash, err));
+        }
+      }
+      std::vector<json> receipts = Net::HTTPBatchRequest(provider, std::move(receiptReqs));
+      std::size_t idx = 0;
+      for (std::size_t i = 0; i < out.size(); i++) {
+        out[i].receipts = json::array();
+        for (std::size_t j = 0; j < counts[i]; j++, idx++) {
+          if (receipts[idx].contains("error")) { error = receipts[idx]["error"]; return false; }
+          out[i].receipts.push_back(std::move(receipts[idx]["result"]));
+        }
+      }
+    }
+    return true;
+  };
+
+  // Move every block that is next in line from the reorder buffer to the queue.
+  auto deliver = [&]{
+    std::scoped_lock deliverLock(r.deliverLock);
+    while (true) {
+      Block block;
+      {
+        std::scoped_lock lock(r.lock);
+        if (r.stop || r.reorder.empty() || r.reorder.begin()->first != r.nextDeliver) return;
+        block = std::move(r.reorder.begin()->second);
+        r.reorder.erase(r.reorder.begin());
+      }
+      bool pushed = this->_queue.push(std::move(block));
+      {
+        std::scoped_lock lock(r.lock);
+        if (!pushed) r.stop = true; else r.nextDeliver++;
+      }
+      r.cv.notify_all();
+    }
+  };
+
+  auto worker = [&]{
+    while (true) {
+      uint64_t from, to;
+      {
+        std::unique_lock lock(r.lock);
+        // Don't claim past the window, so a slow consumer stops the fetch.
+        r.cv.wait(lock, [&]{
+          return r.stop || r.exhausted || r.cursor - r.nextDeliver < opts.bufferSize;
+        });
+        if (r.stop || r.exhausted) return;
+        from = r.cursor;
+        to = (r.toBlock - from < opts.batchSize) ? r.toBlock : from + opts.batchSize - 1;
+        if (to == r.toBlock) r.exhausted = true; else r.cursor = to + 1;
+      }
+      std::vector<Block> blocks;
+      json error;
+      bool ok = false;
+      for (unsigned int attempt = 0; attempt <= opts.maxRetries && !ok; attempt++) {
+        {
+          std::scoped_lock lock(r.lock);
+          if (r.stop) return;
+        }
+        error = json::object();
+        try {
+          ok = fetchBatch(from, to, blocks, error);
+        } catch (std::exception &e) {
+          error["message"] = e.what();
+        }
+        if (!ok && attempt < opts.maxRetries) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100 << std::min(attempt, 5u)));
+        }
+      }
+      {
+        std::scoped_lock lock(r.lock);
+        if (!ok) {
+          if (!r.stop) {
+            // The node's error can be anything, so the range goes on a copy.
+            json wrapped = (error.is_object()) ? error : json::object();
+            if (!wrapped.contains("message")) {
+              wrapped["message"] = (error.is_string()) ? error.get<std::string>() : "Failed to fetch blocks";
+            }
+            wrapped["fromBlock"] = Quantity(from).hex();
+            wrapped["toBlock"] = Quantity(to).hex();
+            r.stop = true;
+            r.error = std::move(wrapped);
+          }
+        } else {
+          for (Block& block : blocks) r.reorder.emplace(block.number, std::move(block));
+        }
+      }
+      r.cv.notify_all();
+      if (!ok) return;
+      deliver();
+    }
+  };
+
+  std::vector<std::future<void>> workers;
+  for (std::size_t i = 0; i < opts.parallelism; i++) {
+    workers.push_back(std::async(std::launch::async, worker));
+  }
+  for (std::future<void>& w : workers) w.get();
+
+  {
+    std::scoped_lock lock(r.lock);
+    if (!r.error.is_null()) {
+      this->_response["error"] = r.error;
+    } else {
+      this->_response["result"] = r.nextDeliver - r.fromBlock;
+    }
+  }
+  this->_queue.close();
+}
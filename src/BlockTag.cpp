@@ -0,0 +1,97 @@
+#include <limits>
+
+#include <web3cpp/BlockTag.h>
+
+std::optional<Quantity> Quantity::fromHex(const std::string& hex) {
+  std::size_t start = (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? 2 : 0;
+  if (hex.size() == start || hex.size() - start > 64) return std::nullopt;
+  BigNumber ret = 0;
+  for (std::size_t i = start; i < hex.size(); i++) {
+    char c = hex[i];
+    unsigned nibble;
+    if (c >= '0' && c <= '9') nibble = c - '0';
+    else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+    else return std::nullopt;
+    ret = (ret << 4) | nibble;
+  }
+  return Quantity(ret);
+}
+
+void Quantity::appendHex(std::string& out) const {
+  static const char* digits = "0123456789abcdef";
+  out += "0x";
+  if (_value == 0) { out += '0'; return; }
+  char buf[64];
+  std::size_t pos = sizeof(buf);
+  BigNumber v = _value;
+  while (v != 0) {
+    buf[--pos] = digits[static_cast<unsigned>(v & 0xf)];
+    v >>= 4;
+  }
+  out.append(buf + pos, sizeof(buf) - pos);
+}
+
+std::string Quantity::hex() const {
+  std::string ret;
+  appendHex(ret);
+  return ret;
+}
+
+std::optional<BlockTag> BlockTag::parse(const std::string& block) {
+  if (block == "latest") return BlockTag::latest();
+  if (block == "pending") return BlockTag::pending();
+  if (block == "safe") return BlockTag::safe();
+  if (block == "finalized") return BlockTag::finalized();
+  if (block == "earliest") return BlockTag::earliest();
+  if (block.size() >= 2 && block[0] == '0' && (block[1] == 'x' || block[1] == 'X')) {
+    if (block.size() == 66) {
+      try {
+        return BlockTag::hash(dev::h256(block));
+      } catch (std::exception &e) {
+        return std::nullopt;
+      }
+    }
+    std::optional<Quantity> q = Quantity::fromHex(block);
+    if (!q || q->value() > std::numeric_limits<uint64_t>::max()) return std::nullopt;
+    return BlockTag::number(static_cast<uint64_t>(q->value()));
+  }
+  if (!block.empty() && block.size() <= 20 &&
+    block.find_first_not_of("0123456789") == std::string::npos
+  ) {
+    BigNumber n(block);
+    if (n > std::numeric_limits<uint64_t>::max()) return std::nullopt;
+    return BlockTag::number(static_cast<uint64_t>(n));
+  }
+  return std::nullopt;
+}
+
+void BlockTag::appendJSON(std::string& out) const {
+  switch (_kind) {
+    case Kind::Latest: out += "\"latest\""; break;
+    case Kind::Pending: out += "\"pending\""; break;
+    case Kind::Safe: out += "\"safe\""; break;
+    case Kind::Finalized: out += "\"finalized\""; break;
+    case Kind::Earliest: out += "\"earliest\""; break;
+    case Kind::Number: out += '"'; Quantity(_number).appendHex(out); out += '"'; break;
+    case Kind::Hash: out += "{\"blockHash\":\"0x"; out += _hash.hex(); out += "\"}"; break;
+  }
+}
+
+json BlockTag::toJSON() const {
+  if (_kind == Kind::Hash) return {{"blockHash", "0x" + _hash.hex()}};
+  return toString();
+}
+
+std::string BlockTag::toString() const {
+  switch (_kind) {
+    case Kind::Latest: return "latest";
+    case Kind::Pending: return "pending";
+    case Kind::Safe: return "safe";
+    case Kind::Finalized: return "finalized";
+    case Kind::Earliest: return "earliest";
+    case Kind::Number: return Quantity(_number).hex();
+    case Kind::Hash: return "0x" + _hash.hex();
+  }
+  return "latest";
+}
@@ -40,7 +40,11 @@ const std::map<uint64_t, std::string> Error::codeMap = {
   {999, "Unknown Error"},
   {36, "Transaction Estimate Error"},
   {37, "Transaction Drop Error"},
-  {38, "Invalid Reward Percentiles"}
+  {38, "Invalid Reward Percentiles"},
+  {39, "Invalid RPC Response"},
+  {40, "Invalid Subscription Type"},
+  {41, "Nonce Sync Error"},
+  {42, "Transaction Pipeline Closed"}
 };
 
 void Error::setCode(uint64_t errorCode) {
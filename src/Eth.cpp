@@ -1,6 +1,118 @@
 #include "web3cpp/RPC.h"
 #include <web3cpp/Eth.h>
 
+#include <algorithm>
+
+namespace {
+  /// Wrap a cached result like a node response.
+  json cachedResponse(json result) {
+    return {{"jsonrpc", "2.0"}, {"id", 1}, {"result", std::move(result)}};
+  }
+
+  /// Get the block number from a mined transaction or receipt.
+  std::optional<uint64_t> minedBlock(const json& obj) {
+    if (!obj.is_object() || !obj.contains("blockNumber") || !obj["blockNumber"].is_string()) return std::nullopt;
+    std::optional<Quantity> number = Quantity::fromHex(obj["blockNumber"].get<std::string>());
+    if (!number) return std::nullopt;
+    return static_cast<uint64_t>(number->value());
+  }
+
+  /**
+   * Send a state read through a BlockCache, if there's one and the block
+   * can be pinned. Otherwise, send it as is.
+   * @param build Builds the request for a given block.
+   */
+  json blockCachedRequest(
+    const std::unique_ptr<Provider>& provider, const std::shared_ptr<BlockCache>& cache,
+    const std::string& method, json args, const BlockTag& block,
+    const std::function<json(const BlockTag&, Error&)>& build
+  ) {
+    json ret;
+    Error err;
+    std::optional<BlockCache::Pin> pin = (cache) ? cache->pin(block) : std::nullopt;
+    std::string rpcStr = build((pin) ? pin->block : block, err).dump();
+    if (err.getCode() != 0) {
+      ret["error"]["message"] = err.what();
+      return ret;
+    }
+    std::string key;
+    if (pin) {
+      args.push_back(pin->block.toJSON());
+      key = ImmutableCache::key(method, args);
+      if (std::optional<json> hit = cache->get(key)) return cachedResponse(std::move(*hit));
+    }
+    ret = json::parse(Net::HTTPRequest(provider, Net::RequestTypes::POST, rpcStr));
+    if (pin && ret.contains("result")) cache->put(key, ret["result"], *pin);
+    return ret;
+  }
+
+  /**
+   * Resolve a named tag to a block number, so batches sent at different
+   * times all read the same block. `pending` and `earliest` are kept as
+   * they are, and so is the tag if it can't be resolved.
+   */
+  BlockTag resolveBlock(const std::unique_ptr<Provider>& provider, const BlockTag& block) {
+    if (!block.isNamed() || block.kind() == BlockTag::Kind::Pending || block.kind() == BlockTag::Kind::Earliest) {
+      return block;
+    }
+    try {
+      json req = (block.kind() == BlockTag::Kind::Latest)
+        ? RPC::eth_blockNumber() : RPC::eth_getBlockByNumber(block, false);
+      json res = json::parse(Net::HTTPRequest(provider, Net::RequestTypes::POST, req.dump()));
+      if (!res.contains("result")) return block;
+      const json& number = (res["result"].is_object()) ? res["result"]["number"] : res["result"];
+      std::optional<Quantity> q = Quantity::fromHex(number.get<std::string>());
+      if (q) return BlockTag::number(static_cast<uint64_t>(q->value()));
+    } catch (std::exception &e) {}
+    return block;
+  }
+
+  /**
+   * Send numeric state reads as parallel JSON-RPC batches.
+   * @param count The number of reads.
+   * @param build Builds the request for a given read and block.
+   */
+  Eth::BulkResult bulkRead(
+    const std::unique_ptr<Provider>& provider, std::size_t count, const BlockTag& block,
+    Eth::BulkOptions options, const std::function<json(std::size_t, const BlockTag&, Error&)>& build
+  ) {
+    Eth::BulkResult ret;
+    ret.block = resolveBlock(provider, block);
+    ret.values.assign(count, 0);
+    ret.ok = Net::HTTPBulkRequest(provider, count, options.batchSize, options.parallelism,
+      [&](std::size_t i, Error& err){ return build(i, ret.block, err); },
+      [&](std::size_t i, json& res){
+        if (!res.contains("result") || !res["result"].is_string()) return false;
+        try {
+          ret.values[i] = Utils::toBN(res["result"].get<std::string>());
+          return true;
+        } catch (std::exception &e) {
+          return false;
+        }
+      }
+    );
+    ret.failed = std::count(ret.ok.begin(), ret.ok.end(), false);
+    return ret;
+  }
+
+  /**
+   * Cache a node response for a block, if it has a result.
+   * Hashes are cached for good, numbers depending on their finality.
+   */
+  void cacheForBlock(ImmutableCache& cache, const std::string& key, const json& res, const BlockTag& block) {
+    if (!res.contains("result") || res["result"].is_null()) return;
+    if (block.kind() == BlockTag::Kind::Hash) {
+      cache.put(key, res["result"]);
+    } else if (block.kind() == BlockTag::Kind::Number) {
+      // Blocks carry their own hash, anything else is taken as is.
+      const json& result = res["result"];
+      std::string hash = (result.is_object() && result.contains("hash") && result["hash"].is_string())
+        ? result["hash"].get<std::string>() : "";
+      cache.put(key, result, block.blockNumber(), hash);
+    }
+  }
+}
+
 std::future<json> Eth::getProtocolVersion() {
   return std::async([=]{
     return json::parse(Net::HTTPRequest(
@@ -74,12 +186,13 @@ std::future<json> Eth::getBlockNumber() {
 }
 
 std::future<json> Eth::getBalance(const std::string& address, const std::string& defaultBlock) {
+  if (defaultBlock.empty()) return getBalance(address, this->defaultBlock);
+  std::optional<BlockTag> block = BlockTag::parse(defaultBlock);
+  if (block) return getBalance(address, *block);
   return std::async([=]{
     json ret;
     Error err;
-    std::string rpcStr = RPC::eth_getBalance(address,
-      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
-    err).dump();
+    std::string rpcStr = RPC::eth_getBalance(address, defaultBlock, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
     } else {
@@ -91,17 +204,49 @@ std::future<json> Eth::getBalance(const std::string& address, const std::string&
   });
 }
 
+std::future<json> Eth::getBalance(const std::string& address, const BlockTag& defaultBlock) {
+  std::shared_ptr<BlockCache> cache = this->blockCache;
+  return std::async([=]{
+    return blockCachedRequest(
+      this->provider, cache, "eth_getBalance", json::array({address}), defaultBlock,
+      [&](const BlockTag& block, Error& err){ return RPC::eth_getBalance(address, block, err); }
+    );
+  });
+}
+
+std::future<Eth::BulkResult> Eth::getBalance(
+  const std::vector<std::string>& addresses, const BlockTag& defaultBlock
+) {
+  return getBalance(addresses, defaultBlock, BulkOptions());
+}
+
+std::future<Eth::BulkResult> Eth::getBalance(
+  const std::vector<std::string>& addresses, const BlockTag& defaultBlock, BulkOptions options
+) {
+  return std::async(std::launch::async, [=]{
+    return bulkRead(this->provider, addresses.size(), defaultBlock, options,
+      [&](std::size_t i, const BlockTag& block, Error& err){
+        return RPC::eth_getBalance(addresses[i], block, err);
+      }
+    );
+  });
+}
+
 std::future<json> Eth::getStorageAt(
   std::string address, std::string position, const std::string& defaultBlock
 ) {
-  if (position.substr(0, 2) != "0x" || position.substr(0, 2) != "0X") {
+  std::optional<Quantity> pos = Quantity::fromHex(position);
+  if (pos && defaultBlock.empty()) return getStorageAt(address, *pos, this->defaultBlock);
+  std::optional<BlockTag> block = BlockTag::parse(defaultBlock);
+  if (pos && block) return getStorageAt(address, *pos, *block);
+  if (position.substr(0, 2) != "0x" && position.substr(0, 2) != "0X") {
     position.insert(0, "0x");
   }
   return std::async([=]{
     json ret;
     Error err;
     std::string rpcStr = RPC::eth_getStorageAt(address, position,
-      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
+      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock.toString()),
     err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
@@ -122,13 +267,45 @@ std::future<json> Eth::getStorageAt(
   return getStorageAt(address, ss.str(), defaultBlock);
 }
 
+std::future<json> Eth::getStorageAt(
+  const std::string& address, const Quantity& position, const BlockTag& defaultBlock
+) {
+  std::shared_ptr<BlockCache> cache = this->blockCache;
+  return std::async([=]{
+    return blockCachedRequest(
+      this->provider, cache, "eth_getStorageAt", json::array({address, position.hex()}), defaultBlock,
+      [&](const BlockTag& block, Error& err){ return RPC::eth_getStorageAt(address, position, block, err); }
+    );
+  });
+}
+
+std::future<Eth::BulkResult> Eth::getStorageAt(
+  const std::vector<std::pair<std::string, Quantity>>& slots, const BlockTag& defaultBlock
+) {
+  return getStorageAt(slots, defaultBlock, BulkOptions());
+}
+
+std::future<Eth::BulkResult> Eth::getStorageAt(
+  const std::vector<std::pair<std::string, Quantity>>& slots, const BlockTag& defaultBlock,
+  BulkOptions options
+) {
+  return std::async(std::launch::async, [=]{
+    return bulkRead(this->provider, slots.size(), defaultBlock, options,
+      [&](std::size_t i, const BlockTag& block, Error& err){
+        return RPC::eth_getStorageAt(slots[i].first, slots[i].second, block, err);
+      }
+    );
+  });
+}
+
 std::future<json> Eth::getCode(const std::string& address, const std::string& defaultBlock) {
+  if (defaultBlock.empty()) return getCode(address, this->defaultBlock);
+  std::optional<BlockTag> block = BlockTag::parse(defaultBlock);
+  if (block) return getCode(address, *block);
   return std::async([=]{
     json ret;
     Error err;
-    std::string rpcStr = RPC::eth_getCode(address,
-      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
-    err).dump();
+    std::string rpcStr = RPC::eth_getCode(address, defaultBlock, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
     } else {
@@ -140,15 +317,69 @@ std::future<json> Eth::getCode(const std::string& address, const std::string& de
   });
 }
 
+std::future<json> Eth::getCode(const std::string& address, const BlockTag& defaultBlock) {
+  if (defaultBlock.isNamed()) {
+    std::shared_ptr<BlockCache> cache = this->blockCache;
+    return std::async([=]{
+      return blockCachedRequest(
+        this->provider, cache, "eth_getCode", json::array({address}), defaultBlock,
+        [&](const BlockTag& block, Error& err){ return RPC::eth_getCode(address, block, err); }
+      );
+    });
+  }
+  std::shared_ptr<ImmutableCache> cache = this->cache;
+  return std::async([=]{
+    json ret;
+    Error err;
+    std::string rpcStr = RPC::eth_getCode(address, defaultBlock, err).dump();
+    if (err.getCode() != 0) {
+      ret["error"]["message"] = err.what();
+      return ret;
+    }
+    std::string key;
+    if (cache) {
+      key = ImmutableCache::key("eth_getCode", json::array({address, defaultBlock.toJSON()}));
+      if (std::optional<json> hit = cache->get(key)) return cachedResponse(std::move(*hit));
+    }
+    ret = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, rpcStr
+    ));
+    if (cache) cacheForBlock(*cache, key, ret, defaultBlock);
+    return ret;
+  });
+}
+
+std::future<json> Eth::getBlock(const BlockTag& block, bool returnTransactionObjects) {
+  std::shared_ptr<ImmutableCache> cache = (block.isNamed()) ? nullptr : this->cache;
+  return std::async([=]{
+    std::string key;
+    if (cache) {
+      key = ImmutableCache::key("eth_getBlock", json::array({block.toJSON(), returnTransactionObjects}));
+      if (std::optional<json> hit = cache->get(key)) return cachedResponse(std::move(*hit));
+    }
+    std::string rpcStr = RPC::eth_getBlockByNumber(block, returnTransactionObjects).dump();
+    json ret = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, rpcStr
+    ));
+    if (cache) cacheForBlock(*cache, key, ret, block);
+    return ret;
+  });
+}
+
 std::future<json> Eth::getBlock(
   std::string blockHashOrBlockNumber, bool isHash, bool returnTransactionObjects
 ) {
   if (
-    blockHashOrBlockNumber.substr(0, 2) != "0x" ||
+    blockHashOrBlockNumber.substr(0, 2) != "0x" &&
     blockHashOrBlockNumber.substr(0, 2) != "0X"
   ) {
     blockHashOrBlockNumber.insert(0, "0x");
   }
+  // Same cache entries as the BlockTag overload.
+  std::optional<BlockTag> block = BlockTag::parse(blockHashOrBlockNumber);
+  if (block && !block->isNamed() && (block->kind() == BlockTag::Kind::Hash) == isHash) {
+    return getBlock(*block, returnTransactionObjects);
+  }
   return std::async([=]{
     json ret;
     Error err;
@@ -174,7 +405,7 @@ std::future<json> Eth::getBlockTransactionCount(
   std::string blockHashOrBlockNumber, bool isHash
 ) {
   if (
-    blockHashOrBlockNumber.substr(0, 2) != "0x" ||
+    blockHashOrBlockNumber.substr(0, 2) != "0x" &&
     blockHashOrBlockNumber.substr(0, 2) != "0X"
   ) {
     blockHashOrBlockNumber.insert(0, "0x");
@@ -200,7 +431,7 @@ std::future<json> Eth::getBlockUncleCount(
   std::string blockHashOrBlockNumber, bool isHash
 ) {
   if (
-    blockHashOrBlockNumber.substr(0, 2) != "0x" ||
+    blockHashOrBlockNumber.substr(0, 2) != "0x" &&
     blockHashOrBlockNumber.substr(0, 2) != "0X"
   ) {
     blockHashOrBlockNumber.insert(0, "0x");
@@ -227,12 +458,12 @@ std::future<json> Eth::getUncle(
   bool isHash, bool returnTransactionObjects
 ) {
   if (
-    blockHashOrBlockNumber.substr(0, 2) != "0x" ||
+    blockHashOrBlockNumber.substr(0, 2) != "0x" &&
     blockHashOrBlockNumber.substr(0, 2) != "0X"
   ) {
     blockHashOrBlockNumber.insert(0, "0x");
   }
-  if (uncleIndex.substr(0, 2) != "0x" || uncleIndex.substr(0, 2) != "0X") {
+  if (uncleIndex.substr(0, 2) != "0x" && uncleIndex.substr(0, 2) != "0X") {
     uncleIndex.insert(0, "0x");
   }
   return std::async([=]{
@@ -257,17 +488,26 @@ std::future<json> Eth::getUncle(
 }
 
 std::future<json> Eth::getTransaction(const std::string& transactionHash) {
+  std::shared_ptr<ImmutableCache> cache = this->cache;
   return std::async([=]{
     json ret;
     Error err;
     std::string rpcStr = RPC::eth_getTransactionByHash(transactionHash, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
-    } else {
-      ret = json::parse(Net::HTTPRequest(
-        this->provider, Net::RequestTypes::POST, rpcStr
-      ));
+      return ret;
+    }
+    std::string key;
+    if (cache) {
+      key = ImmutableCache::key("eth_getTransactionByHash", json::array({transactionHash}));
+      if (std::optional<json> hit = cache->get(key)) return cachedResponse(std::move(*hit));
     }
+    ret = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, rpcStr
+    ));
+    // Pending ones have no block yet and aren't cached.
+    std::optional<uint64_t> block = (ret.contains("result")) ? minedBlock(ret["result"]) : std::nullopt;
+    if (cache && block) cache->put(key, ret["result"], *block, ret["result"].value("blockHash", ""));
     return ret;
   });
 }
@@ -276,12 +516,12 @@ std::future<json> Eth::getTransactionFromBlock(
   std::string hashStringOrNumber, bool isHash, std::string indexNumber
 ) {
   if (
-    hashStringOrNumber.substr(0, 2) != "0x" ||
+    hashStringOrNumber.substr(0, 2) != "0x" &&
     hashStringOrNumber.substr(0, 2) != "0X"
   ) {
     hashStringOrNumber.insert(0, "0x");
   }
-  if (indexNumber.substr(0, 2) != "0x" || indexNumber.substr(0, 2) != "0X") {
+  if (indexNumber.substr(0, 2) != "0x" && indexNumber.substr(0, 2) != "0X") {
     indexNumber.insert(0, "0x");
   }
   return std::async([=]{
@@ -306,10 +546,38 @@ std::future<json> Eth::getTransactionFromBlock(
 }
 
 std::future<json> Eth::getTransactionReceipt(const std::string& hash) {
+  std::shared_ptr<ImmutableCache> cache = this->cache;
   return std::async([=]{
     json ret;
     Error err;
     std::string rpcStr = RPC::eth_getTransactionReceipt(hash, err).dump();
+    if (err.getCode() != 0) {
+      ret["error"]["message"] = err.what();
+      return ret;
+    }
+    std::string key;
+    if (cache) {
+      key = ImmutableCache::key("eth_getTransactionReceipt", json::array({hash}));
+      if (std::optional<json> hit = cache->get(key)) return cachedResponse(std::move(*hit));
+    }
+    ret = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, rpcStr
+    ));
+    // Pending ones have no block yet and aren't cached.
+    std::optional<uint64_t> block = (ret.contains("result")) ? minedBlock(ret["result"]) : std::nullopt;
+    if (cache && block) cache->put(key, ret["result"], *block, ret["result"].value("blockHash", ""));
+    return ret;
+  });
+}
+
+std::future<json> Eth::getTransactionCount(
+  const std::string& address, std::string defaultBlock
+) {
+  if (defaultBlock.empty()) return getTransactionCount(address, this->defaultBlock);
+  return std::async([=]{
+    json ret;
+    Error err;
+    std::string rpcStr = RPC::eth_getTransactionCount(address, defaultBlock, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
     } else {
@@ -321,15 +589,11 @@ std::future<json> Eth::getTransactionReceipt(const std::string& hash) {
   });
 }
 
-std::future<json> Eth::getTransactionCount(
-  const std::string& address, std::string defaultBlock
-) {
+std::future<json> Eth::getTransactionCount(const std::string& address, const BlockTag& defaultBlock) {
   return std::async([=]{
     json ret;
     Error err;
-    std::string rpcStr = RPC::eth_getTransactionCount(address,
-      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
-    err).dump();
+    std::string rpcStr = RPC::eth_getTransactionCount(address, defaultBlock, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
     } else {
@@ -341,17 +605,56 @@ std::future<json> Eth::getTransactionCount(
   });
 }
 
+std::future<Eth::BulkResult> Eth::getTransactionCount(
+  const std::vector<std::string>& addresses, const BlockTag& defaultBlock
+) {
+  return getTransactionCount(addresses, defaultBlock, BulkOptions());
+}
+
+std::future<Eth::BulkResult> Eth::getTransactionCount(
+  const std::vector<std::string>& addresses, const BlockTag& defaultBlock, BulkOptions options
+) {
+  return std::async(std::launch::async, [=]{
+    return bulkRead(this->provider, addresses.size(), defaultBlock, options,
+      [&](std::size_t i, const BlockTag& block, Error& err){
+        return RPC::eth_getTransactionCount(addresses[i], block, err);
+      }
+    );
+  });
+}
+
 std::future<json> Eth::feeHistory(
     uint64_t blockCount, const std::string& defaultBlock,
     const std::vector<uint64_t>& rewardPercentile
 )
 {
+    if (defaultBlock.empty()) return feeHistory(blockCount, this->defaultBlock, rewardPercentile);
     return std::async([=]{
       json ret;
       Error err;
       std::string rpcStr = RPC::eth_feeHistory(
-          blockCount, ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
-          rewardPercentile, err
+          blockCount, defaultBlock, rewardPercentile, err
+      ).dump();
+      if (err.getCode() != 0) ret["error"]["message"] = err.what();
+      else {
+          ret = json::parse(Net::HTTPRequest(
+              this->provider, Net::RequestTypes::POST, rpcStr
+          ));
+      }
+      return ret;
+    });
+}
+
+std::future<json> Eth::feeHistory(
+    uint64_t blockCount, const BlockTag& defaultBlock,
+    const std::vector<uint64_t>& rewardPercentile
+)
+{
+    return std::async([=]{
+      json ret;
+      Error err;
+      std::string rpcStr = RPC::eth_feeHistory(
+          blockCount, defaultBlock, rewardPercentile, err
       ).dump();
       if (err.getCode() != 0) ret["error"]["message"] = err.what();
       else {
@@ -415,12 +718,13 @@ std::future<json> Eth::signTransaction(const json& txObj) {
 }
 
 std::future<json> Eth::call(const json& callObject,const std::string& defaultBlock) {
+  if (defaultBlock.empty()) return call(callObject, this->defaultBlock);
+  std::optional<BlockTag> block = BlockTag::parse(defaultBlock);
+  if (block) return call(callObject, *block);
   return std::async([=]{
     json ret;
     Error err;
-    std::string rpcStr = RPC::eth_call(callObject,
-      ((!defaultBlock.empty()) ? defaultBlock : this->defaultBlock),
-    err).dump();
+    std::string rpcStr = RPC::eth_call(callObject, defaultBlock, err).dump();
     if (err.getCode() != 0) {
       ret["error"]["message"] = err.what();
     } else {
@@ -432,6 +736,16 @@ std::future<json> Eth::call(const json& callObject,const std::string& defaultBlo
   });
 }
 
+std::future<json> Eth::call(const json& callObject, const BlockTag& defaultBlock) {
+  std::shared_ptr<BlockCache> cache = this->blockCache;
+  return std::async([=]{
+    return blockCachedRequest(
+      this->provider, cache, "eth_call", json::array({callObject}), defaultBlock,
+      [&](const BlockTag& block, Error& err){ return RPC::eth_call(callObject, block, err); }
+    );
+  });
+}
+
 std::future<json> Eth::estimateGas(const json& callObject) {
   return std::async([=]{
     json ret;
@@ -464,6 +778,33 @@ std::future<json> Eth::getPastLogs(const json& options) {
   });
 }
 
+std::future<json> Eth::streamPastLogs(const json& options, LogStream::Callback onLog) {
+  return std::async([=]{
+    json ret;
+    Error err;
+    std::string rpcStr = RPC::eth_getLogs(options, err).dump();
+    if (err.getCode() != 0) {
+      ret["error"]["message"] = err.what();
+    } else {
+      Net::HTTPStreamRequest(this->provider, Net::RequestTypes::POST, rpcStr,
+        [&](std::istream& in){ ret = LogStream::parse(in, onLog); }
+      );
+    }
+    return ret;
+  });
+}
+
+std::unique_ptr<LogStream> Eth::openPastLogs(const json& options, std::size_t capacity) {
+  Error err;
+  std::string rpcStr = RPC::eth_getLogs(options, err).dump();
+  if (err.getCode() != 0) {
+    json ret;
+    ret["error"]["message"] = err.what();
+    return std::make_unique<LogStream>(ret);
+  }
+  return std::make_unique<LogStream>(this->provider, rpcStr, capacity);
+}
+
 std::future<json> Eth::getWork() {
   return std::async([=]{
     return json::parse(Net::HTTPRequest(
@@ -0,0 +1,122 @@
+#include <web3cpp/FeeOracle.h>
+
+#include <vector>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+
+FeeOracle::FeeOracle(const std::unique_ptr<Provider>& provider, HeadTracker& heads)
+  : FeeOracle(provider, heads, Options()) {}
+
+FeeOracle::FeeOracle(
+  const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options
+) : _provider(provider), _heads(heads), _options(options) {
+  if (this->_options.window == 0) this->_options.window = 1;
+}
+
+FeeOracle::~FeeOracle() {
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    listenerId = this->_listenerId;
+    this->_listenerId = 0;
+  }
+  if (listenerId != 0) this->_heads.unsubscribe(listenerId);
+}
+
+bool FeeOracle::_fetch(uint64_t blocks, std::optional<uint64_t> newest, bool reset) {
+  Error err;
+  json req = RPC::eth_feeHistory(
+    blocks, (newest) ? BlockTag::number(*newest) : BlockTag::latest(), {10, 50, 90}, err
+  );
+  if (err.getCode() != 0) return false;
+  json res;
+  try {
+    res = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, req.dump()));
+  } catch (std::exception &e) {
+    return false;
+  }
+  if (!res.contains("result") || !res["result"].is_object()) return false;
+  const json& result = res["result"];
+  if (!result.contains("oldestBlock") || !result.contains("baseFeePerGas") || result["baseFeePerGas"].empty()) return false;
+  std::vector<Sample> samples;
+  dev::u256 nextBaseFee;
+  try {
+    std::optional<Quantity> oldest = Quantity::fromHex(result["oldestBlock"].get<std::string>());
+    if (!oldest) return false;
+    const uint64_t first = static_cast<uint64_t>(oldest->value());
+    const json& rewards = (result.contains("reward")) ? result["reward"] : json::array();
+    for (std::size_t i = 0; i < rewards.size(); i++) {
+      Sample sample{first + i, {}};
+      for (std::size_t level = 0; level < 3 && level < rewards[i].size(); level++) {
+        sample.reward[level] = Utils::toBN(rewards[i][level].get<std::string>());
+      }
+      samples.push_back(std::move(sample));
+    }
+    // The last base fee is the one of the block after the newest.
+    nextBaseFee = Utils::toBN(result["baseFeePerGas"].back().get<std::string>());
+  } catch (std::exception &e) {
+    return false;
+  }
+
+  std::scoped_lock lock(this->_lock);
+  if (reset) {
+    this->_samples.clear();
+    this->_sums = {};
+  }
+  for (Sample& sample : samples) {
+    if (!this->_samples.empty() && sample.number <= this->_samples.back().number) continue;
+    for (std::size_t level = 0; level < 3; level++) this->_sums[level] += sample.reward[level];
+    this->_samples.push_back(std::move(sample));
+    if (this->_samples.size() > this->_options.window) {
+      for (std::size_t level = 0; level < 3; level++) this->_sums[level] -= this->_samples.front().reward[level];
+      this->_samples.pop_front();
+    }
+  }
+  this->_nextBaseFee = nextBaseFee;
+  return true;
+}
+
+void FeeOracle::_onHead(const HeadTracker::Event& event) {
+  const uint64_t number = event.head.number;
+  bool reset;
+  {
+    std::scoped_lock lock(this->_lock);
+    if (!event.isReorg() && !this->_samples.empty() && number <= this->_samples.back().number) return;
+    // Only the next block can extend the window, anything else starts over.
+    reset = event.isReorg() || this->_samples.empty() || number != this->_samples.back().number + 1;
+  }
+  this->_fetch((reset) ? this->_options.window : 1, number, reset);
+}
+
+std::optional<FeeOracle::Fees> FeeOracle::_fees() const {
+  if (this->_samples.empty()) return std::nullopt;
+  Fees ret;
+  ret.block = this->_samples.back().number;
+  ret.baseFee = this->_nextBaseFee;
+  for (std::size_t level = 0; level < 3; level++) {
+    ret.priorityFee[level] = this->_sums[level] / this->_samples.size();
+  }
+  return ret;
+}
+
+std::optional<FeeOracle::Fees> FeeOracle::fees() {
+  {
+    std::scoped_lock seedLock(this->_seedLock);
+    bool seeded;
+    {
+      std::scoped_lock lock(this->_lock);
+      seeded = this->_listenerId != 0;
+    }
+    if (!seeded) {
+      if (!this->_fetch(this->_options.window, std::nullopt, true)) return std::nullopt;
+      uint64_t id = this->_heads.subscribe([this](const HeadTracker::Event& event){ this->_onHead(event); });
+      std::scoped_lock lock(this->_lock);
+      this->_listenerId = id;
+    }
+  }
+  std::scoped_lock lock(this->_lock);
+  return this->_fees();
+}
@@ -0,0 +1,90 @@
+#include <web3cpp/GasCache.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/SHA3.h>
+
+namespace {
+  /// Get a string field in lowercase, or an empty string if it's missing.
+  std::string lowerField(const json& obj, const char* field) {
+    if (!obj.contains(field) || !obj[field].is_string()) return "";
+    std::string ret = obj[field].get<std::string>();
+    std::transform(ret.begin(), ret.end(), ret.begin(), [](unsigned char c){ return std::tolower(c); });
+    return ret;
+  }
+}
+
+GasCache::GasCache() : GasCache(Options()) {}
+
+GasCache::GasCache(Options options) : _options(options) {}
+
+std::string GasCache::key(const json& txObj) const {
+  std::string to = lowerField(txObj, "to");
+  if (to.empty()) return "";  // Contract creation
+  std::string data = lowerField(txObj, "data");
+  if (data.empty()) data = lowerField(txObj, "input");
+  if (data.size() >= 2 && data[0] == '0' && data[1] == 'x') data.erase(0, 2);
+  std::string value = lowerField(txObj, "value");
+  bool hasValue = value.find_first_not_of("0x") != std::string::npos;
+
+  std::string ret = to + ":" + data.substr(0, 8) + ":" + ((hasValue) ? "1" : "0");
+  if (this->_options.keyByCalldata && data.size() > 8) {
+    ret += ":" + dev::sha3(dev::fromHex(data)).hex();
+  }
+  if (txObj.contains("accessList")) ret += ":" + dev::sha3(txObj["accessList"].dump()).hex();
+  if (this->_options.senderClass) ret += ":" + this->_options.senderClass(txObj);
+  return ret;
+}
+
+std::optional<dev::u256> GasCache::get(const std::string& key) {
+  std::scoped_lock lock(this->_lock);
+  auto it = this->_entries.find(key);
+  if (it == this->_entries.end()) {
+    this->_stats.misses++;
+    return std::nullopt;
+  }
+  if (std::chrono::steady_clock::now() >= it->second.expires) {
+    this->_entries.erase(it);
+    this->_stats.entries = this->_entries.size();
+    this->_stats.misses++;
+    return std::nullopt;
+  }
+  it->second.hits++;
+  if (this->_options.revalidateEvery != 0 && it->second.hits % this->_options.revalidateEvery == 0) {
+    this->_stats.revalidations++;
+    return std::nullopt;
+  }
+  this->_stats.hits++;
+  return it->second.gas;
+}
+
+void GasCache::put(const std::string& key, const dev::u256& gas) {
+  if (key.empty()) return;
+  const auto now = std::chrono::steady_clock::now();
+  std::scoped_lock lock(this->_lock);
+  auto it = this->_entries.find(key);
+  if (it == this->_entries.end() && this->_entries.size() >= this->_options.maxEntries) {
+    // Make room by dropping expired entries, or skip storing if there are none.
+    for (auto e = this->_entries.begin(); e != this->_entries.end();) {
+      e = (now >= e->second.expires) ? this->_entries.erase(e) : std::next(e);
+    }
+    if (this->_entries.size() >= this->_options.maxEntries) return;
+  }
+  Entry& entry = this->_entries[key];
+  entry.gas = gas;
+  entry.expires = now + this->_options.ttl;
+  this->_stats.entries = this->_entries.size();
+}
+
+void GasCache::clear() {
+  std::scoped_lock lock(this->_lock);
+  this->_entries.clear();
+  this->_stats.entries = 0;
+}
+
+GasCache::Stats GasCache::stats() {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
@@ -0,0 +1,344 @@
+#include <web3cpp/HeadTracker.h>
+
+#include <algorithm>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+std::optional<HeadTracker::Header> HeadTracker::Header::fromJSON(const json& block) {
+  if (!block.is_object()) return std::nullopt;
+  for (const char* key : {"number", "hash", "parentHash"}) {
+    auto it = block.find(key);
+    if (it == block.end() || !it->is_string()) return std::nullopt;
+  }
+  std::optional<Quantity> number = Quantity::fromHex(block["number"].get<std::string>());
+  if (!number) return std::nullopt;
+  Header ret;
+  ret.number = static_cast<uint64_t>(number->value());
+  ret.hash = block["hash"].get<std::string>();
+  ret.parentHash = block["parentHash"].get<std::string>();
+  ret.header = block;
+  return ret;
+}
+
+HeadTracker::HeadTracker(const std::unique_ptr<Provider>& provider)
+  : HeadTracker(provider, Options()) {}
+
+HeadTracker::HeadTracker(const std::unique_ptr<Provider>& provider, Options options)
+  : _provider(provider), _options(options) {
+  if (this->_options.historySize == 0) this->_options.historySize = 1;
+  if (this->_options.pollInterval.count() <= 0) this->_options.pollInterval = std::chrono::milliseconds(1);
+  this->_ring.resize(this->_options.historySize);
+}
+
+HeadTracker::~HeadTracker() { this->stop(); }
+
+void HeadTracker::start() {
+  std::scoped_lock lock(this->_runLock);
+  if (this->_tracker.joinable()) return;
+  this->_stop = false;
+  this->_tracker = std::thread([this]{ this->_run(); });
+}
+
+void HeadTracker::stop() {
+  std::thread tracker;
+  {
+    std::scoped_lock lock(this->_runLock);
+    this->_stop = true;
+    tracker = std::move(this->_tracker);
+  }
+  this->_wake.notify_all();
+  if (tracker.joinable()) tracker.join();
+}
+
+bool HeadTracker::running() const {
+  std::scoped_lock lock(this->_runLock);
+  return this->_tracker.joinable() && !this->_stop;
+}
+
+HeadTracker::Backend HeadTracker::backend() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_backend;
+}
+
+uint64_t HeadTracker::subscribe(Listener listener) {
+  uint64_t id;
+  {
+    std::scoped_lock lock(this->_listenersLock);
+    id = this->_nextListenerId++;
+    this->_listeners.emplace(id, std::move(listener));
+  }
+  this->start();
+  return id;
+}
+
+bool HeadTracker::unsubscribe(uint64_t id) {
+  bool erased;
+  {
+    std::scoped_lock lock(this->_listenersLock);
+    erased = this->_listeners.erase(id) > 0;
+  }
+  // Wait for a dispatch in progress, which may still be calling it.
+  // Recursive so listeners can remove themselves.
+  std::scoped_lock dispatchLock(this->_dispatchLock);
+  return erased;
+}
+
+std::optional<HeadTracker::Header> HeadTracker::head() const {
+  std::scoped_lock lock(this->_lock);
+  if (this->_ringCount == 0) return std::nullopt;
+  return this->_ringAt(this->_ringCount - 1);
+}
+
+std::optional<HeadTracker::Header> HeadTracker::header(uint64_t number) const {
+  std::scoped_lock lock(this->_lock);
+  return this->_ringFind(number);
+}
+
+std::vector<HeadTracker::Header> HeadTracker::history() const {
+  std::scoped_lock lock(this->_lock);
+  std::vector<Header> ret;
+  ret.reserve(this->_ringCount);
+  for (std::size_t i = 0; i < this->_ringCount; i++) ret.push_back(this->_ringAt(i));
+  return ret;
+}
+
+const HeadTracker::Header& HeadTracker::_ringAt(std::size_t i) const {
+  return this->_ring[(this->_ringFirst + i) % this->_ring.size()];
+}
+
+void HeadTracker::_ringPush(Header header) {
+  if (this->_ringCount == this->_ring.size()) {
+    this->_ring[this->_ringFirst] = std::move(header);
+    this->_ringFirst = (this->_ringFirst + 1) % this->_ring.size();
+  } else {
+    this->_ring[(this->_ringFirst + this->_ringCount) % this->_ring.size()] = std::move(header);
+    this->_ringCount++;
+  }
+}
+
+void HeadTracker::_ringPop() {
+  if (this->_ringCount > 0) this->_ringCount--;
+}
+
+std::optional<HeadTracker::Header> HeadTracker::_ringFind(uint64_t number) const {
+  // Headers in the ring always have consecutive numbers.
+  if (this->_ringCount == 0) return std::nullopt;
+  uint64_t oldest = this->_ringAt(0).number;
+  if (number < oldest || number - oldest >= this->_ringCount) return std::nullopt;
+  return this->_ringAt(number - oldest);
+}
+
+void HeadTracker::_notify(const Event& event) {
+  // Copy so listeners can subscribe or unsubscribe from inside the callback.
+  std::scoped_lock dispatchLock(this->_dispatchLock);
+  std::vector<Listener> listeners;
+  {
+    std::scoped_lock lock(this->_listenersLock);
+    for (const auto& [id, listener] : this->_listeners) listeners.push_back(listener);
+  }
+  for (const Listener& listener : listeners) listener(event);
+}
+
+bool HeadTracker::_sleep() {
+  std::unique_lock lock(this->_runLock);
+  return !this->_wake.wait_for(lock, this->_options.pollInterval, [&]{ return this->_stop.load(); });
+}
+
+json HeadTracker::_request(const json& request) {
+  return json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, request.dump()));
+}
+
+void HeadTracker::_fetchLatest() {
+  json res = this->_request(RPC::eth_getBlockByNumber(BlockTag::latest(), false));
+  if (!res.contains("result")) return;
+  std::optional<Header> latest = Header::fromJSON(res["result"]);
+  if (latest) this->_onHeader(std::move(*latest));
+}
+
+void HeadTracker::_run() {
+  bool subscribe = this->_options.subscribe;
+  bool filter = true;
+  while (!this->_stop) {
+    try {
+      if (subscribe) {
+        // Returns after the connection drops, so wait a bit before reconnecting.
+        if (!this->_runSubscription()) subscribe = false; else this->_sleep();
+      } else if (filter) {
+        if (!this->_runFilter()) filter = false;
+      } else {
+        this->_runPolling();
+      }
+    } catch (std::exception &e) {
+      // Network error, try the same backend again in a while.
+      this->_sleep();
+    }
+  }
+  std::scoped_lock lock(this->_lock);
+  this->_backend = Backend::None;
+}
+
+bool HeadTracker::_runSubscription() {
+  Error err;
+  json request = RPC::eth_subscribe("newHeads", err);
+  bool confirmed = false;
+  try {
+    Net::WSSubscribe(this->_provider, this->_options.wsPort, request,
+      [&](const json& msg){
+        if (!confirmed) {
+          // First message is the response to eth_subscribe.
+          if (!msg.contains("result") || !msg["result"].is_string()) return false;
+          confirmed = true;
+          {
+            std::scoped_lock lock(this->_lock);
+            this->_backend = Backend::Subscription;
+          }
+          this->_fetchLatest();
+          return !this->_stop;
+        }
+        if (msg.value("method", "") != "eth_subscription") return true;
+        if (!msg.contains("params") || !msg["params"].contains("result")) return true;
+        std::optional<Header> header = Header::fromJSON(msg["params"]["result"]);
+        if (header) this->_onHeader(std::move(*header));
+        return !this->_stop;
+      },
+      [&]{ return !this->_stop; }, this->_options.pollInterval
+    );
+  } catch (std::exception &e) {
+    // Failing before the subscription went through means there is no
+    // WebSocket endpoint, anything later is a dropped connection.
+    if (!confirmed) return false;
+    throw;
+  }
+  return confirmed;
+}
+
+bool HeadTracker::_runFilter() {
+  json res = this->_request(RPC::eth_newBlockFilter());
+  if (!res.contains("result") || !res["result"].is_string()) return false;
+  const std::string filterId = res["result"].get<std::string>();
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_backend = Backend::Filter;
+  }
+  this->_fetchLatest();
+
+  while (this->_sleep()) {
+    Error err;
+    json changes = this->_request(RPC::eth_getFilterChanges(filterId, err));
+    // Filters expire on the node after a while without polls, make a new one.
+    if (changes.contains("error")) return true;
+    if (!changes.contains("result") || !changes["result"].is_array() || changes["result"].empty()) continue;
+    std::vector<json> requests;
+    for (const json& hash : changes["result"]) {
+      if (!hash.is_string()) continue;
+      Error hashErr;
+      json req = RPC::eth_getBlockByHash(hash.get<std::string>(), false, hashErr);
+      if (hashErr.getCode() == 0) requests.push_back(std::move(req));
+    }
+    for (json& block : Net::HTTPBatchRequest(this->_provider, std::move(requests))) {
+      if (!block.contains("result")) continue;
+      std::optional<Header> header = Header::fromJSON(block["result"]);
+      if (header) this->_onHeader(std::move(*header));
+    }
+  }
+  Error err;
+  try {
+    this->_request(RPC::eth_uninstallFilter(filterId, err));
+  } catch (std::exception &e) {}
+  return true;
+}
+
+void HeadTracker::_runPolling() {
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_backend = Backend::Polling;
+  }
+  do { this->_fetchLatest(); } while (this->_sleep());
+}
+
+void HeadTracker::_onHeader(Header header) {
+  // Only the tracker thread changes the ring, so it can be read in steps
+  // without holding the lock while requests are made.
+  std::optional<Header> top;
+  {
+    std::scoped_lock lock(this->_lock);
+    std::optional<Header> same = this->_ringFind(header.number);
+    if (same && same->hash == header.hash) return;  // Already known
+    if (this->_ringCount > 0) top = this->_ringAt(this->_ringCount - 1);
+  }
+  const std::size_t maxDepth = this->_options.historySize;
+
+  // The new branch, newest first. Ends at the first header whose parent is in the ring.
+  std::vector<Header> branch;
+  branch.push_back(std::move(header));
+
+  // Skipped blocks are fetched by number in a single batch, and kept
+  // only as long as they link up to the new header.
+  if (top && branch[0].number > top->number + 1 && branch[0].number - top->number - 1 <= maxDepth) {
+    std::vector<json> requests;
+    for (uint64_t n = branch[0].number - 1; n > top->number; n--) {
+      requests.push_back(RPC::eth_getBlockByNumber(BlockTag::number(n), false));
+    }
+    for (json& res : Net::HTTPBatchRequest(this->_provider, std::move(requests))) {
+      std::optional<Header> parent = (res.contains("result")) ? Header::fromJSON(res["result"]) : std::nullopt;
+      if (!parent || parent->hash != branch.back().parentHash) break;
+      branch.push_back(std::move(*parent));
+    }
+  }
+
+  // Walk back by parent hash until the branch meets the ring.
+  bool connected = false;
+  while (!this->_stop) {
+    const Header& last = branch.back();
+    if (last.number == 0) break;
+    std::optional<Header> below;
+    uint64_t oldest = 0;
+    {
+      std::scoped_lock lock(this->_lock);
+      below = this->_ringFind(last.number - 1);
+      if (this->_ringCount > 0) oldest = this->_ringAt(0).number;
+    }
+    if (below && below->hash == last.parentHash) { connected = true; break; }
+    // Nothing older to compare with, too deep to follow, or a gap too long to fill.
+    if (!top || last.number <= oldest || branch.size() > maxDepth) break;
+    if (last.number - 1 > top->number && last.number - 1 - top->number + branch.size() > maxDepth) break;
+    Error err;
+    json res = this->_request(RPC::eth_getBlockByHash(last.parentHash, false, err));
+    std::optional<Header> parent = (res.contains("result")) ? Header::fromJSON(res["result"]) : std::nullopt;
+    if (!parent) break;
+    branch.push_back(std::move(*parent));
+  }
+
+  std::vector<Header> removed;
+  {
+    std::scoped_lock lock(this->_lock);
+    if (connected) {
+      // Everything above the common ancestor was orphaned.
+      while (this->_ringCount > 0 && this->_ringAt(this->_ringCount - 1).number >= branch.back().number) {
+        removed.push_back(this->_ringAt(this->_ringCount - 1));
+        this->_ringPop();
+      }
+    } else {
+      // No common ancestor in the history, so start over. If the new branch
+      // reaches into the history, the reorg went deeper than it and every
+      // stored header was orphaned; otherwise the head just moved too far.
+      bool orphaned = top && branch.back().number <= top->number;
+      while (this->_ringCount > 0) {
+        if (orphaned) removed.push_back(this->_ringAt(this->_ringCount - 1));
+        this->_ringPop();
+      }
+      this->_ringFirst = 0;
+    }
+    for (auto it = branch.rbegin(); it != branch.rend(); it++) this->_ringPush(*it);
+  }
+
+  // One event per new header, oldest first. The first one carries the reorg.
+  for (auto it = branch.rbegin(); it != branch.rend(); it++) {
+    Event event;
+    event.head = std::move(*it);
+    if (it == branch.rbegin()) event.removed = std::move(removed);
+    this->_notify(event);
+  }
+}
@@ -0,0 +1,184 @@
+#include <web3cpp/ImmutableCache.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+  /// Lowercase every string in a JSON value.
+  json lowercase(json value) {
+    if (value.is_string()) {
+      std::string str = value.get<std::string>();
+      std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c){ return std::tolower(c); });
+      return str;
+    }
+    if (value.is_array() || value.is_object()) {
+      for (json& item : value) item = lowercase(std::move(item));
+    }
+    return value;
+  }
+
+  /// Fixed cost of an entry on top of its key and value (list node, index slot, etc.).
+  constexpr std::size_t entryOverhead = 128;
+}
+
+ImmutableCache::ImmutableCache() : ImmutableCache(Options()) {}
+
+ImmutableCache::ImmutableCache(Options options) : _options(options) {}
+
+ImmutableCache::~ImmutableCache() { this->untrack(); }
+
+void ImmutableCache::track(HeadTracker& heads) {
+  this->untrack();
+  std::scoped_lock lock(this->_lock);
+  this->_heads = &heads;
+}
+
+void ImmutableCache::untrack() {
+  HeadTracker* heads;
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    heads = this->_heads;
+    listenerId = this->_listenerId;
+    this->_heads = nullptr;
+    this->_listenerId = 0;
+    this->_head.reset();
+  }
+  if (heads && listenerId != 0) heads->unsubscribe(listenerId);
+  // Without reorg tracking, entries tied to a block can't be trusted anymore.
+  std::scoped_lock lock(this->_lock);
+  for (auto it = this->_entries.begin(); it != this->_entries.end();) {
+    if (it->final) { it++; continue; }
+    this->_stats.bytes -= it->bytes;
+    this->_stats.invalidations++;
+    this->_index.erase(it->key);
+    it = this->_entries.erase(it);
+  }
+  this->_stats.entries = this->_entries.size();
+}
+
+void ImmutableCache::_listen() {
+  HeadTracker* heads;
+  {
+    std::scoped_lock lock(this->_lock);
+    if (!this->_heads || this->_listenerId != 0) return;
+    heads = this->_heads;
+    this->_listenerId = UINT64_MAX;  // Reserved while subscribing
+  }
+  uint64_t id = heads->subscribe([this](const HeadTracker::Event& event){ this->_onHead(event); });
+  std::optional<HeadTracker::Header> head = heads->head();
+  std::scoped_lock lock(this->_lock);
+  this->_listenerId = id;
+  if (head && (!this->_head || head->number > *this->_head)) this->_head = head->number;
+}
+
+void ImmutableCache::_onHead(const HeadTracker::Event& event) {
+  std::scoped_lock lock(this->_lock);
+  this->_head = event.head.number;
+  if (!event.isReorg()) return;
+  uint64_t lowest = event.removed.back().number;
+  for (const HeadTracker::Header& header : event.removed) lowest = std::min(lowest, header.number);
+  for (auto it = this->_entries.begin(); it != this->_entries.end();) {
+    if (it->final || it->blockNumber < lowest) { it++; continue; }
+    this->_stats.bytes -= it->bytes;
+    this->_stats.invalidations++;
+    this->_index.erase(it->key);
+    it = this->_entries.erase(it);
+  }
+  this->_stats.entries = this->_entries.size();
+}
+
+std::string ImmutableCache::key(const std::string& method, const json& params) {
+  return method + lowercase(params).dump();
+}
+
+std::optional<json> ImmutableCache::get(const std::string& key) {
+  std::scoped_lock lock(this->_lock);
+  auto it = this->_index.find(key);
+  if (it == this->_index.end()) {
+    this->_stats.misses++;
+    return std::nullopt;
+  }
+  Entry& entry = *it->second;
+  // Entries tied to a block become final once buried deep enough.
+  if (!entry.final && this->_head && *this->_head >= entry.blockNumber + this->_options.finalityDepth) {
+    entry.final = true;
+  }
+  this->_entries.splice(this->_entries.begin(), this->_entries, it->second);
+  this->_stats.hits++;
+  return entry.value;
+}
+
+void ImmutableCache::put(const std::string& key, json value) {
+  Entry entry{key, std::move(value), 0, true, 0};
+  entry.bytes = entryOverhead + 2 * key.size() + entry.value.dump().size();
+  std::scoped_lock lock(this->_lock);
+  if (entry.bytes > this->_options.maxBytes) return;
+  auto it = this->_index.find(key);
+  if (it != this->_index.end()) {
+    this->_stats.bytes -= it->second->bytes;
+    this->_entries.erase(it->second);
+  }
+  this->_entries.push_front(std::move(entry));
+  this->_index[key] = this->_entries.begin();
+  this->_stats.bytes += this->_entries.front().bytes;
+  this->_evict();
+  this->_stats.entries = this->_entries.size();
+}
+
+bool ImmutableCache::put(
+  const std::string& key, json value, uint64_t blockNumber, const std::string& blockHash
+) {
+  std::optional<bool> final = this->isFinal(blockNumber);
+  if (!final) return false;
+  if (*final) { this->put(key, std::move(value)); return true; }
+  Entry entry{key, std::move(value), 0, false, blockNumber};
+  entry.bytes = entryOverhead + 2 * key.size() + entry.value.dump().size();
+  std::scoped_lock lock(this->_lock);
+  // Only blocks in the tracker's history are reported if a reorg drops them.
+  if (this->_listenerId == 0 || !this->_heads) return false;
+  std::optional<HeadTracker::Header> header = this->_heads->header(blockNumber);
+  if (!header || (!blockHash.empty() && header->hash != blockHash)) return false;
+  if (entry.bytes > this->_options.maxBytes) return false;
+  auto it = this->_index.find(key);
+  if (it != this->_index.end()) {
+    this->_stats.bytes -= it->second->bytes;
+    this->_entries.erase(it->second);
+  }
+  this->_entries.push_front(std::move(entry));
+  this->_index[key] = this->_entries.begin();
+  this->_stats.bytes += this->_entries.front().bytes;
+  this->_evict();
+  this->_stats.entries = this->_entries.size();
+  return true;
+}
+
+std::optional<bool> ImmutableCache::isFinal(uint64_t blockNumber) {
+  this->_listen();
+  std::scoped_lock lock(this->_lock);
+  if (!this->_head) return std::nullopt;
+  return *this->_head >= blockNumber + this->_options.finalityDepth;
+}
+
+void ImmutableCache::_evict() {
+  while (this->_stats.bytes > this->_options.maxBytes && !this->_entries.empty()) {
+    Entry& last = this->_entries.back();
+    this->_stats.bytes -= last.bytes;
+    this->_stats.evictions++;
+    this->_index.erase(last.key);
+    this->_entries.pop_back();
+  }
+}
+
+void ImmutableCache::clear() {
+  std::scoped_lock lock(this->_lock);
+  this->_entries.clear();
+  this->_index.clear();
+  this->_stats.entries = 0;
+  this->_stats.bytes = 0;
+}
+
+ImmutableCache::Stats ImmutableCache::stats() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
@@ -0,0 +1,335 @@
+#include <web3cpp/Keystore.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <web3cpp/Utils.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/SHA3.h>
+
+namespace {
+  /// Key derivation parameters of a keystore.
+  struct KdfParams {
+    bool scrypt = true;   ///< Whether it's scrypt (`true`) or PBKDF2 (`false`).
+    dev::bytes salt;      ///< The salt.
+    uint64_t n = 0;       ///< scrypt CPU/memory cost.
+    uint32_t r = 0;       ///< scrypt block size.
+    uint32_t p = 0;       ///< scrypt parallelization.
+    uint32_t c = 0;       ///< PBKDF2 iterations.
+    uint32_t dklen = 0;   ///< Derived key length.
+  };
+
+  /// Get the "crypto" object of a keystore. Some older files use "Crypto".
+  const json& cryptoOf(const json& keystore) {
+    return (keystore.contains("crypto")) ? keystore["crypto"] : keystore.at("Crypto");
+  }
+
+  /// Parse a hex field, which must have the given size (or any if 0).
+  bool hexField(const json& obj, const char* key, std::size_t size, dev::bytes& out) {
+    if (!obj.contains(key) || !obj[key].is_string()) return false;
+    const std::string& hex = obj[key].get_ref<const std::string&>();
+    out = dev::fromHex(hex);
+    if (out.empty() && !hex.empty()) return false;
+    return size == 0 || out.size() == size;
+  }
+
+  /// Parse the key derivation parameters of a keystore. Throws on malformed JSON.
+  bool parseKdf(const json& keystore, KdfParams& params) {
+    const json& crypto = cryptoOf(keystore);
+    const std::string& kdf = crypto.at("kdf").get_ref<const std::string&>();
+    const json& kdfparams = crypto.at("kdfparams");
+    if (!hexField(kdfparams, "salt", 0, params.salt)) return false;
+    params.dklen = kdfparams.at("dklen").get<uint32_t>();
+    if (params.dklen < 32) return false;
+    if (kdf == "scrypt") {
+      params.scrypt = true;
+      params.n = kdfparams.at("n").get<uint64_t>();
+      params.r = kdfparams.at("r").get<uint32_t>();
+      params.p = kdfparams.at("p").get<uint32_t>();
+      // Same limits libscrypt enforces, checked here so memoryCost() can't overflow.
+      if (params.n < 2 || (params.n & (params.n - 1)) != 0) return false;
+      if (params.r == 0 || params.p == 0 || uint64_t(params.r) * params.p >= (1u << 30)) return false;
+      if (params.n > UINT64_MAX / 128 / params.r) return false;
+      return true;
+    }
+    if (kdf == "pbkdf2") {
+      params.scrypt = false;
+      if (kdfparams.at("prf").get_ref<const std::string&>() != "hmac-sha256") return false;
+      params.c = kdfparams.at("c").get<uint32_t>();
+      return params.c > 0;
+    }
+    return false;
+  }
+
+  /// Bytes scrypt allocates for a derivation: V, B and XY.
+  uint64_t scryptMemory(uint64_t n, uint32_t r, uint32_t p) {
+    return 128 * uint64_t(r) * n + 128 * uint64_t(r) * p + 256 * uint64_t(r) + 64;
+  }
+
+  /// Shared memory budget for the derivations of load().
+  class MemoryBudget {
+    private:
+      std::mutex _lock;
+      std::condition_variable _freed;
+      const uint64_t _total;
+      uint64_t _available;
+      std::size_t _running = 0;
+      std::size_t _peak = 0;
+
+    public:
+      explicit MemoryBudget(uint64_t total) : _total(total), _available(total) {}
+
+      /// Wait until some memory is free, and take it. Returns what was taken.
+      uint64_t acquire(uint64_t bytes) {
+        // A derivation larger than the whole budget waits for all of it.
+        bytes = std::min(bytes, this->_total);
+        std::unique_lock lock(this->_lock);
+        this->_freed.wait(lock, [&]{ return this->_available >= bytes; });
+        this->_available -= bytes;
+        this->_peak = std::max(this->_peak, ++this->_running);
+        return bytes;
+      }
+
+      /// Give back memory taken with acquire().
+      void release(uint64_t bytes) {
+        {
+          std::scoped_lock lock(this->_lock);
+          this->_available += bytes;
+          this->_running--;
+        }
+        this->_freed.notify_all();
+      }
+
+      /// Most derivations that held memory at the same time.
+      std::size_t peak() {
+        std::scoped_lock lock(this->_lock);
+        return this->_peak;
+      }
+  };
+
+  /// Give back the memory of a derivation when it goes out of scope.
+  struct BudgetGuard {
+    MemoryBudget* budget;
+    uint64_t bytes;
+    ~BudgetGuard() { if (budget) budget->release(bytes); }
+  };
+
+  /// Decrypt a keystore, optionally deriving the key within a memory budget.
+  std::optional<dev::Secret> decryptWith(
+    const json& keystore, const std::string& password, Error &error, MemoryBudget* budget
+  ) {
+    std::optional<dev::Secret> ret;
+    KdfParams params;
+    dev::bytes iv, ciphertext, mac;
+    try {
+      if (!keystore.is_object() || keystore.at("version").get<int>() != 3) {
+        error.setCode(16); // Key Decryption Failed
+        return ret;
+      }
+      const json& crypto = cryptoOf(keystore);
+      if (crypto.at("cipher").get_ref<const std::string&>() != "aes-128-ctr" || !parseKdf(keystore, params)
+        || !hexField(crypto.at("cipherparams"), "iv", 16, iv) || !hexField(crypto, "ciphertext", 32, ciphertext)
+        || !hexField(crypto, "mac", 32, mac)
+      ) {
+        error.setCode(16); // Key Decryption Failed
+        return ret;
+      }
+    } catch (std::exception &e) {
+      error.setCode(16); // Key Decryption Failed
+      return ret;
+    }
+
+    dev::bytesSec derived;
+    try {
+      if (params.scrypt) {
+        BudgetGuard guard{budget, 0};
+        if (budget) guard.bytes = budget->acquire(scryptMemory(params.n, params.r, params.p));
+        derived = dev::scrypt(password, params.salt, params.n, params.r, params.p, params.dklen);
+      } else {
+        derived = dev::pbkdf2(password, params.salt, params.c, params.dklen);
+      }
+    } catch (std::exception &e) {
+      error.setCode(7); // Key Derivation Failed
+      return ret;
+    }
+    if (derived.size() != params.dklen) {
+      error.setCode(7); // Key Derivation Failed
+      return ret;
+    }
+
+    // The MAC covers the second half of the first 32 bytes and the ciphertext.
+    dev::bytes macInput(derived.ref().cropped(16, 16).begin(), derived.ref().cropped(16, 16).end());
+    macInput.insert(macInput.end(), ciphertext.begin(), ciphertext.end());
+    dev::h256 expected = dev::sha3(macInput);
+    dev::bytesRef(&macInput).cleanse();
+    uint8_t diff = 0;
+    for (std::size_t i = 0; i < dev::h256::size; i++) diff |= expected[i] ^ mac[i];
+    if (diff != 0) {
+      error.setCode(15); // Key Decryption MAC Mismatch
+      return ret;
+    }
+
+    dev::bytesSec plain = dev::decryptAES128CTR(derived.ref().cropped(0, 16), dev::h128(iv), &ciphertext);
+    if (plain.size() != dev::Secret::size) {
+      error.setCode(16); // Key Decryption Failed
+      return ret;
+    }
+    ret.emplace(plain);
+    // A zero key or one above the curve order has no public key.
+    if (dev::toPublic(*ret) == dev::Public()) {
+      ret.reset();
+      error.setCode(16); // Key Decryption Failed
+      return ret;
+    }
+    // The address is optional, but must be the key's if it's there.
+    if (keystore.contains("address") && keystore["address"].is_string()) {
+      dev::bytes address = dev::fromHex(keystore["address"].get<std::string>());
+      if (address.size() != dev::Address::size || dev::Address(address) != dev::toAddress(*ret)) {
+        ret.reset();
+        error.setCode(16); // Key Decryption Failed
+        return ret;
+      }
+    }
+    error.setCode(0);
+    return ret;
+  }
+
+  /// Format 16 random bytes as a version 4 UUID.
+  std::string randomUUID() {
+    dev::h128 id = dev::h128::random();
+    id[6] = (id[6] & 0x0f) | 0x40;
+    id[8] = (id[8] & 0x3f) | 0x80;
+    std::string hex = id.hex();
+    return hex.substr(0, 8) + "-" + hex.substr(8, 4) + "-" + hex.substr(12, 4)
+      + "-" + hex.substr(16, 4) + "-" + hex.substr(20, 12);
+  }
+}
+
+json Keystore::encrypt(
+  const dev::Secret& secret, const std::string& password, Error &error, Options options
+) {
+  json ret = json::object();
+  if (options.scryptN < 2 || (options.scryptN & (options.scryptN - 1)) != 0
+    || options.scryptR == 0 || options.scryptP == 0
+  ) {
+    error.setCode(7); // Key Derivation Failed
+    return ret;
+  }
+  dev::h256 salt = dev::h256::random();
+  dev::h128 iv = dev::h128::random();
+  dev::bytesSec derived;
+  try {
+    derived = dev::scrypt(password, salt.asBytes(), options.scryptN, options.scryptR, options.scryptP, 32);
+  } catch (std::exception &e) {
+    error.setCode(7); // Key Derivation Failed
+    return ret;
+  }
+  if (derived.size() != 32) {
+    error.setCode(7); // Key Derivation Failed
+    return ret;
+  }
+
+  dev::bytes ciphertext = dev::encryptAES128CTR(derived.ref().cropped(0, 16), iv, secret.ref());
+  if (ciphertext.size() != dev::Secret::size) {
+    error.setCode(8); // Key Encryption Failed
+    return ret;
+  }
+  dev::bytes macInput(derived.ref().cropped(16, 16).begin(), derived.ref().cropped(16, 16).end());
+  macInput.insert(macInput.end(), ciphertext.begin(), ciphertext.end());
+  dev::h256 mac = dev::sha3(macInput);
+  dev::bytesRef(&macInput).cleanse();
+
+  ret["address"] = dev::toAddress(secret).hex();
+  ret["crypto"]["cipher"] = "aes-128-ctr";
+  ret["crypto"]["cipherparams"]["iv"] = iv.hex();
+  ret["crypto"]["ciphertext"] = dev::toHex(ciphertext);
+  ret["crypto"]["kdf"] = "scrypt";
+  ret["crypto"]["kdfparams"]["dklen"] = 32;
+  ret["crypto"]["kdfparams"]["n"] = options.scryptN;
+  ret["crypto"]["kdfparams"]["p"] = options.scryptP;
+  ret["crypto"]["kdfparams"]["r"] = options.scryptR;
+  ret["crypto"]["kdfparams"]["salt"] = salt.hex();
+  ret["crypto"]["mac"] = mac.hex();
+  ret["id"] = randomUUID();
+  ret["version"] = 3;
+  error.setCode(0);
+  return ret;
+}
+
+std::optional<dev::Secret> Keystore::decrypt(const json& keystore, const std::string& password, Error &error) {
+  return decryptWith(keystore, password, error, nullptr);
+}
+
+std::size_t Keystore::memoryCost(const json& keystore) {
+  KdfParams params;
+  try {
+    if (!keystore.is_object() || !parseKdf(keystore, params) || !params.scrypt) return 0;
+  } catch (std::exception &e) {
+    return 0;
+  }
+  return static_cast<std::size_t>(std::min<uint64_t>(scryptMemory(params.n, params.r, params.p), SIZE_MAX));
+}
+
+void Keystore::exportFile(
+  const dev::Secret& secret, const std::string& password,
+  boost::filesystem::path filePath, Error &error, Options options
+) {
+  Error encryptErr;
+  json keystore = encrypt(secret, password, encryptErr, options);
+  if (encryptErr.getCode() != 0) {
+    error.setCode(encryptErr.getCode());
+    return;
+  }
+  Utils::writeJSONFile(keystore, filePath, error);
+}
+
+std::optional<Signer> Keystore::importFile(
+  boost::filesystem::path filePath, const std::string& password, Error &error
+) {
+  Error readErr;
+  json keystore = Utils::readJSONFile(filePath, readErr);
+  if (readErr.getCode() != 0) {
+    error.setCode(readErr.getCode());
+    return std::nullopt;
+  }
+  std::optional<dev::Secret> secret = decrypt(keystore, password, error);
+  if (!secret) return std::nullopt;
+  return Signer(*secret);
+}
+
+Keystore::LoadResult Keystore::load(const std::vector<Entry>& entries, LoadOptions options) {
+  LoadResult ret;
+  ret.signers.resize(entries.size());
+  ret.errors.assign(entries.size(), 0);
+  unsigned int threads = options.threads;
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, entries.size())));
+  MemoryBudget budget(std::max<uint64_t>(1, options.memoryBudget));
+
+  // Files are taken one at a time, since their derivations can cost very
+  // different amounts. Reading and MAC checks run outside the budget.
+  std::atomic<std::size_t> next = 0;
+  auto work = [&]() {
+    for (std::size_t i = next++; i < entries.size(); i = next++) {
+      Error readErr;
+      boost::filesystem::path filePath = entries[i].path;
+      json keystore = Utils::readJSONFile(filePath, readErr);
+      if (readErr.getCode() != 0) { ret.errors[i] = readErr.getCode(); continue; }
+      Error err;
+      std::optional<dev::Secret> secret = decryptWith(keystore, entries[i].password, err, &budget);
+      if (!secret) { ret.errors[i] = err.getCode(); continue; }
+      ret.signers[i].emplace(*secret);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < threads; t++) workers.emplace_back(work);
+  work();
+  for (std::thread& worker : workers) worker.join();
+
+  ret.peakDerivations = budget.peak();
+  ret.failed = std::count_if(ret.errors.begin(), ret.errors.end(), [](uint64_t code){ return code != 0; });
+  return ret;
+}
@@ -0,0 +1,91 @@
+#include <limits>
+
+#include <web3cpp/Log.h>
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/devcore/CommonData.h>
+
+namespace {
+  /// Decode a fixed-size hash, rejecting strings of the wrong length.
+  template <unsigned N> bool readHash(const json& value, dev::FixedHash<N>& out) {
+    if (!value.is_string()) return false;
+    const std::string& str = value.get_ref<const std::string&>();
+    if (str.size() != 2 + N * 2 || str[0] != '0' || (str[1] != 'x' && str[1] != 'X')) return false;
+    try {
+      out = dev::FixedHash<N>(str);
+    } catch (std::exception &e) {
+      return false;
+    }
+    return true;
+  }
+
+  /// Decode an optional quantity. `null` or a missing field leave the default value.
+  bool readQuantity(const json& log, const char* field, uint64_t& out) {
+    auto it = log.find(field);
+    if (it == log.end() || it->is_null()) return true;
+    if (!it->is_string()) return false;
+    std::optional<Quantity> q = Quantity::fromHex(it->get_ref<const std::string&>());
+    if (!q || q->value() > std::numeric_limits<uint64_t>::max()) return false;
+    out = static_cast<uint64_t>(q->value());
+    return true;
+  }
+
+  /// Decode an optional hash. `null` or a missing field leave the default value.
+  bool readOptionalHash(const json& log, const char* field, dev::h256& out) {
+    auto it = log.find(field);
+    if (it == log.end() || it->is_null()) return true;
+    return readHash(*it, out);
+  }
+}
+
+std::optional<Log> Log::fromJSON(const json& log) {
+  if (!log.is_object()) return std::nullopt;
+  Log ret;
+  auto address = log.find("address");
+  if (address == log.end() || !readHash(*address, ret.address)) return std::nullopt;
+
+  auto topics = log.find("topics");
+  if (topics != log.end()) {
+    if (!topics->is_array()) return std::nullopt;
+    ret.topics.resize(topics->size());
+    for (std::size_t i = 0; i < topics->size(); i++) {
+      if (!readHash((*topics)[i], ret.topics[i])) return std::nullopt;
+    }
+  }
+
+  auto data = log.find("data");
+  if (data != log.end()) {
+    if (!data->is_string()) return std::nullopt;
+    try {
+      ret.data = dev::fromHex(data->get_ref<const std::string&>(), dev::WhenError::Throw);
+    } catch (std::exception &e) {
+      return std::nullopt;
+    }
+  }
+
+  if (
+    !readQuantity(log, "blockNumber", ret.blockNumber) ||
+    !readQuantity(log, "transactionIndex", ret.transactionIndex) ||
+    !readQuantity(log, "logIndex", ret.logIndex) ||
+    !readOptionalHash(log, "blockHash", ret.blockHash) ||
+    !readOptionalHash(log, "transactionHash", ret.transactionHash)
+  ) return std::nullopt;
+
+  auto removed = log.find("removed");
+  if (removed != log.end() && removed->is_boolean()) ret.removed = removed->get<bool>();
+  return ret;
+}
+
+json Log::toJSON() const {
+  json ret;
+  ret["address"] = "0x" + this->address.hex();
+  ret["topics"] = json::array();
+  for (const dev::h256& topic : this->topics) ret["topics"].push_back("0x" + topic.hex());
+  ret["data"] = dev::toHexPrefixed(this->data);
+  ret["blockNumber"] = Quantity(this->blockNumber).hex();
+  ret["blockHash"] = "0x" + this->blockHash.hex();
+  ret["transactionHash"] = "0x" + this->transactionHash.hex();
+  ret["transactionIndex"] = Quantity(this->transactionIndex).hex();
+  ret["logIndex"] = Quantity(this->logIndex).hex();
+  ret["removed"] = this->removed;
+  return ret;
+}
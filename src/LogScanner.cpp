@@ -0,0 +1,237 @@
+#include <web3cpp/LogScanner.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+namespace {
+  /// Outcome of a single `eth_getLogs` request.
+  enum class ChunkStatus { Ok, TooLarge, Failed };
+
+  /// State shared between the workers and the delivering thread of a scan.
+  struct ScanState {
+    std::mutex lock;
+    std::condition_variable cv;
+    uint64_t cursor;          // First block not yet handed to a worker.
+    uint64_t toBlock;         // Last block of the scan.
+    uint64_t chunk;           // Current chunk size.
+    bool exhausted = false;   // Whether every block was handed to a worker.
+    std::size_t inFlight = 0; // Chunks being fetched.
+    bool stop = false;        // Set on error or when the consumer stops.
+    json error;               // First error found.
+    /// Fetched chunks waiting for delivery, keyed by first block. Value is (last block, logs).
+    std::map<uint64_t, std::pair<uint64_t, std::vector<Log>>> done;
+  };
+}
+
+LogScanner::LogScanner(const std::unique_ptr<Provider>& provider)
+  : LogScanner(provider, Options()) {}
+
+LogScanner::LogScanner(const std::unique_ptr<Provider>& provider, Options options)
+  : _provider(provider), _options(options) {
+  if (this->_options.minChunk == 0) this->_options.minChunk = 1;
+  if (this->_options.maxChunk < this->_options.minChunk) this->_options.maxChunk = this->_options.minChunk;
+  this->_options.initialChunk = std::clamp(
+    this->_options.initialChunk, this->_options.minChunk, this->_options.maxChunk
+  );
+  if (this->_options.parallelism == 0) this->_options.parallelism = 1;
+}
+
+bool LogScanner::isRangeTooLarge(const json& error) {
+  if (!error.is_object()) return false;
+  if (error.contains("code") && error["code"].is_number() && error["code"] == -32005) return true;
+  if (!error.contains("message") || !error["message"].is_string()) return false;
+  std::string msg = error["message"].get<std::string>();
+  std::transform(msg.begin(), msg.end(), msg.begin(), [](unsigned char c){ return std::tolower(c); });
+  static const char* hints[] = {
+    "more than", "too many", "too large", "block range", "limit exceeded",
+    "size exceeded", "exceed max", "timed out", "timeout"
+  };
+  for (const char* hint : hints) {
+    if (msg.find(hint) != std::string::npos) return true;
+  }
+  return false;
+}
+
+std::future<json> LogScanner::scan(
+  json filter, uint64_t fromBlock, uint64_t toBlock, LogStream::Callback onLog
+) {
+  return std::async(std::launch::async, [=]() mutable {
+    json ret;
+    filter.erase("blockhash");
+    filter.erase("blockHash");
+    filter["fromBlock"] = Quantity(fromBlock).hex();
+    filter["toBlock"] = Quantity(toBlock).hex();
+    Error err;
+    RPC::eth_getLogs(filter, err);
+    if (err.getCode() != 0) {
+      ret["error"]["message"] = err.what();
+      return ret;
+    }
+    if (fromBlock > toBlock) {
+      ret["error"]["message"] = "fromBlock is after toBlock";
+      return ret;
+    }
+
+    ScanState state;
+    state.cursor = fromBlock;
+    state.toBlock = toBlock;
+    state.chunk = this->_options.initialChunk;
+    const Options& opts = this->_options;
+
+    // Single eth_getLogs request for a range, decoded straight into a vector.
+    auto fetchChunk = [&](uint64_t from, uint64_t to, std::vector<Log>& out, json& error) {
+      json chunkFilter = filter;
+      chunkFilter["fromBlock"] = Quantity(from).hex();
+      chunkFilter["toBlock"] = Quantity(to).hex();
+      Error chunkErr;
+      std::string rpcStr = RPC::eth_getLogs(chunkFilter, chunkErr).dump();
+      std::vector<Log> logs;
+      json response;
+      try {
+        Net::HTTPStreamRequest(this->_provider, Net::RequestTypes::POST, rpcStr,
+          [&](std::istream& in){
+            response = LogStream::parse(in, [&](const Log& log){
+              logs.push_back(log);
+              return true;
+            });
+          }
+        );
+      } catch (std::exception &e) {
+        error = json::object();
+        error["message"] = e.what();
+        return ChunkStatus::Failed;
+      }
+      if (response.contains("error")) {
+        error = response["error"];
+        return (isRangeTooLarge(error)) ? ChunkStatus::TooLarge : ChunkStatus::Failed;
+      }
+      // Sparse full-sized chunks mean we can afford bigger ones.
+      if (logs.size() < opts.sparseThreshold) {
+        std::scoped_lock lock(state.lock);
+        if (to - from + 1 >= state.chunk) state.chunk = std::min(opts.maxChunk, state.chunk * 2);
+      }
+      out.insert(out.end(), std::make_move_iterator(logs.begin()), std::make_move_iterator(logs.end()));
+      return ChunkStatus::Ok;
+    };
+
+    // Fetch a range with retries, bisecting it while the node says it is too large.
+    std::function<bool(uint64_t, uint64_t, std::vector<Log>&, json&)> fetchRange;
+    fetchRange = [&](uint64_t from, uint64_t to, std::vector<Log>& out, json& error) {
+      ChunkStatus status = ChunkStatus::Failed;
+      for (unsigned int attempt = 0; attempt <= opts.maxRetries; attempt++) {
+        {
+          std::scoped_lock lock(state.lock);
+          if (state.stop) return false;
+        }
+        status = fetchChunk(from, to, out, error);
+        if (status != ChunkStatus::Failed) break;
+        if (attempt < opts.maxRetries) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(100 << std::min(attempt, 5u)));
+        }
+      }
+      if (status == ChunkStatus::Ok) return true;
+      if (status == ChunkStatus::TooLarge && to > from) {
+        uint64_t half = (to - from + 1) / 2;
+        {
+          std::scoped_lock lock(state.lock);
+          state.chunk = std::max(opts.minChunk, std::min(state.chunk, half));
+        }
+        uint64_t mid = from + half - 1;
+        return fetchRange(from, mid, out, error) && fetchRange(mid + 1, to, out, error);
+      }
+      // The node's error can be anything, so the range goes on a copy.
+      json wrapped = (error.is_object()) ? error : json::object();
+      if (!wrapped.contains("message")) {
+        wrapped["message"] = (error.is_string()) ? error.get<std::string>() : "Failed to fetch logs";
+      }
+      wrapped["fromBlock"] = Quantity(from).hex();
+      wrapped["toBlock"] = Quantity(to).hex();
+      error = std::move(wrapped);
+      return false;
+    };
+
+    // Workers claim the next chunk in block order, so the lowest undelivered
+    // chunk is always either done or in flight. They stop claiming while too
+    // many fetched chunks are waiting for delivery.
+    const std::size_t maxBuffered = opts.parallelism * 2;
+    auto worker = [&]{
+      while (true) {
+        uint64_t from, to;
+        {
+          std::unique_lock lock(state.lock);
+          state.cv.wait(lock, [&]{
+            return state.stop || state.exhausted || state.done.size() < maxBuffered;
+          });
+          if (state.stop || state.exhausted) return;
+          from = state.cursor;
+          to = (state.toBlock - from < state.chunk) ? state.toBlock : from + state.chunk - 1;
+          if (to == state.toBlock) state.exhausted = true; else state.cursor = to + 1;
+          state.inFlight++;
+        }
+        std::vector<Log> logs;
+        json error;
+        bool ok = fetchRange(from, to, logs, error);
+        {
+          std::scoped_lock lock(state.lock);
+          state.inFlight--;
+          if (ok) {
+            state.done.emplace(from, std::make_pair(to, std::move(logs)));
+          } else if (!state.stop) {
+            state.stop = true;
+            state.error = error;
+          }
+        }
+        state.cv.notify_all();
+      }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (std::size_t i = 0; i < opts.parallelism; i++) {
+      workers.push_back(std::async(std::launch::async, worker));
+    }
+
+    // Deliver chunks in block order from this thread.
+    uint64_t nextDeliver = fromBlock;
+    uint64_t delivered = 0;
+    {
+      std::unique_lock lock(state.lock);
+      while (true) {
+        state.cv.wait(lock, [&]{
+          return state.stop ||
+            (!state.done.empty() && state.done.begin()->first == nextDeliver) ||
+            (state.exhausted && state.inFlight == 0 && state.done.empty());
+        });
+        if (state.stop || state.done.empty()) break;
+        auto node = state.done.extract(state.done.begin());
+        nextDeliver = node.mapped().first + 1;
+        lock.unlock();
+        state.cv.notify_all();
+        bool keepGoing = true;
+        for (const Log& log : node.mapped().second) {
+          delivered++;
+          if (!onLog(log)) { keepGoing = false; break; }
+        }
+        lock.lock();
+        if (!keepGoing) { state.stop = true; break; }
+      }
+    }
+    state.cv.notify_all();
+    for (std::future<void>& w : workers) w.get();
+
+    if (!state.error.is_null()) {
+      ret["error"] = state.error;
+    } else {
+      ret["result"] = delivered;
+    }
+    return ret;
+  });
+}
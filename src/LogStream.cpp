@@ -0,0 +1,161 @@
+#include <web3cpp/LogStream.h>
+
+namespace {
+  /**
+   * SAX handler for `eth_getLogs` responses.
+   * Envelope fields (`jsonrpc`, `id`, `error`) are kept as-is, while the
+   * elements of the `result` array are built one at a time, decoded and
+   * handed to the callback, then dropped.
+   */
+  class LogsSAX : public nlohmann::json_sax<json> {
+    private:
+      const LogStream::Callback& _onLog;
+      json& _envelope;
+      uint64_t _count = 0;        // Number of logs delivered.
+      std::size_t _depth = 0;     // Nesting depth. 1 is inside the envelope object.
+      std::string _envelopeKey;   // Last key read at depth 1.
+      bool _inResult = false;     // Whether we are inside the "result" array.
+      std::vector<json*> _stack;  // Containers of the value being built.
+      json _value;                // The value being built.
+      std::string _key;           // Last key read inside the value being built.
+
+      // Store a value in the one being built, or start a new one.
+      json* _put(json&& value) {
+        if (_stack.empty()) { _value = std::move(value); return &_value; }
+        json& top = *_stack.back();
+        if (top.is_object()) return &(top[_key] = std::move(value));
+        top.push_back(std::move(value));
+        return &top.back();
+      }
+
+      // Called when the value being built is complete.
+      bool _done() {
+        if (!_inResult) {
+          _envelope[_envelopeKey] = std::move(_value);
+          return true;
+        }
+        std::optional<Log> log = Log::fromJSON(_value);
+        if (!log) { error = "Invalid log object at index " + std::to_string(_count); return false; }
+        _count++;
+        if (!_onLog(*log)) { stopped = true; return false; }
+        return true;
+      }
+
+      bool _scalar(json&& value) {
+        if (_depth == 0) { error = "Response is not an object"; return false; }
+        _put(std::move(value));
+        return (_stack.empty()) ? _done() : true;
+      }
+
+      bool _start(json&& container) {
+        if (_depth == 0) {
+          if (!container.is_object()) { error = "Response is not an object"; return false; }
+          _depth++;
+          return true;
+        }
+        if (_depth == 1 && _stack.empty() && _envelopeKey == "result" && container.is_array()) {
+          _inResult = true;
+          _depth++;
+          return true;
+        }
+        _stack.push_back(_put(std::move(container)));
+        _depth++;
+        return true;
+      }
+
+      bool _end() {
+        _depth--;
+        if (_stack.empty()) {
+          if (_inResult && _depth == 1) { _inResult = false; _envelope["result"] = _count; }
+          return true;
+        }
+        _stack.pop_back();
+        return (_stack.empty()) ? _done() : true;
+      }
+
+    public:
+      std::string error;    // Set if the response or one of the logs is malformed.
+      bool stopped = false; // Set if the callback asked to stop.
+
+      LogsSAX(const LogStream::Callback& onLog, json& envelope)
+        : _onLog(onLog), _envelope(envelope) {}
+
+      bool null() override { return _scalar(nullptr); }
+      bool boolean(bool val) override { return _scalar(val); }
+      bool number_integer(number_integer_t val) override { return _scalar(val); }
+      bool number_unsigned(number_unsigned_t val) override { return _scalar(val); }
+      bool number_float(number_float_t val, const string_t&) override { return _scalar(val); }
+      bool string(string_t& val) override { return _scalar(std::move(val)); }
+      bool binary(binary_t& val) override { return _scalar(json::binary(std::move(val))); }
+      bool start_object(std::size_t) override { return _start(json::object()); }
+      bool start_array(std::size_t) override { return _start(json::array()); }
+      bool end_object() override { return _end(); }
+      bool end_array() override { return _end(); }
+
+      bool key(string_t& val) override {
+        if (_depth == 1) _envelopeKey = val; else _key = val;
+        return true;
+      }
+
+      bool parse_error(
+        std::size_t, const std::string&, const nlohmann::detail::exception& ex
+      ) override {
+        error = ex.what();
+        return false;
+      }
+  };
+}
+
+json LogStream::parse(std::istream& in, const Callback& onLog) {
+  json ret = json::object();
+  LogsSAX sax(onLog, ret);
+  json::sax_parse(in, &sax);
+  if (!sax.error.empty()) {
+    json err;
+    err["error"]["message"] = sax.error;
+    return err;
+  }
+  return ret;
+}
+
+LogStream::LogStream(
+  const std::unique_ptr<Provider>& provider, const std::string& reqBody,
+  std::size_t capacity
+) : _queue(capacity) {
+  this->_reader = std::thread([this, &provider, reqBody]{
+    json response;
+    try {
+      Net::HTTPStreamRequest(provider, Net::RequestTypes::POST, reqBody,
+        [&](std::istream& in){
+          response = LogStream::parse(in, [&](const Log& log){
+            return this->_queue.push(log);
+          });
+        }
+      );
+    } catch (std::exception &e) {
+      response = json::object();
+      response["error"]["message"] = e.what();
+    }
+    this->_response = std::move(response);
+    this->_queue.close();
+  });
+}
+
+LogStream::LogStream(const json& response) : _queue(1), _response(response) {
+  this->_queue.close();
+}
+
+LogStream::~LogStream() {
+  this->_queue.close();
+  if (this->_reader.joinable()) this->_reader.join();
+}
+
+bool LogStream::next(Log& out) {
+  return this->_queue.pop(out);
+}
+
+const json& LogStream::response() {
+  this->_queue.close();
+  if (this->_reader.joinable()) this->_reader.join();
+  return this->_response;
+}
@@ -0,0 +1,187 @@
+#include <web3cpp/LogSubscription.h>
+
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/SHA3.h>
+
+namespace {
+  /// Get the bloom bits a hex value sets.
+  dev::eth::LogBloom bloomBits(const json& value) {
+    dev::bytes bytes = dev::fromHex(value.get<std::string>());
+    return dev::sha3(dev::bytesConstRef(&bytes)).bloomPart<3, 256>();
+  }
+}
+
+LogSubscription::LogSubscription(
+  const std::unique_ptr<Provider>& provider, HeadTracker& heads,
+  json filter, Callback onLog
+) : LogSubscription(provider, heads, std::move(filter), std::move(onLog), Options()) {}
+
+LogSubscription::LogSubscription(
+  const std::unique_ptr<Provider>& provider, HeadTracker& heads,
+  json filter, Callback onLog, Options options
+) : _provider(provider), _heads(heads), _filter(std::move(filter)),
+  _onLog(std::move(onLog)), _options(options) {
+  for (const char* key : {"fromBlock", "toBlock", "blockHash", "blockhash"}) this->_filter.erase(key);
+
+  if (this->_filter.contains("address")) {
+    const json& address = this->_filter["address"];
+    if (address.is_string()) {
+      this->_addressBits.push_back(bloomBits(address));
+    } else if (address.is_array()) {
+      for (const json& a : address) if (a.is_string()) this->_addressBits.push_back(bloomBits(a));
+    }
+  }
+  if (this->_filter.contains("topics") && this->_filter["topics"].is_array()) {
+    for (const json& topic : this->_filter["topics"]) {
+      std::vector<dev::eth::LogBloom> options;
+      if (topic.is_string()) {
+        options.push_back(bloomBits(topic));
+      } else if (topic.is_array()) {
+        for (const json& t : topic) {
+          // A null option matches anything, so the whole position does.
+          if (!t.is_string()) { options.clear(); break; }
+          options.push_back(bloomBits(t));
+        }
+      }
+      this->_topicBits.push_back(std::move(options));
+    }
+  }
+}
+
+LogSubscription::~LogSubscription() { this->stop(); }
+
+void LogSubscription::start(Error &err) {
+  RPC::eth_getLogs(this->_filter, err);
+  if (err.getCode() != 0) return;
+  {
+    std::scoped_lock lock(this->_lock);
+    if (this->_listenerId != 0) return;
+    this->_listenerId = UINT64_MAX;  // Reserved while subscribing
+  }
+  uint64_t id = this->_heads.subscribe([this](const HeadTracker::Event& event){ this->_onHead(event); });
+  bool stopped;
+  {
+    std::scoped_lock lock(this->_lock);
+    stopped = (this->_listenerId != UINT64_MAX);  // stop() was called meanwhile
+    if (!stopped) this->_listenerId = id;
+  }
+  if (stopped) this->_heads.unsubscribe(id);
+}
+
+void LogSubscription::stop() {
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    listenerId = this->_listenerId;
+    this->_listenerId = 0;
+  }
+  if (listenerId != 0 && listenerId != UINT64_MAX) this->_heads.unsubscribe(listenerId);
+}
+
+bool LogSubscription::running() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_listenerId != 0;
+}
+
+LogSubscription::Stats LogSubscription::stats() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
+
+bool LogSubscription::mayMatch(const dev::eth::LogBloom& bloom) const {
+  if (!this->_addressBits.empty()) {
+    bool any = false;
+    for (const dev::eth::LogBloom& bits : this->_addressBits) {
+      if (bloom.contains(bits)) { any = true; break; }
+    }
+    if (!any) return false;
+  }
+  for (const std::vector<dev::eth::LogBloom>& position : this->_topicBits) {
+    if (position.empty()) continue;
+    bool any = false;
+    for (const dev::eth::LogBloom& bits : position) {
+      if (bloom.contains(bits)) { any = true; break; }
+    }
+    if (!any) return false;
+  }
+  return true;
+}
+
+bool LogSubscription::_fetch(const std::string& blockHash, std::vector<Log>& logs) {
+  json filter = this->_filter;
+  filter["blockHash"] = blockHash;
+  Error err;
+  const std::string request = RPC::eth_getLogs(filter, err).dump();
+  if (err.getCode() != 0) return false;
+  for (unsigned int attempt = 0; attempt <= this->_options.maxRetries; attempt++) {
+    {
+      std::scoped_lock lock(this->_lock);
+      this->_stats.requests++;
+    }
+    try {
+      json res = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, request));
+      if (!res.contains("result") || !res["result"].is_array()) continue;
+      logs.clear();
+      for (const json& item : res["result"]) {
+        std::optional<Log> log = Log::fromJSON(item);
+        if (log) logs.push_back(std::move(*log));
+      }
+      return true;
+    } catch (std::exception &e) {
+      // Network error or malformed response, try again.
+    }
+  }
+  return false;
+}
+
+void LogSubscription::_onHead(const HeadTracker::Event& event) {
+  // Removed blocks come newest first, and so do their logs.
+  for (const HeadTracker::Header& removed : event.removed) {
+    for (auto it = this->_delivered.begin(); it != this->_delivered.end(); it++) {
+      if (it->first != removed.hash) continue;
+      for (auto log = it->second.rbegin(); log != it->second.rend(); log++) {
+        log->removed = true;
+        this->_onLog(*log);
+      }
+      {
+        std::scoped_lock lock(this->_lock);
+        this->_stats.removed += it->second.size();
+      }
+      this->_delivered.erase(it);
+      break;
+    }
+  }
+
+  const HeadTracker::Header& head = event.head;
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_stats.blocks++;
+  }
+  auto bloom = head.header.find("logsBloom");
+  if (this->_options.useBloom && bloom != head.header.end() && bloom->is_string()) {
+    dev::bytes bytes = dev::fromHex(bloom->get<std::string>());
+    if (bytes.size() == dev::eth::LogBloom::size && !this->mayMatch(dev::eth::LogBloom(bytes))) {
+      std::scoped_lock lock(this->_lock);
+      this->_stats.skipped++;
+      return;
+    }
+  }
+
+  std::vector<Log> logs;
+  if (!this->_fetch(head.hash, logs)) {
+    std::scoped_lock lock(this->_lock);
+    this->_stats.failed++;
+    return;
+  }
+  for (const Log& log : logs) this->_onLog(log);
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_stats.logs += logs.size();
+  }
+  if (logs.empty()) return;
+  // Only blocks the tracker can still report as removed are worth keeping.
+  this->_delivered.emplace_back(head.hash, std::move(logs));
+  while (this->_delivered.size() > this->_heads.getOptions().historySize) this->_delivered.pop_front();
+}
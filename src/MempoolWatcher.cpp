@@ -0,0 +1,289 @@
+#include <web3cpp/MempoolWatcher.h>
+
+#include <algorithm>
+
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/devcore/CommonData.h>
+
+MempoolWatcher::MempoolWatcher(const std::unique_ptr<Provider>& provider)
+  : MempoolWatcher(provider, Options()) {}
+
+MempoolWatcher::MempoolWatcher(const std::unique_ptr<Provider>& provider, Options options)
+  : _provider(provider), _options(options), _queue(options.queueCapacity) {
+  if (this->_options.batchSize == 0) this->_options.batchSize = 1;
+  if (this->_options.maxInFlight == 0) this->_options.maxInFlight = 1;
+  if (this->_options.pollInterval.count() <= 0) this->_options.pollInterval = std::chrono::milliseconds(1);
+}
+
+MempoolWatcher::~MempoolWatcher() { this->stop(); }
+
+void MempoolWatcher::start() {
+  std::scoped_lock lock(this->_runLock);
+  if (this->_watcher.joinable()) return;
+  this->_stop = false;
+  for (std::size_t i = 0; i < this->_options.maxInFlight; i++) {
+    this->_fetchers.emplace_back([this]{ this->_runFetcher(); });
+  }
+  this->_watcher = std::thread([this]{ this->_run(); });
+}
+
+void MempoolWatcher::stop() {
+  std::thread watcher;
+  std::vector<std::thread> fetchers;
+  {
+    std::scoped_lock lock(this->_runLock);
+    this->_stop = true;
+    watcher = std::move(this->_watcher);
+    fetchers = std::move(this->_fetchers);
+    this->_fetchers.clear();
+  }
+  {
+    // Taken so a fetcher can't miss the wake-up between its check and its wait.
+    std::scoped_lock lock(this->_lock);
+    this->_hashes.clear();
+  }
+  this->_wake.notify_all();
+  this->_hashReady.notify_all();
+  if (watcher.joinable()) watcher.join();
+  for (std::thread& fetcher : fetchers) fetcher.join();
+}
+
+bool MempoolWatcher::running() const {
+  std::scoped_lock lock(this->_runLock);
+  return this->_watcher.joinable() && !this->_stop;
+}
+
+MempoolWatcher::Backend MempoolWatcher::backend() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_backend;
+}
+
+MempoolWatcher::Stats MempoolWatcher::stats() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
+
+bool MempoolWatcher::_sleep() {
+  std::unique_lock lock(this->_runLock);
+  return !this->_wake.wait_for(lock, this->_options.pollInterval, [&]{ return this->_stop.load(); });
+}
+
+json MempoolWatcher::_request(const json& request) {
+  return json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, request.dump()));
+}
+
+void MempoolWatcher::_run() {
+  if (this->_options.seedFromTxPool) {
+    try { this->_seed(); } catch (std::exception &e) {}
+  }
+  bool subscribe = this->_options.subscribe;
+  while (!this->_stop) {
+    try {
+      if (subscribe) {
+        // Returns after the connection drops, so wait a bit before reconnecting.
+        if (!this->_runSubscription()) subscribe = false; else this->_sleep();
+      } else if (!this->_runFilter()) {
+        // Nothing to follow pending transactions with, keep checking in case the node changes.
+        this->_sleep();
+      }
+    } catch (std::exception &e) {
+      // Network error, try the same backend again in a while.
+      this->_sleep();
+    }
+  }
+  std::scoped_lock lock(this->_lock);
+  this->_backend = Backend::None;
+}
+
+bool MempoolWatcher::_runSubscription() {
+  Error err;
+  json request = RPC::eth_subscribe("newPendingTransactions", err);
+  bool confirmed = false;
+  try {
+    Net::WSSubscribe(this->_provider, this->_options.wsPort, request,
+      [&](const json& msg){
+        if (!confirmed) {
+          // First message is the response to eth_subscribe.
+          if (!msg.contains("result") || !msg["result"].is_string()) return false;
+          confirmed = true;
+          std::scoped_lock lock(this->_lock);
+          this->_backend = Backend::Subscription;
+          return !this->_stop;
+        }
+        if (msg.value("method", "") != "eth_subscription") return true;
+        if (!msg.contains("params") || !msg["params"].contains("result")) return true;
+        const json& result = msg["params"]["result"];
+        // Some nodes send the whole transaction instead of just the hash.
+        if (result.is_string()) {
+          this->_onHashes({result.get<std::string>()});
+        } else if (result.is_object() && result.contains("hash") && result["hash"].is_string()) {
+          this->_onHashes({result["hash"].get<std::string>()});
+        }
+        return !this->_stop;
+      },
+      [&]{ return !this->_stop; }, this->_options.pollInterval
+    );
+  } catch (std::exception &e) {
+    // Failing before the subscription went through means there is no
+    // WebSocket endpoint, anything later is a dropped connection.
+    if (!confirmed) return false;
+    throw;
+  }
+  return confirmed;
+}
+
+bool MempoolWatcher::_runFilter() {
+  json res = this->_request(RPC::eth_newPendingTransactionFilter());
+  if (!res.contains("result") || !res["result"].is_string()) return false;
+  const std::string filterId = res["result"].get<std::string>();
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_backend = Backend::Filter;
+  }
+
+  while (this->_sleep()) {
+    Error err;
+    json changes = this->_request(RPC::eth_getFilterChanges(filterId, err));
+    // Filters expire on the node after a while without polls, make a new one.
+    if (changes.contains("error")) return true;
+    if (!changes.contains("result") || !changes["result"].is_array() || changes["result"].empty()) continue;
+    std::vector<std::string> hashes;
+    hashes.reserve(changes["result"].size());
+    for (const json& hash : changes["result"]) {
+      if (hash.is_string()) hashes.push_back(hash.get<std::string>());
+    }
+    this->_onHashes(hashes);
+  }
+  Error err;
+  try {
+    this->_request(RPC::eth_uninstallFilter(filterId, err));
+  } catch (std::exception &e) {}
+  return true;
+}
+
+void MempoolWatcher::_seed() {
+  json res = this->_request(RPC::geth_txPoolContent());
+  if (!res.contains("result") || !res["result"].is_object()) return;
+  const json& result = res["result"];
+  if (!result.contains("pending") || !result["pending"].is_object()) return;
+  // Grouped by sender, then by nonce.
+  std::vector<std::string> hashes;
+  for (const auto& [sender, txs] : result["pending"].items()) {
+    if (!txs.is_object()) continue;
+    for (const auto& [nonce, tx] : txs.items()) {
+      if (tx.is_object() && tx.contains("hash") && tx["hash"].is_string()) {
+        hashes.push_back(tx["hash"].get<std::string>());
+      }
+    }
+  }
+  this->_onHashes(hashes);
+}
+
+void MempoolWatcher::_onHashes(const std::vector<std::string>& hashes) {
+  if (hashes.empty()) return;
+  const auto now = std::chrono::steady_clock::now();
+  std::size_t added = 0;
+  {
+    std::scoped_lock lock(this->_lock);
+    for (const std::string& hash : hashes) {
+      if (!this->_seen.insert(hash).second) { this->_stats.duplicates++; continue; }
+      this->_seenOrder.push_back(hash);
+      if (this->_seenOrder.size() > this->_options.seenSize) {
+        this->_seen.erase(this->_seenOrder.front());
+        this->_seenOrder.pop_front();
+      }
+      this->_hashes.emplace_back(hash, now);
+      this->_stats.announced++;
+      added++;
+    }
+  }
+  if (added == 1) this->_hashReady.notify_one(); else if (added > 1) this->_hashReady.notify_all();
+}
+
+void MempoolWatcher::_runFetcher() {
+  std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>> batch;
+  while (true) {
+    {
+      std::unique_lock lock(this->_lock);
+      this->_hashReady.wait(lock, [&]{ return this->_stop || !this->_hashes.empty(); });
+      if (this->_stop) return;
+      // Take whatever is waiting instead of waiting for a full batch.
+      std::size_t count = std::min(this->_options.batchSize, this->_hashes.size());
+      batch.assign(
+        std::make_move_iterator(this->_hashes.begin()),
+        std::make_move_iterator(this->_hashes.begin() + count)
+      );
+      this->_hashes.erase(this->_hashes.begin(), this->_hashes.begin() + count);
+    }
+    try {
+      this->_fetch(batch);
+    } catch (std::exception &e) {
+      // Network error, the batch is lost. Pending transactions are short-lived
+      // anyway, so retrying would mostly fetch mined ones.
+      std::scoped_lock lock(this->_lock);
+      this->_stats.missing += batch.size();
+    }
+  }
+}
+
+void MempoolWatcher::_fetch(std::vector<std::pair<std::string, std::chrono::steady_clock::time_point>>& batch) {
+  const bool raw = this->_raw;
+  std::vector<json> requests;
+  std::vector<std::size_t> index;  // Position in the batch of each request
+  requests.reserve(batch.size());
+  for (std::size_t i = 0; i < batch.size(); i++) {
+    Error err;
+    json req = (raw)
+      ? RPC::eth_getRawTransactionByHash(batch[i].first, err)
+      : RPC::eth_getTransactionByHash(batch[i].first, err);
+    if (err.getCode() != 0) continue;
+    requests.push_back(std::move(req));
+    index.push_back(i);
+  }
+  if (requests.empty()) return;
+  std::vector<json> responses = Net::HTTPBatchRequest(this->_provider, std::move(requests));
+
+  // Nodes without the raw method reject it as unknown, switch to JSON objects for good.
+  if (raw && !responses.empty() && responses[0].contains("error")
+    && responses[0]["error"].value("code", 0) == -32601) {
+    this->_raw = false;
+    this->_fetch(batch);
+    return;
+  }
+
+  uint64_t missing = 0;
+  for (std::size_t i = 0; i < responses.size() && i < index.size(); i++) {
+    json& res = responses[i];
+    if (!res.contains("result") || res["result"].is_null()) { missing++; continue; }
+    Pending pending;
+    pending.hash = std::move(batch[index[i]].first);
+    pending.announced = batch[index[i]].second;
+    if (raw) {
+      if (!res["result"].is_string()) { missing++; continue; }
+      pending.raw = dev::fromHex(res["result"].get<std::string>());
+      try {
+        pending.transaction.emplace(dev::bytesConstRef(&pending.raw), this->_options.check);
+      } catch (std::exception &e) {
+        // Delivered with the raw bytes only, e.g. a type the decoder doesn't know.
+      }
+    } else {
+      pending.object = std::move(res["result"]);
+    }
+    pending.ready = std::chrono::steady_clock::now();
+    this->_deliver(std::move(pending));
+  }
+  if (missing > 0) {
+    std::scoped_lock lock(this->_lock);
+    this->_stats.missing += missing;
+  }
+}
+
+void MempoolWatcher::_deliver(Pending pending) {
+  const bool decoded = pending.transaction.has_value();
+  const bool queued = this->_queue.tryPush(std::move(pending));
+  std::scoped_lock lock(this->_lock);
+  this->_stats.fetched++;
+  if (decoded) this->_stats.decoded++;
+  if (!queued) this->_stats.dropped++;
+}
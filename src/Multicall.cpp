@@ -0,0 +1,266 @@
+#include <web3cpp/Multicall.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+namespace {
+  /// `aggregate3((address,bool,bytes)[])`
+  const std::string aggregate3Selector = "82ad56cb";
+
+  /// Append a 32-byte big endian word.
+  void appendWord(dev::bytes& out, uint64_t value) {
+    dev::bytes word = dev::toBigEndian(dev::u256(value));
+    out.insert(out.end(), word.begin(), word.end());
+  }
+
+  /// Read a 32-byte word that must fit in 64 bits.
+  std::optional<uint64_t> readWord(const dev::bytes& data, uint64_t pos) {
+    if (pos > data.size() || data.size() - pos < 32) return std::nullopt;
+    for (std::size_t i = 0; i < 24; i++) if (data[pos + i] != 0) return std::nullopt;
+    uint64_t ret = 0;
+    for (std::size_t i = 24; i < 32; i++) ret = (ret << 8) | data[pos + i];
+    return ret;
+  }
+
+  /// Strip the "0x" prefix from a hex string.
+  std::string stripHex(const std::string& hex) {
+    return (hex.substr(0, 2) == "0x" || hex.substr(0, 2) == "0X") ? hex.substr(2) : hex;
+  }
+}
+
+Multicall::Multicall(const std::unique_ptr<Provider>& provider)
+  : Multicall(provider, Options()) {}
+
+Multicall::Multicall(const std::unique_ptr<Provider>& provider, Options options)
+  : _provider(provider), _options(options) {
+  if (this->_options.maxCalls == 0) this->_options.maxCalls = 1;
+}
+
+std::string Multicall::encodeAggregate3(
+  const std::vector<std::tuple<std::string, std::string, bool>>& calls
+) {
+  dev::bytes out = dev::fromHex(aggregate3Selector);
+  appendWord(out, 0x20);          // Offset of the array
+  appendWord(out, calls.size());  // Array length
+  // Each (address, bool, bytes) tuple is dynamic, so the array starts with
+  // their offsets, counted from right after the length.
+  std::vector<dev::bytes> datas;
+  uint64_t offset = 32 * calls.size();
+  for (const auto& [target, data, allowFailure] : calls) {
+    datas.push_back(dev::fromHex(stripHex(data)));
+    appendWord(out, offset);
+    offset += 32 * 4 + ((datas.back().size() + 31) / 32) * 32;
+  }
+  for (std::size_t i = 0; i < calls.size(); i++) {
+    dev::bytes target = dev::fromHex(stripHex(std::get<0>(calls[i])));
+    out.insert(out.end(), 32 - std::min<std::size_t>(target.size(), 32), 0);
+    out.insert(out.end(), target.begin(), target.end());
+    appendWord(out, std::get<2>(calls[i]) ? 1 : 0);
+    appendWord(out, 0x60);        // Offset of the bytes, counted from the tuple start
+    appendWord(out, datas[i].size());
+    out.insert(out.end(), datas[i].begin(), datas[i].end());
+    out.insert(out.end(), (32 - datas[i].size() % 32) % 32, 0);
+  }
+  return dev::toHexPrefixed(out);
+}
+
+std::optional<std::vector<std::pair<bool, std::string>>> Multicall::decodeAggregate3(
+  const std::string& data
+) {
+  std::string hex = stripHex(data);
+  if (hex.size() % 2 != 0 || !std::all_of(hex.begin(), hex.end(), [](unsigned char c){ return std::isxdigit(c); })) {
+    return std::nullopt;
+  }
+  dev::bytes bytes = dev::fromHex(hex);
+  std::optional<uint64_t> arrayPos = readWord(bytes, 0);
+  if (!arrayPos) return std::nullopt;
+  std::optional<uint64_t> length = readWord(bytes, *arrayPos);
+  if (!length || *length > bytes.size() / 32) return std::nullopt;
+  uint64_t base = *arrayPos + 32;
+
+  std::vector<std::pair<bool, std::string>> ret;
+  ret.reserve(*length);
+  for (uint64_t i = 0; i < *length; i++) {
+    std::optional<uint64_t> tupleOffset = readWord(bytes, base + 32 * i);
+    if (!tupleOffset || *tupleOffset > bytes.size()) return std::nullopt;
+    uint64_t tuple = base + *tupleOffset;
+    std::optional<uint64_t> success = readWord(bytes, tuple);
+    std::optional<uint64_t> dataOffset = readWord(bytes, tuple + 32);
+    if (!success || *success > 1 || !dataOffset || *dataOffset > bytes.size()) return std::nullopt;
+    uint64_t dataPos = tuple + *dataOffset;
+    std::optional<uint64_t> dataLength = readWord(bytes, dataPos);
+    if (!dataLength || dataPos + 32 > bytes.size() || *dataLength > bytes.size() - dataPos - 32) return std::nullopt;
+    auto begin = bytes.begin() + dataPos + 32;
+    ret.emplace_back(*success == 1, dev::toHexPrefixed(dev::bytes(begin, begin + *dataLength)));
+  }
+  return ret;
+}
+
+std::future<json> Multicall::add(const std::string& target, const std::string& data, bool allowFailure) {
+  Call call;
+  call.target = target;
+  call.data = data;
+  call.allowFailure = allowFailure;
+  std::future<json> ret = call.promise.get_future();
+  std::scoped_lock lock(this->_lock);
+  this->_queue.push_back(std::move(call));
+  return ret;
+}
+
+std::future<json> Multicall::add(Contract& contract, const json& arguments, const std::string& function) {
+  Error err;
+  std::string data = contract(arguments, function, err);
+  if (err.getCode() != 0) {
+    std::promise<json> failed;
+    json ret;
+    ret["error"]["message"] = err.what();
+    failed.set_value(ret);
+    return failed.get_future();
+  }
+  return this->add(contract.options.address, data);
+}
+
+std::size_t Multicall::size() {
+  std::scoped_lock lock(this->_lock);
+  return this->_queue.size();
+}
+
+bool Multicall::_checkDeployed() {
+  {
+    std::scoped_lock lock(this->_lock);
+    if (this->_deployed) return *this->_deployed;
+  }
+  Error err;
+  json code = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST,
+    RPC::eth_getCode(address, this->_options.block, err).dump()
+  ));
+  if (!code.contains("result") || !code["result"].is_string()) return false; // Check again next time
+  bool deployed = (code["result"] != "0x" && code["result"] != "0x0");
+
+  if (!deployed && !this->_options.runtimeCode.empty()) {
+    json version = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST,
+      RPC::web3_clientVersion().dump()
+    ));
+    std::string client = (version.contains("result") && version["result"].is_string())
+      ? version["result"].get<std::string>() : "";
+    std::transform(client.begin(), client.end(), client.begin(), [](unsigned char c){ return std::tolower(c); });
+    if (client.rfind("anvil", 0) == 0) {
+      Error setErr;
+      json req = RPC::anvil_setCode(address, this->_options.runtimeCode, setErr);
+      if (setErr.getCode() == 0) {
+        json res = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, req.dump()));
+        deployed = !res.contains("error");
+      }
+    }
+  }
+  std::scoped_lock lock(this->_lock);
+  this->_deployed = deployed;
+  return deployed;
+}
+
+void Multicall::_aggregate(std::vector<Call>& calls) {
+  std::vector<json> requests;
+  for (std::size_t i = 0; i < calls.size(); i += this->_options.maxCalls) {
+    std::size_t end = std::min(calls.size(), i + this->_options.maxCalls);
+    std::vector<std::tuple<std::string, std::string, bool>> packed;
+    for (std::size_t j = i; j < end; j++) {
+      packed.emplace_back(calls[j].target, calls[j].data, calls[j].allowFailure);
+    }
+    json callObject;
+    callObject["from"] = this->_options.from;
+    callObject["to"] = address;
+    callObject["data"] = encodeAggregate3(packed);
+    Error err;
+    requests.push_back(RPC::eth_call(callObject, this->_options.block, err));
+  }
+  // Every aggregate3 goes in the same round trip.
+  std::vector<json> responses = Net::HTTPBatchRequest(this->_provider, std::move(requests));
+
+  for (std::size_t chunk = 0; chunk < responses.size(); chunk++) {
+    std::size_t begin = chunk * this->_options.maxCalls;
+    std::size_t end = std::min(calls.size(), begin + this->_options.maxCalls);
+    json& res = responses[chunk];
+    std::optional<std::vector<std::pair<bool, std::string>>> results;
+    if (!res.contains("error") && res.contains("result") && res["result"].is_string()) {
+      results = decodeAggregate3(res["result"].get<std::string>());
+    }
+    for (std::size_t j = begin; j < end; j++) {
+      json ret;
+      if (res.contains("error")) {
+        ret["error"] = res["error"];    // A call that can't fail reverted, or the call itself failed
+      } else if (!results || results->size() != end - begin) {
+        ret["error"]["message"] = "Invalid aggregate3 response";
+      } else if ((*results)[j - begin].first) {
+        ret["result"] = (*results)[j - begin].second;
+      } else {
+        ret["error"]["message"] = "execution reverted";
+        ret["error"]["data"] = (*results)[j - begin].second;
+      }
+      calls[j].promise.set_value(std::move(ret));
+      calls[j].resolved = true;
+    }
+  }
+}
+
+void Multicall::_batch(std::vector<Call>& calls) {
+  for (std::size_t i = 0; i < calls.size(); i += this->_options.maxCalls) {
+    std::size_t end = std::min(calls.size(), i + this->_options.maxCalls);
+    std::vector<json> requests;
+    std::vector<std::size_t> indexes;
+    for (std::size_t j = i; j < end; j++) {
+      json callObject;
+      callObject["from"] = this->_options.from;
+      callObject["to"] = calls[j].target;
+      callObject["data"] = calls[j].data;
+      Error err;
+      json req = RPC::eth_call(callObject, this->_options.block, err);
+      if (err.getCode() != 0) {
+        json ret;
+        ret["error"]["message"] = err.what();
+        calls[j].promise.set_value(std::move(ret));
+        calls[j].resolved = true;
+        continue;
+      }
+      requests.push_back(std::move(req));
+      indexes.push_back(j);
+    }
+    std::vector<json> responses = Net::HTTPBatchRequest(this->_provider, std::move(requests));
+    for (std::size_t k = 0; k < indexes.size(); k++) {
+      json ret;
+      if (responses[k].contains("error")) ret["error"] = responses[k]["error"];
+      else ret["result"] = responses[k]["result"];
+      calls[indexes[k]].promise.set_value(std::move(ret));
+      calls[indexes[k]].resolved = true;
+    }
+  }
+}
+
+std::future<json> Multicall::execute() {
+  auto calls = std::make_shared<std::vector<Call>>();
+  {
+    std::scoped_lock lock(this->_lock);
+    calls->swap(this->_queue);
+  }
+  return std::async([this, calls]{
+    json ret;
+    try {
+      if (!calls->empty()) {
+        if (this->_checkDeployed()) this->_aggregate(*calls); else this->_batch(*calls);
+      }
+      ret["result"] = calls->size();
+    } catch (std::exception &e) {
+      ret["error"]["message"] = e.what();
+    }
+    for (Call& call : *calls) {
+      if (call.resolved) continue;
+      json error;
+      error["error"]["message"] = (ret.contains("error")) ? ret["error"]["message"] : json("Call was not sent");
+      call.promise.set_value(std::move(error));
+    }
+    return ret;
+  });
+}
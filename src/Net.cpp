@@ -4,6 +4,109 @@
 // when included in the header for some reason
 #include <boost/certify/extensions.hpp>
 #include <boost/certify/https_verification.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+namespace {
+  /**
+   * Stream buffer that reads an HTTP response body straight from the socket.
+   * Each underflow() reads at most one chunk into a fixed buffer, so the
+   * memory used is the same regardless of the body size.
+   */
+  template <typename Stream> class HTTPBodyStreamBuf : public std::streambuf {
+    private:
+      Stream& _stream;
+      boost::beast::flat_buffer& _buffer;
+      boost::beast::http::response_parser<boost::beast::http::buffer_body>& _parser;
+      char _chunk[64 * 1024];
+
+    public:
+      HTTPBodyStreamBuf(
+        Stream& stream, boost::beast::flat_buffer& buffer,
+        boost::beast::http::response_parser<boost::beast::http::buffer_body>& parser
+      ) : _stream(stream), _buffer(buffer), _parser(parser) {}
+
+    protected:
+      int_type underflow() override {
+        namespace http = boost::beast::http;
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        while (!_parser.is_done()) {
+          _parser.get().body().data = _chunk;
+          _parser.get().body().size = sizeof(_chunk);
+          boost::system::error_code ec;
+          http::read(_stream, _buffer, _parser, ec);
+          if (ec == http::error::need_buffer) ec.clear();
+          if (ec) throw boost::system::system_error{ec};
+          std::size_t read = sizeof(_chunk) - _parser.get().body().size;
+          if (read > 0) {
+            setg(_chunk, _chunk, _chunk + read);
+            return traits_type::to_int_type(*gptr());
+          }
+        }
+        return traits_type::eof();
+      }
+  };
+
+  /// Write a request to an open stream and hand the response body to a consumer.
+  template <typename Stream> void streamHTTPBody(
+    Stream& stream, const boost::beast::http::request<boost::beast::http::string_body>& req,
+    const std::function<void(std::istream&)>& onBody
+  ) {
+    namespace http = boost::beast::http;
+    http::write(stream, req);
+    boost::beast::flat_buffer buffer;
+    http::response_parser<http::buffer_body> parser;
+    // Not boost::none: Boost 1.74 compares the Content-Length against
+    // the unset optional and rejects every response that has one.
+    parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+    http::read_header(stream, buffer, parser);
+    HTTPBodyStreamBuf<Stream> buf(stream, buffer, parser);
+    std::istream body(&buf);
+    onBody(body);
+  }
+  /**
+   * Send a request over an open WebSocket and read messages until the
+   * consumer or `keepOpen` says to stop. Reads are asynchronous so the
+   * connection can be closed while idle, without waiting for a message.
+   */
+  template <typename WebSocket> void readWebSocket(
+    WebSocket& ws, boost::asio::io_context& ioc, const std::string& request,
+    const std::function<bool(const json&)>& onMessage,
+    const std::function<bool()>& keepOpen, std::chrono::milliseconds checkInterval
+  ) {
+    namespace websocket = boost::beast::websocket;
+    ws.write(boost::asio::buffer(request));
+    boost::beast::flat_buffer buffer;
+    while (true) {
+      bool done = false;
+      boost::system::error_code ec;
+      ws.async_read(buffer, [&](boost::system::error_code e, std::size_t){ ec = e; done = true; });
+      ioc.restart();
+      while (!done) {
+        ioc.run_for(checkInterval);
+        if (!done && !keepOpen()) {
+          // Abort the pending read, the socket is closed on destruction.
+          boost::beast::get_lowest_layer(ws).cancel();
+          ioc.restart();
+          ioc.run();
+          return;
+        }
+      }
+      if (ec == websocket::error::closed) return;
+      if (ec) throw boost::system::system_error{ec};
+      json msg = json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+      buffer.consume(buffer.size());
+      if (!msg.is_discarded() && !onMessage(msg)) break;
+    }
+    boost::system::error_code ec;
+    ws.close(websocket::close_code::normal, ec);
+  }
+}
 
 std::string Net::HTTPRequest(
   const std::unique_ptr<Provider>& provider, const RequestTypes& requestType,const std::string& reqBody
@@ -126,6 +229,213 @@ std::string Net::HTTPRequest(
     }
 }
 
+void Net::HTTPStreamRequest(
+  const std::unique_ptr<Provider>& provider, const RequestTypes& requestType,
+  const std::string& reqBody, const std::function<void(std::istream&)>& onBody
+) {
+  using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
+  namespace ssl = boost::asio::ssl;
+  namespace http = boost::beast::http;    // from <boost/beast/http.hpp>
+
+  std::string host, target, port, protocol;
+  // Lock Provider mutex and get information from it.
+  {
+      std::scoped_lock lock(provider->lock);
+      host = provider->getHost();
+      target = provider->getTarget();
+      port = boost::lexical_cast<std::string>(provider->getPort());
+      protocol = provider->getProtocol();
+  }
+
+  http::request<http::string_body> req{
+      (requestType == RequestTypes::POST) ? http::verb::post : http::verb::get,
+      target,
+      11
+  };
+  req.set(http::field::host, host);
+  req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+  req.set(http::field::content_type, "application/json");
+  if (requestType == RequestTypes::POST) {
+      req.set(http::field::accept, "application/json");
+      req.body() = reqBody;
+      req.prepare_payload();
+  }
+
+  try {
+      boost::asio::io_context ioc;
+      tcp::resolver resolver(ioc);
+      auto const results = resolver.resolve(host, port);
+
+      if (protocol == "https")
+      {
+          ssl::context ctx{ssl::context::sslv23_client};
+          ctx.set_verify_mode(ssl::context::verify_peer | ssl::context::verify_fail_if_no_peer_cert);
+          ctx.set_default_verify_paths();
+          boost::certify::enable_native_https_server_verification(ctx);
+
+          ssl::stream<tcp::socket> stream{ioc, ctx};
+          boost::certify::sni_hostname(stream, host);
+          boost::asio::connect(stream.next_layer(), results.begin(), results.end());
+          stream.handshake(ssl::stream_base::client);
+
+          streamHTTPBody(stream, req, onBody);
+
+          // The consumer may have stopped before the end of the body,
+          // so a truncated shutdown is expected here and not an error.
+          boost::system::error_code ec;
+          stream.shutdown(ec);
+      }
+
+      else if (protocol == "http")
+      {
+          tcp::socket socket{ioc};
+          boost::asio::connect(socket, results);
+
+          streamHTTPBody(socket, req, onBody);
+
+          boost::system::error_code ec;
+          socket.shutdown(tcp::socket::shutdown_both, ec);
+          socket.close(ec);
+      }
+
+      else {
+          throw std::runtime_error("Unsupported protocol: " + protocol);
+      }
+  }
+  catch (std::exception const& e) {
+      throw std::runtime_error(std::string("HTTP Request error: ") + e.what());
+  }
+}
+
+std::vector<json> Net::HTTPBatchRequest(
+  const std::unique_ptr<Provider>& provider, std::vector<json> requests
+) {
+  std::vector<json> ret(requests.size());
+  if (requests.empty()) return ret;
+  for (std::size_t i = 0; i < requests.size(); i++) requests[i]["id"] = i;
+  json response = json::parse(HTTPRequest(
+    provider, RequestTypes::POST, json(std::move(requests)).dump()
+  ));
+
+  if (response.is_array()) {
+    for (json& item : response) {
+      auto id = item.find("id");
+      if (id == item.end() || !id->is_number_unsigned()) continue;
+      std::size_t idx = id->get<std::size_t>();
+      if (idx < ret.size() && ret[idx].is_null()) ret[idx] = std::move(item);
+    }
+  }
+  // Whole batch rejected (e.g. batching is disabled) or responses missing.
+  json missing;
+  missing["jsonrpc"] = "2.0";
+  missing["error"] = (response.is_object() && response.contains("error"))
+    ? response["error"] : json({{"code", -32603}, {"message", "Missing response in batch"}});
+  for (std::size_t i = 0; i < ret.size(); i++) {
+    if (ret[i].is_null()) { ret[i] = missing; ret[i]["id"] = i; }
+  }
+  return ret;
+}
+
+std::vector<bool> Net::HTTPBulkRequest(
+  const std::unique_ptr<Provider>& provider, std::size_t count,
+  std::size_t batchSize, unsigned int parallelism,
+  const std::function<json(std::size_t, Error&)>& build,
+  const std::function<bool(std::size_t, json&)>& onResponse
+) {
+  std::vector<char> ok(count, 0);  // Not vector<bool>, threads write neighbouring entries
+  batchSize = std::max<std::size_t>(batchSize, 1);
+  const std::size_t batches = (count + batchSize - 1) / batchSize;
+  std::atomic<std::size_t> next{0};
+  auto worker = [&]{
+    for (std::size_t b = next++; b < batches; b = next++) {
+      std::vector<json> requests;
+      std::vector<std::size_t> indexes;
+      for (std::size_t i = b * batchSize; i < std::min(count, (b + 1) * batchSize); i++) {
+        Error err;
+        json req = build(i, err);
+        if (err.getCode() != 0) continue;
+        requests.push_back(std::move(req));
+        indexes.push_back(i);
+      }
+      if (requests.empty()) continue;
+      std::vector<json> responses;
+      try {
+        responses = HTTPBatchRequest(provider, std::move(requests));
+      } catch (std::exception &e) {
+        continue;
+      }
+      for (std::size_t j = 0; j < responses.size() && j < indexes.size(); j++) {
+        if (onResponse(indexes[j], responses[j])) ok[indexes[j]] = 1;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  const std::size_t threadCount = std::min<std::size_t>(std::max(parallelism, 1u), batches);
+  for (std::size_t t = 1; t < threadCount; t++) threads.emplace_back(worker);
+  worker();
+  for (std::thread& t : threads) t.join();
+  return std::vector<bool>(ok.begin(), ok.end());
+}
+
+void Net::WSSubscribe(
+  const std::unique_ptr<Provider>& provider, uint64_t port, const json& request,
+  const std::function<bool(const json&)>& onMessage,
+  const std::function<bool()>& keepOpen, std::chrono::milliseconds checkInterval
+) {
+  using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
+  namespace ssl = boost::asio::ssl;
+  namespace websocket = boost::beast::websocket;
+
+  std::string host, target, portStr, protocol;
+  // Lock Provider mutex and get information from it.
+  {
+      std::scoped_lock lock(provider->lock);
+      host = provider->getHost();
+      target = provider->getTarget();
+      portStr = boost::lexical_cast<std::string>((port != 0) ? port : provider->getPort());
+      protocol = provider->getProtocol();
+  }
+  const std::string reqBody = request.dump();
+
+  try {
+      boost::asio::io_context ioc;
+      tcp::resolver resolver(ioc);
+      auto const results = resolver.resolve(host, portStr);
+
+      if (protocol == "https")
+      {
+          ssl::context ctx{ssl::context::sslv23_client};
+          ctx.set_verify_mode(ssl::context::verify_peer | ssl::context::verify_fail_if_no_peer_cert);
+          ctx.set_default_verify_paths();
+          boost::certify::enable_native_https_server_verification(ctx);
+
+          websocket::stream<ssl::stream<tcp::socket>> ws{ioc, ctx};
+          boost::certify::sni_hostname(ws.next_layer(), host);
+          boost::asio::connect(boost::beast::get_lowest_layer(ws), results.begin(), results.end());
+          ws.next_layer().handshake(ssl::stream_base::client);
+          ws.handshake(host, target);
+
+          readWebSocket(ws, ioc, reqBody, onMessage, keepOpen, checkInterval);
+      }
+
+      else if (protocol == "http")
+      {
+          websocket::stream<tcp::socket> ws{ioc};
+          boost::asio::connect(ws.next_layer(), results.begin(), results.end());
+          ws.handshake(host + ":" + portStr, target);
+
+          readWebSocket(ws, ioc, reqBody, onMessage, keepOpen, checkInterval);
+      }
+
+      else {
+          throw std::runtime_error("Unsupported protocol: " + protocol);
+      }
+  }
+  catch (std::exception const& e) {
+      throw std::runtime_error(std::string("WebSocket error: ") + e.what());
+  }
+}
+
 std::string Net::customHTTPRequest(
   const std::string& reqBody, const std::string& host, const std::string& port,
   const std::string& target, const std::string& requestType, const std::string& contentType
@@ -0,0 +1,160 @@
+#include <web3cpp/NonceManager.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+namespace {
+  /// Get a lowercase copy of a string.
+  std::string lower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c){ return std::tolower(c); });
+    return str;
+  }
+}
+
+NonceManager::NonceManager(const std::unique_ptr<Provider>& provider)
+  : NonceManager(provider, Options()) {}
+
+NonceManager::NonceManager(const std::unique_ptr<Provider>& provider, Options options)
+  : _provider(provider), _options(options) {}
+
+bool NonceManager::isNonceError(const json& error) {
+  if (!error.is_object() || !error.contains("message") || !error["message"].is_string()) return false;
+  const std::string message = lower(error["message"].get<std::string>());
+  for (const char* pattern : {
+    "nonce too low", "nonce too high",            // geth, Erigon, Anvil, Nethermind
+    "nonce is too low", "nonce is too high",      // OpenEthereum, Besu
+    "nonce_too_low", "nonce_too_high",            // Besu error names
+    "oldnonce", "nonce has already been used"     // Older Nethermind, Infura/Alchemy
+  }) {
+    if (message.find(pattern) != std::string::npos) return true;
+  }
+  return false;
+}
+
+bool NonceManager::isNonceUnused(const json& error) {
+  if (!error.is_object() || !error.contains("message") || !error["message"].is_string()) return false;
+  const std::string message = lower(error["message"].get<std::string>());
+  // Another transaction (or this one) holds the nonce.
+  for (const char* pattern : {"replacement", "already known", "known transaction", "already imported", "alreadyknown"}) {
+    if (message.find(pattern) != std::string::npos) return false;
+  }
+  for (const char* pattern : {
+    "insufficient funds", "intrinsic gas too low", "exceeds block gas limit",
+    "transaction underpriced", "fee cap less than block base fee",
+    "max fee per gas less than block base fee", "tip higher than fee cap",
+    "max priority fee per gas higher than max fee per gas",
+    "invalid sender", "invalid signature", "invalid chain id", "oversized data",
+    "exceeds the configured cap"
+  }) {
+    if (message.find(pattern) != std::string::npos) return true;
+  }
+  return false;
+}
+
+NonceManager::Sender& NonceManager::_sender(const std::string& address) {
+  const std::string key = lower(address);
+  {
+    std::shared_lock lock(this->_sendersLock);
+    auto it = this->_senders.find(key);
+    if (it != this->_senders.end()) return *it->second;
+  }
+  std::unique_lock lock(this->_sendersLock);
+  auto& sender = this->_senders[key];
+  if (!sender) sender = std::make_unique<Sender>();
+  return *sender;
+}
+
+NonceManager::Sender* NonceManager::_find(const std::string& address) const {
+  std::shared_lock lock(this->_sendersLock);
+  auto it = this->_senders.find(lower(address));
+  return (it != this->_senders.end()) ? it->second.get() : nullptr;
+}
+
+bool NonceManager::_sync(const std::string& address, Sender& sender, Error &err) {
+  if (sender.synced.load(std::memory_order_acquire)) return true;
+  // Everyone else waits here for the one doing the request.
+  std::scoped_lock lock(sender.lock);
+  if (sender.synced.load(std::memory_order_acquire)) return true;
+  Error rpcErr;
+  json req = RPC::eth_getTransactionCount(
+    address, (this->_options.includePending) ? BlockTag::pending() : BlockTag::latest(), rpcErr
+  );
+  if (rpcErr.getCode() != 0) { err.setCode(rpcErr.getCode()); return false; }
+  std::optional<Quantity> count;
+  try {
+    json res = json::parse(Net::HTTPRequest(this->_provider, Net::RequestTypes::POST, req.dump()));
+    if (res.contains("result") && res["result"].is_string()) count = Quantity::fromHex(res["result"].get<std::string>());
+  } catch (std::exception &e) {}
+  if (!count) { err.setCode(41); return false; }  // Nonce Sync Error
+  sender.next.store(static_cast<uint64_t>(count->value()), std::memory_order_release);
+  sender.gaps.clear();
+  sender.gapCount.store(0, std::memory_order_release);
+  sender.synced.store(true, std::memory_order_release);
+  return true;
+}
+
+std::optional<uint64_t> NonceManager::reserve(const std::string& address, Error &err) {
+  Sender& sender = this->_sender(address);
+  if (!this->_sync(address, sender, err)) return std::nullopt;
+  if (sender.gapCount.load(std::memory_order_acquire) > 0) {
+    std::scoped_lock lock(sender.lock);
+    if (!sender.gaps.empty()) {
+      uint64_t nonce = *sender.gaps.begin();
+      sender.gaps.erase(sender.gaps.begin());
+      sender.gapCount.store(sender.gaps.size(), std::memory_order_release);
+      return nonce;
+    }
+  }
+  return sender.next.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void NonceManager::release(const std::string& address, uint64_t nonce) {
+  Sender* sender = this->_find(address);
+  if (!sender || !sender->synced.load(std::memory_order_acquire)) return;
+  // The last nonce handed out is just taken back.
+  uint64_t expected = nonce + 1;
+  if (sender->next.compare_exchange_strong(expected, nonce, std::memory_order_acq_rel)) return;
+  std::scoped_lock lock(sender->lock);
+  if (nonce >= sender->next.load(std::memory_order_acquire)) return;  // Never handed out
+  sender->gaps.insert(nonce);
+  sender->gapCount.store(sender->gaps.size(), std::memory_order_release);
+}
+
+bool NonceManager::handleError(const std::string& address, const json& error) {
+  if (!isNonceError(error)) return false;
+  this->resync(address);
+  return true;
+}
+
+void NonceManager::resync(const std::string& address) {
+  Sender* sender = this->_find(address);
+  if (sender) sender->synced.store(false, std::memory_order_release);
+}
+
+void NonceManager::set(const std::string& address, uint64_t next) {
+  Sender& sender = this->_sender(address);
+  std::scoped_lock lock(sender.lock);
+  sender.next.store(next, std::memory_order_release);
+  sender.gaps.clear();
+  sender.gapCount.store(0, std::memory_order_release);
+  sender.synced.store(true, std::memory_order_release);
+}
+
+std::optional<uint64_t> NonceManager::peek(const std::string& address) const {
+  Sender* sender = this->_find(address);
+  if (!sender || !sender->synced.load(std::memory_order_acquire)) return std::nullopt;
+  std::scoped_lock lock(sender->lock);
+  if (!sender->gaps.empty()) return *sender->gaps.begin();
+  return sender->next.load(std::memory_order_acquire);
+}
+
+std::vector<uint64_t> NonceManager::gaps(const std::string& address) const {
+  Sender* sender = this->_find(address);
+  if (!sender) return {};
+  std::scoped_lock lock(sender->lock);
+  return std::vector<uint64_t>(sender->gaps.begin(), sender->gaps.end());
+}
@@ -17,9 +17,41 @@ bool RPC::_checkAddress(const std::string& add) {
   return Utils::isAddress(add);
 }
 
+int RPC::_checkCallObject(const json& callObject) {
+  if (
+    !callObject.count("from") || !_checkAddress(callObject["from"]) ||
+    (callObject.count("to") && !_checkAddress(callObject["to"]))
+  ) return 5; // Invalid Address
+  if (
+    !callObject.count("data") || !_checkHexData(callObject["data"]) ||
+    (callObject.count("gas") && !_checkHexData(callObject["gas"])) ||
+    (callObject.count("gasPrice") && !_checkHexData(callObject["gasPrice"])) ||
+    (callObject.count("value") && !_checkHexData(callObject["value"]))
+  ) return 4; // Invalid Hex Data
+  return 0;
+}
+
+bool RPC::_checkTopics(const json& topics) {
+  if (!topics.is_array()) return false;
+  for (const json& topic : topics) {
+    if (topic.is_null()) continue;
+    if (topic.is_string()) {
+      if (!_checkHexData(topic.get<std::string>())) return false;
+    } else if (topic.is_array()) {
+      for (const json& option : topic) {
+        if (!option.is_null() && (!option.is_string() || !_checkHexData(option.get<std::string>()))) return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool RPC::_checkDefaultBlock(const std::string& block) {
   return (
     block == "latest" || block == "earliest" || block == "pending" ||
+    block == "safe" || block == "finalized" ||
     Utils::isHexStrict(block)
   );
 }
@@ -105,8 +137,13 @@ json RPC::eth_getBalance(const std::string& address, const std::string& defaultB
 }
 
 json RPC::eth_getBalance(const std::string& address, BigNumber defaultBlock, Error &err) {
-  auto _defaultBlock = Utils::toHex(defaultBlock);
-  return eth_getBalance(address, _defaultBlock, err);
+  return eth_getBalance(address, BlockTag::number(uint64_t(defaultBlock)), err);
+}
+
+json RPC::eth_getBalance(const std::string& address, const BlockTag& defaultBlock, Error &err) {
+  err.setCode((!_checkAddress(address)) ? 5 : 0);  // Invalid Address
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_getBalance", {address, defaultBlock.toJSON()});
 }
 
 json RPC::eth_getStorageAt(const std::string& address, const std::string& position, const std::string& defaultBlock, Error &err) {
@@ -122,8 +159,15 @@ json RPC::eth_getStorageAt(const std::string& address, const std::string& positi
 }
 
 json RPC::eth_getStorageAt(const std::string& address, const std::string& position, BigNumber defaultBlock, Error &err) {
-  auto _defaultBlock =  Utils::toHex(defaultBlock);
-  return eth_getStorageAt(address, position, _defaultBlock, err);
+  std::optional<Quantity> quantity = Quantity::fromHex(position);
+  if (!_checkHexData(position) || !quantity) { err.setCode(4); return json::object(); } // Invalid Hex Data
+  return eth_getStorageAt(address, *quantity, BlockTag::number(uint64_t(defaultBlock)), err);
+}
+
+json RPC::eth_getStorageAt(const std::string& address, const Quantity& position, const BlockTag& defaultBlock, Error &err) {
+  err.setCode((!_checkAddress(address)) ? 5 : 0);  // Invalid Address
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_getStorageAt", {address, position.hex(), defaultBlock.toJSON()});
 }
 
 json RPC::eth_getTransactionCount(const std::string& address, const std::string& defaultBlock, Error &err) {
@@ -138,8 +182,13 @@ json RPC::eth_getTransactionCount(const std::string& address, const std::string&
 }
 
 json RPC::eth_getTransactionCount(const std::string& address, BigNumber defaultBlock, Error &err) {
-  auto _defaultBlock =  Utils::toHex(defaultBlock);
-  return eth_getTransactionCount(address, _defaultBlock, err);
+  return eth_getTransactionCount(address, BlockTag::number(uint64_t(defaultBlock)), err);
+}
+
+json RPC::eth_getTransactionCount(const std::string& address, const BlockTag& defaultBlock, Error &err) {
+  err.setCode((!_checkAddress(address)) ? 5 : 0);  // Invalid Address
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_getTransactionCount", {address, defaultBlock.toJSON()});
 }
 
 json RPC::eth_getBlockTransactionCountByHash(const std::string& hash, Error &err) {
@@ -160,8 +209,14 @@ json RPC::eth_getBlockTransactionCountByNumber(const std::string& number, Error
 }
 
 json RPC::eth_getBlockTransactionCountByNumber(BigNumber number, Error &err) {
-  auto _number =  Utils::toHex(number);
-  return eth_getBlockTransactionCountByNumber(_number, err);
+  err.setCode(0);
+  return eth_getBlockTransactionCountByNumber(BlockTag::number(uint64_t(number)));
+}
+
+json RPC::eth_getBlockTransactionCountByNumber(const BlockTag& number) {
+  return (number.kind() == BlockTag::Hash)
+    ? _buildJSON("eth_getBlockTransactionCountByHash", {number.toString()})
+    : _buildJSON("eth_getBlockTransactionCountByNumber", json::array({number.toJSON()}));
 }
 
 json RPC::eth_getUncleCountByBlockHash(const std::string& hash, Error &err) {
@@ -182,8 +237,14 @@ json RPC::eth_getUncleCountByBlockNumber(const std::string& number, Error &err)
 }
 
 json RPC::eth_getUncleCountByBlockNumber(BigNumber number, Error &err) {
-  auto _number =  Utils::toHex(number);
-  return eth_getUncleCountByBlockNumber(_number, err);
+  err.setCode(0);
+  return eth_getUncleCountByBlockNumber(BlockTag::number(uint64_t(number)));
+}
+
+json RPC::eth_getUncleCountByBlockNumber(const BlockTag& number) {
+  return (number.kind() == BlockTag::Hash)
+    ? _buildJSON("eth_getUncleCountByBlockHash", {number.toString()})
+    : _buildJSON("eth_getUncleCountByBlockNumber", json::array({number.toJSON()}));
 }
 
 json RPC::eth_getCode(const std::string& address, const std::string& defaultBlock, Error &err) {
@@ -198,8 +259,13 @@ json RPC::eth_getCode(const std::string& address, const std::string& defaultBloc
 }
 
 json RPC::eth_getCode(const std::string& address, BigNumber defaultBlock, Error &err) {
-  auto _defaultBlock =  Utils::toHex(defaultBlock);
-  return eth_getCode(address, _defaultBlock, err);
+  return eth_getCode(address, BlockTag::number(uint64_t(defaultBlock)), err);
+}
+
+json RPC::eth_getCode(const std::string& address, const BlockTag& defaultBlock, Error &err) {
+  err.setCode((!_checkAddress(address)) ? 5 : 0);  // Invalid Address
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_getCode", {address, defaultBlock.toJSON()});
 }
 
 json RPC::eth_sign(const std::string& address, const std::string& data, Error &err) {
@@ -230,7 +296,7 @@ json RPC::eth_signTransaction(const json& txObj, Error &err) {
   }();
   err.setCode(errCode);
   return (err.getCode() != 0) ? json::object()
-    : _buildJSON("eth_signTransaction", {txObj});
+    : _buildJSON("eth_signTransaction", json::array({txObj}));
 }
 
 json RPC::eth_sendTransaction(const json& txObj, Error &err) {
@@ -250,7 +316,7 @@ json RPC::eth_sendTransaction(const json& txObj, Error &err) {
   }();
   err.setCode(errCode);
   return (err.getCode() != 0) ? json::object()
-    : _buildJSON("eth_sendTransaction", {txObj});
+    : _buildJSON("eth_sendTransaction", json::array({txObj}));
 }
 
 json RPC::eth_sendRawTransaction(const std::string& signedTxData, Error &err) {
@@ -260,28 +326,21 @@ json RPC::eth_sendRawTransaction(const std::string& signedTxData, Error &err) {
 }
 
 json RPC::eth_call(const json& callObject, const std::string& defaultBlock, Error &err) {
-  int errCode = 0;
-  [&](){
-    if (
-      !_checkAddress(callObject["from"]) ||
-      (callObject.count("to") && !_checkAddress(callObject["to"]))
-    ) { errCode = 5; return; } // Invalid Address
-    if (
-      !_checkHexData(callObject["data"]) ||
-      (callObject.count("gas") && !_checkHexData(callObject["gas"])) ||
-      (callObject.count("gasPrice") && !_checkHexData(callObject["gasPrice"])) ||
-      (callObject.count("value") && !_checkHexData(callObject["value"]))
-    ) { errCode = 4; return; } // Invalid Hex Data
-    if (!_checkDefaultBlock(defaultBlock)) { errCode = 9; return; } // Invalid Block Number
-  }();
+  int errCode = _checkCallObject(callObject);
+  if (errCode == 0 && !_checkDefaultBlock(defaultBlock)) errCode = 9; // Invalid Block Number
   err.setCode(errCode);
   return (err.getCode() != 0) ? json::object()
     : _buildJSON("eth_call", {callObject, defaultBlock});
 }
 
 json RPC::eth_call(const json& callObject, BigNumber defaultBlock, Error &err) {
-  auto _defaultBlock =  Utils::toHex(defaultBlock);
-  return eth_call(callObject, _defaultBlock, err);
+  return eth_call(callObject, BlockTag::number(uint64_t(defaultBlock)), err);
+}
+
+json RPC::eth_call(const json& callObject, const BlockTag& defaultBlock, Error &err) {
+  err.setCode(_checkCallObject(callObject));
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_call", {callObject, defaultBlock.toJSON()});
 }
 
 json RPC::eth_estimateGas(const json& callObject, Error &err) {
@@ -321,8 +380,14 @@ json RPC::eth_getBlockByNumber(const std::string& number, bool returnTransaction
 }
 
 json RPC::eth_getBlockByNumber(BigNumber number, bool returnTransactionObjects, Error &err) {
-  auto _number =  Utils::toHex(number);
-  return eth_getBlockByNumber(_number, returnTransactionObjects, err);
+  err.setCode(0);
+  return eth_getBlockByNumber(BlockTag::number(uint64_t(number)), returnTransactionObjects);
+}
+
+json RPC::eth_getBlockByNumber(const BlockTag& number, bool returnTransactionObjects) {
+  return (number.kind() == BlockTag::Hash)
+    ? _buildJSON("eth_getBlockByHash", {number.toString(), returnTransactionObjects})
+    : _buildJSON("eth_getBlockByNumber", {number.toJSON(), returnTransactionObjects});
 }
 
 json RPC::eth_getTransactionByHash(const std::string& hash, Error &err) {
@@ -336,6 +401,17 @@ json RPC::eth_getTransactionByHash(const std::string& hash, Error &err) {
     : _buildJSON("eth_getTransactionByHash", {hash});
 }
 
+json RPC::eth_getRawTransactionByHash(const std::string& hash, Error &err) {
+  int errCode = 0;
+  [&](){
+    if (!_checkHexData(hash)) { errCode = 4; return; } // Invalid Hex Data
+    if (!_checkHexLength(hash, 32)) { errCode = 6; return; } // Invalid Hash Length
+  }();
+  err.setCode(errCode);
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_getRawTransactionByHash", {hash});
+}
+
 json RPC::eth_getTransactionByBlockHashAndIndex(const std::string& hash, const std::string& index, Error &err) {
   int errCode = 0;
   [&](){
@@ -358,8 +434,16 @@ json RPC::eth_getTransactionByBlockNumberAndIndex(const std::string& number, con
 }
 
 json RPC::eth_getTransactionByBlockNumberAndIndex(BigNumber number, const std::string& index, Error &err) {
-  auto _number =  Utils::toHex(number);
-  return eth_getTransactionByBlockNumberAndIndex(_number, index, err);
+  std::optional<Quantity> quantity = Quantity::fromHex(index);
+  err.setCode((!_checkHexData(index) || !quantity) ? 4 : 0);  // Invalid Hex Data
+  return (err.getCode() != 0) ? json::object()
+    : eth_getTransactionByBlockNumberAndIndex(BlockTag::number(uint64_t(number)), *quantity);
+}
+
+json RPC::eth_getTransactionByBlockNumberAndIndex(const BlockTag& number, const Quantity& index) {
+  return (number.kind() == BlockTag::Hash)
+    ? _buildJSON("eth_getTransactionByBlockHashAndIndex", {number.toString(), index.hex()})
+    : _buildJSON("eth_getTransactionByBlockNumberAndIndex", {number.toJSON(), index.hex()});
 }
 
 json RPC::eth_getTransactionReceipt(const std::string& hash, Error &err) {
@@ -373,6 +457,10 @@ json RPC::eth_getTransactionReceipt(const std::string& hash, Error &err) {
     : _buildJSON("eth_getTransactionReceipt", {hash});
 }
 
+json RPC::eth_getBlockReceipts(const BlockTag& block) {
+  return _buildJSON("eth_getBlockReceipts", json::array({block.toJSON()}));
+}
+
 json RPC::eth_getUncleByBlockHashAndIndex(const std::string& hash, const std::string& index, Error &err) {
   int errCode = 0;
   [&](){
@@ -395,8 +483,16 @@ json RPC::eth_getUncleByBlockNumberAndIndex(const std::string& number, const std
 }
 
 json RPC::eth_getUncleByBlockNumberAndIndex(BigNumber number, const std::string& index, Error &err) {
-  auto _number =  Utils::toHex(number);
-  return eth_getUncleByBlockNumberAndIndex(_number, index, err);
+  std::optional<Quantity> quantity = Quantity::fromHex(index);
+  err.setCode((!_checkHexData(index) || !quantity) ? 4 : 0);  // Invalid Hex Data
+  return (err.getCode() != 0) ? json::object()
+    : eth_getUncleByBlockNumberAndIndex(BlockTag::number(uint64_t(number)), *quantity);
+}
+
+json RPC::eth_getUncleByBlockNumberAndIndex(const BlockTag& number, const Quantity& index) {
+  return (number.kind() == BlockTag::Hash)
+    ? _buildJSON("eth_getUncleByBlockHashAndIndex", {number.toString(), index.hex()})
+    : _buildJSON("eth_getUncleByBlockNumberAndIndex", {number.toJSON(), index.hex()});
 }
 
 json RPC::eth_getCompilers() {
@@ -430,16 +526,13 @@ json RPC::eth_newFilter(json filterOptions, Error &err) {
         }
       }
     }
-    if (filterOptions.count("topics")) {
-      for (const json& topic : filterOptions["topics"]) {
-        const std::string& topicStr = topic.get<std::string>();
-        if (!_checkHexData(topicStr)) { errCode = 4; return; } // Invalid Hex Data
-      }
+    if (filterOptions.count("topics") && !_checkTopics(filterOptions["topics"])) {
+      errCode = 4; return; // Invalid Hex Data
     }
   }();
   err.setCode(errCode);
   return (err.getCode() != 0) ? json::object()
-    : _buildJSON("eth_newFilter", {filterOptions});
+    : _buildJSON("eth_newFilter", json::array({filterOptions}));
 }
 
 json RPC::eth_newBlockFilter() {
@@ -471,13 +564,15 @@ json RPC::eth_getFilterLogs(const std::string& filterId, Error &err) {
 json RPC::eth_getLogs(json filterOptions, Error &err) {
   int errCode = 0;
   [&](){
+    // EIP-234: a block hash replaces the range, so the range can't be defaulted.
+    const bool byHash = filterOptions.count("blockHash") || filterOptions.count("blockhash");
     if (!filterOptions.count("fromBlock")) {
-      filterOptions["fromBlock"] = "latest";
+      if (!byHash) filterOptions["fromBlock"] = "latest";
     } else if (!_checkDefaultBlock(filterOptions["fromBlock"])) {
       errCode = 9; return; // Invalid Block Number
     }
     if (!filterOptions.count("toBlock")) {
-      filterOptions["toBlock"] = "latest";
+      if (!byHash) filterOptions["toBlock"] = "latest";
     } else if (!_checkDefaultBlock(filterOptions["toBlock"])) {
       errCode = 9; return; // Invalid Block Number
     }
@@ -495,20 +590,40 @@ json RPC::eth_getLogs(json filterOptions, Error &err) {
         }
       }
     }
-    if (filterOptions.count("topics")) {
-      for (const json& topic : filterOptions["topics"]) {
-        const std::string& topicStr = topic.get<std::string>();
-        if (!_checkHexData(topicStr)) { errCode = 4; return; } // Invalid Hex Data
-      }
+    if (filterOptions.count("topics") && !_checkTopics(filterOptions["topics"])) {
+      errCode = 4; return; // Invalid Hex Data
     }
-    if (filterOptions.count("blockhash")) {
-      if (!_checkHexData(filterOptions["blockhash"])) { errCode = 4; return; } // Invalid Hex Data
-      if (!_checkHexLength(filterOptions["blockhash"], 32)) { errCode = 6; return; } // Invalid Hash Length
+    for (const char* key : {"blockHash", "blockhash"}) {
+      if (!filterOptions.count(key)) continue;
+      if (!_checkHexData(filterOptions[key])) { errCode = 4; return; } // Invalid Hex Data
+      if (!_checkHexLength(filterOptions[key], 32)) { errCode = 6; return; } // Invalid Hash Length
     }
   }();
   err.setCode(errCode);
   return (err.getCode() != 0) ? json::object()
-    : _buildJSON("eth_getLogs", {filterOptions});
+    : _buildJSON("eth_getLogs", json::array({filterOptions}));
+}
+
+json RPC::eth_subscribe(const std::string& type, Error &err) {
+  return eth_subscribe(type, json(), err);
+}
+
+json RPC::eth_subscribe(const std::string& type, json params, Error &err) {
+  if (type != "newHeads" && type != "logs" && type != "newPendingTransactions" && type != "syncing") {
+    err.setCode(40);  // Invalid Subscription Type
+  } else if (type == "logs" && !params.is_null()) {
+    RPC::eth_getLogs(params, err);  // Same rules as a log filter
+  }
+  if (err.getCode() != 0) return json::object();
+  json args = json::array({type});
+  if (!params.is_null()) args.push_back(params);
+  return _buildJSON("eth_subscribe", args);
+}
+
+json RPC::eth_unsubscribe(const std::string& subscriptionId, Error &err) {
+  err.setCode((!_checkHexData(subscriptionId)) ? 4 : 0);  // Invalid Hex Data
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_unsubscribe", {subscriptionId});
 }
 
 json RPC::eth_getWork() {
@@ -552,8 +667,20 @@ json RPC::eth_maxPriorityFeePerGas()
 
 json RPC::eth_feeHistory(uint64_t blockCount, BigNumber defaultBlock, std::vector<uint64_t> rewardPercentiles, Error &err)
 {
-    auto _defaultBlock = Utils::toHex(defaultBlock);
-    return eth_feeHistory(blockCount, _defaultBlock, rewardPercentiles, err);
+    return eth_feeHistory(blockCount, BlockTag::number(uint64_t(defaultBlock)), rewardPercentiles, err);
+}
+
+json RPC::eth_feeHistory(uint64_t blockCount, const BlockTag& defaultBlock, std::vector<uint64_t> rewardPercentiles, Error &err)
+{
+  int errCode = 0;
+  [&](){
+    if (!blockCount) { errCode = 10; return; }
+    if (defaultBlock.kind() == BlockTag::Hash) { errCode = 9; return; }
+    if (!_checkRewardPercentiles(rewardPercentiles)) { errCode = 38; return; }
+  }();
+  err.setCode(errCode);
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_feeHistory", {blockCount, defaultBlock.toJSON(), rewardPercentiles});
 }
 
 json RPC::eth_feeHistory(uint64_t blockCount, const std::string& defaultBlock, std::vector<uint64_t> rewardPercentiles, Error &err)
@@ -614,15 +741,27 @@ json RPC::anvil_addBalance(const std::string& address, BigNumber balance, Error
     }();
     err.setCode(errCode);
     return (err.getCode() != 0) ? json::object()
-      : _buildJSON("anvil_setBalance", {address, _balance});
+      : _buildJSON("anvil_addBalance", {address, _balance});
+}
+
+json RPC::anvil_setCode(const std::string& address, const std::string& code, Error &err)
+{
+    int errCode = 0;
+    [&](){
+      if (!_checkAddress(address)) { errCode = 5; return; }
+      if (!_checkHexData(code)) { errCode = 4; return; }
+    }();
+    err.setCode(errCode);
+    return (err.getCode() != 0) ? json::object()
+      : _buildJSON("anvil_setCode", {address, code});
 }
 
 json RPC::geth_txPoolStatus()
 {
-    return _buildJSON("txPoolStatus");
+    return _buildJSON("txpool_status");
 }
 
 json RPC::geth_txPoolContent()
 {
-    return _buildJSON("txPoolContent");
+    return _buildJSON("txpool_content");
 }
@@ -0,0 +1,63 @@
+#include <web3cpp/RPCMethods.h>
+
+const RPC::MethodInfo* RPC::findRequestMethod(const json& request) {
+  auto it = request.find("method");
+  if (it == request.end() || !it->is_string()) return nullptr;
+  return findMethod(std::string_view(it->get_ref<const std::string&>()));
+}
+
+void RPC::_writeQuantity(std::string& out, const BigNumber& value) {
+  static const char* digits = "0123456789abcdef";
+  if (value == 0) { out += "\"0x0\""; return; }
+  char buf[64];
+  std::size_t pos = sizeof(buf);
+  BigNumber v = value;
+  while (v != 0) {
+    buf[--pos] = digits[static_cast<unsigned>(v & 0xf)];
+    v >>= 4;
+  }
+  out += "\"0x";
+  out.append(buf + pos, sizeof(buf) - pos);
+  out += '"';
+}
+
+void RPC::_writeQuantity(std::string& out, uint64_t value) {
+  static const char* digits = "0123456789abcdef";
+  if (value == 0) { out += "\"0x0\""; return; }
+  char buf[16];
+  std::size_t pos = sizeof(buf);
+  while (value != 0) {
+    buf[--pos] = digits[value & 0xf];
+    value >>= 4;
+  }
+  out += "\"0x";
+  out.append(buf + pos, sizeof(buf) - pos);
+  out += '"';
+}
+
+void RPC::_writeString(std::string& out, std::string_view value) {
+  bool plain = std::all_of(value.begin(), value.end(), [](unsigned char c){
+    return c >= 0x20 && c < 0x7f && c != '"' && c != '\\';
+  });
+  if (!plain) { out += json(std::string(value)).dump(); return; }
+  out += '"'; out += value; out += '"';
+}
+
+BigNumber RPC::_parseQuantity(std::string_view hex) {
+  if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+    hex.remove_prefix(2);
+  }
+  if (hex.empty() || hex.size() > 64) {
+    throw std::invalid_argument("invalid quantity: " + std::string(hex));
+  }
+  BigNumber ret = 0;
+  for (char c : hex) {
+    unsigned nibble;
+    if (c >= '0' && c <= '9') nibble = c - '0';
+    else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+    else throw std::invalid_argument("invalid quantity: " + std::string(hex));
+    ret = (ret << 4) | nibble;
+  }
+  return ret;
+}
@@ -0,0 +1,217 @@
+#include <web3cpp/ReceiptWaiter.h>
+
+#include <algorithm>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+
+ReceiptWaiter::Options ReceiptWaiter::Options::fromContract(const Contract::Options& options) {
+  Options ret;
+  ret.confirmations = options.transactionConfirmationBlocks;
+  ret.timeout = std::chrono::seconds(options.transactionPollingTimeout);
+  ret.blockTimeout = options.transactionBlockTimeout;
+  return ret;
+}
+
+ReceiptWaiter::ReceiptWaiter(const std::unique_ptr<Provider>& provider, HeadTracker& heads)
+  : ReceiptWaiter(provider, heads, Options()) {}
+
+ReceiptWaiter::ReceiptWaiter(
+  const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options
+) : _provider(provider), _heads(heads), _options(options) {
+  if (this->_options.batchSize == 0) this->_options.batchSize = 1;
+}
+
+ReceiptWaiter::~ReceiptWaiter() {
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_stop = true;
+    listenerId = this->_listenerId;
+  }
+  if (listenerId != 0) this->_heads.unsubscribe(listenerId);
+  this->_wake.notify_all();
+  if (this->_worker.joinable()) this->_worker.join();
+}
+
+std::size_t ReceiptWaiter::pending() {
+  std::scoped_lock lock(this->_lock);
+  return this->_pending.size();
+}
+
+std::future<json> ReceiptWaiter::wait(const std::string& txHash) {
+  return this->wait(txHash, this->_options.confirmations);
+}
+
+std::future<json> ReceiptWaiter::wait(const std::string& txHash, unsigned int confirmations) {
+  Pending entry;
+  std::future<json> ret = entry.promise.get_future();
+  Error err;
+  RPC::eth_getTransactionReceipt(txHash, err);
+  if (err.getCode() != 0) {
+    json error;
+    error["error"]["message"] = err.what();
+    error["error"]["transactionHash"] = txHash;
+    entry.promise.set_value(error);
+    return ret;
+  }
+  entry.hash = txHash;
+  entry.confirmations = std::max(confirmations, 1u);
+  entry.deadline = std::chrono::steady_clock::now() + this->_options.timeout;
+
+  bool listen = false;
+  {
+    std::scoped_lock lock(this->_lock);
+    if (this->_haveHead) {
+      entry.hasStart = true;
+      entry.startBlock = this->_head;
+    }
+    this->_pending.push_back(std::move(entry));
+    this->_newPending = true;
+    // Start listening with the first transaction, so an unused waiter costs nothing.
+    if (!this->_worker.joinable()) {
+      this->_worker = std::thread([this]{ this->_run(); });
+      listen = true;
+    }
+  }
+  if (listen) {
+    uint64_t id = this->_heads.subscribe([this](const HeadTracker::Event& event){
+      std::scoped_lock lock(this->_lock);
+      this->_haveHead = true;
+      this->_head = event.head.number;
+      this->_newHead = true;
+      for (const HeadTracker::Header& header : event.removed) this->_orphaned.push_back(header.hash);
+      this->_wake.notify_all();
+    });
+    std::scoped_lock lock(this->_lock);
+    this->_listenerId = id;
+  }
+  this->_wake.notify_all();
+  return ret;
+}
+
+std::vector<json> ReceiptWaiter::_fetch(const std::vector<std::string>& hashes) {
+  std::vector<json> ret;
+  ret.reserve(hashes.size());
+  for (std::size_t i = 0; i < hashes.size(); i += this->_options.batchSize) {
+    std::size_t end = std::min(hashes.size(), i + this->_options.batchSize);
+    std::vector<json> requests;
+    for (std::size_t j = i; j < end; j++) {
+      Error err;
+      requests.push_back(RPC::eth_getTransactionReceipt(hashes[j], err));
+    }
+    std::vector<json> responses;
+    try {
+      responses = Net::HTTPBatchRequest(this->_provider, std::move(requests));
+    } catch (std::exception &e) {
+      // Try again on the next head.
+      responses.resize(end - i);
+    }
+    for (json& res : responses) {
+      ret.push_back((res.contains("result")) ? std::move(res["result"]) : json());
+    }
+  }
+  return ret;
+}
+
+void ReceiptWaiter::_run() {
+  using clock = std::chrono::steady_clock;
+  std::unique_lock lock(this->_lock);
+  while (!this->_stop) {
+    clock::time_point nextDeadline = clock::time_point::max();
+    for (const Pending& entry : this->_pending) nextDeadline = std::min(nextDeadline, entry.deadline);
+    this->_wake.wait_until(lock, nextDeadline, [&]{
+      return this->_stop || this->_newHead || this->_newPending;
+    });
+    if (this->_stop) break;
+    bool newHead = this->_newHead;
+    this->_newHead = this->_newPending = false;
+    const uint64_t head = this->_head;
+    const bool haveHead = this->_haveHead;
+    std::vector<std::string> orphaned = std::move(this->_orphaned);
+    this->_orphaned.clear();
+
+    // Receipts from orphaned blocks are stale, the transaction may be in
+    // another block now or back in the mempool.
+    std::vector<Pending*> polled;
+    std::vector<std::string> hashes;
+    for (Pending& entry : this->_pending) {
+      if (!entry.receipt.is_null() && std::find(
+        orphaned.begin(), orphaned.end(), entry.receipt.value("blockHash", "")
+      ) != orphaned.end()) entry.receipt = json();
+      if (!entry.hasStart && haveHead) { entry.hasStart = true; entry.startBlock = head; }
+      if (entry.receipt.is_null() && (newHead || !entry.checked)) {
+        polled.push_back(&entry);
+        hashes.push_back(entry.hash);
+      }
+    }
+
+    if (!hashes.empty()) {
+      // Entries are only removed by this thread, so the pointers stay valid.
+      lock.unlock();
+      std::vector<json> receipts = this->_fetch(hashes);
+      lock.lock();
+      for (std::size_t i = 0; i < polled.size(); i++) {
+        Pending& entry = *polled[i];
+        entry.checked = true;
+        std::optional<Quantity> number;
+        if (receipts[i].is_object() && receipts[i].contains("blockNumber") && receipts[i]["blockNumber"].is_string()) {
+          number = Quantity::fromHex(receipts[i]["blockNumber"].get<std::string>());
+        }
+        if (number) {
+          entry.receipt = std::move(receipts[i]);
+          entry.receiptBlock = static_cast<uint64_t>(number->value());
+        }
+      }
+    }
+
+    const clock::time_point now = clock::now();
+    for (auto it = this->_pending.begin(); it != this->_pending.end();) {
+      Pending& entry = *it;
+      bool confirmed = false;
+      if (!entry.receipt.is_null()) {
+        if (entry.confirmations <= 1) {
+          confirmed = true;
+        } else if (haveHead && head >= entry.receiptBlock && head - entry.receiptBlock + 1 >= entry.confirmations) {
+          // Make sure the block is still on the chain we're confirming against.
+          std::optional<HeadTracker::Header> block = this->_heads.header(entry.receiptBlock);
+          if (!block || block->hash == entry.receipt.value("blockHash", "")) {
+            confirmed = true;
+          } else {
+            entry.receipt = json();
+          }
+        }
+      }
+      if (confirmed) {
+        json ret;
+        ret["result"] = std::move(entry.receipt);
+        entry.promise.set_value(std::move(ret));
+        it = this->_pending.erase(it);
+        continue;
+      }
+      bool blocksUp = this->_options.blockTimeout != 0 && entry.receipt.is_null() &&
+        entry.hasStart && haveHead && head >= entry.startBlock &&
+        head - entry.startBlock >= this->_options.blockTimeout;
+      if (now >= entry.deadline || blocksUp) {
+        json ret;
+        ret["error"]["message"] = (blocksUp)
+          ? "Transaction was not included in " + std::to_string(this->_options.blockTimeout) + " blocks"
+          : "Timed out waiting for the transaction receipt";
+        ret["error"]["transactionHash"] = entry.hash;
+        entry.promise.set_value(std::move(ret));
+        it = this->_pending.erase(it);
+        continue;
+      }
+      it++;
+    }
+  }
+
+  for (Pending& entry : this->_pending) {
+    json ret;
+    ret["error"]["message"] = "Receipt waiter was stopped";
+    ret["error"]["transactionHash"] = entry.hash;
+    entry.promise.set_value(std::move(ret));
+  }
+  this->_pending.clear();
+}
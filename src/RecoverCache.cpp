@@ -0,0 +1,59 @@
+#include <web3cpp/RecoverCache.h>
+
+#include <algorithm>
+
+RecoverCache::RecoverCache() : RecoverCache(Options()) {}
+
+RecoverCache::RecoverCache(Options options) : _options(options) {}
+
+RecoverCache::Key RecoverCache::_key(const dev::h256& hash, const dev::Signature& signature) {
+  Key ret;
+  std::copy(hash.begin(), hash.end(), ret.data());
+  std::copy(signature.begin(), signature.end(), ret.data() + dev::h256::size);
+  return ret;
+}
+
+std::optional<dev::Address> RecoverCache::get(const dev::h256& hash, const dev::Signature& signature) {
+  const Key key = _key(hash, signature);
+  std::scoped_lock lock(this->_lock);
+  auto it = this->_index.find(key);
+  if (it == this->_index.end()) {
+    this->_stats.misses++;
+    return std::nullopt;
+  }
+  this->_entries.splice(this->_entries.begin(), this->_entries, it->second);
+  this->_stats.hits++;
+  return it->second->address;
+}
+
+void RecoverCache::put(const dev::h256& hash, const dev::Signature& signature, const dev::Address& address) {
+  const Key key = _key(hash, signature);
+  std::scoped_lock lock(this->_lock);
+  if (this->_options.maxEntries == 0) return;
+  auto it = this->_index.find(key);
+  if (it != this->_index.end()) {
+    it->second->address = address;
+    this->_entries.splice(this->_entries.begin(), this->_entries, it->second);
+    return;
+  }
+  this->_entries.push_front(Entry{key, address});
+  this->_index.emplace(key, this->_entries.begin());
+  while (this->_entries.size() > this->_options.maxEntries) {
+    this->_index.erase(this->_entries.back().key);
+    this->_entries.pop_back();
+    this->_stats.evictions++;
+  }
+  this->_stats.entries = this->_entries.size();
+}
+
+void RecoverCache::clear() {
+  std::scoped_lock lock(this->_lock);
+  this->_entries.clear();
+  this->_index.clear();
+  this->_stats.entries = 0;
+}
+
+RecoverCache::Stats RecoverCache::stats() const {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
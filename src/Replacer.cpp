@@ -0,0 +1,272 @@
+#include <web3cpp/Replacer.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+
+namespace {
+  /// Raise a fee by a percentage, rounding up.
+  dev::u256 raise(const dev::u256& fee, unsigned int percent) {
+    return (fee * (100 + percent) + 99) / 100;
+  }
+
+  /// Build an error result for a transaction.
+  json errorResult(const std::string& message, const std::string& hash) {
+    json ret;
+    ret["error"]["message"] = message;
+    ret["error"]["transactionHash"] = hash;
+    return ret;
+  }
+}
+
+Replacer::Replacer(const std::unique_ptr<Provider>& provider, HeadTracker& heads)
+  : Replacer(provider, heads, Options()) {}
+
+Replacer::Replacer(
+  const std::unique_ptr<Provider>& provider, HeadTracker& heads, Options options
+) : _provider(provider), _heads(heads), _options(options) {
+  this->_options.bumpPercent = std::max(this->_options.bumpPercent, 10u);
+  if (this->_options.batchSize == 0) this->_options.batchSize = 1;
+}
+
+Replacer::~Replacer() {
+  uint64_t listenerId;
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_stop = true;
+    listenerId = this->_listenerId;
+  }
+  if (listenerId != 0) this->_heads.unsubscribe(listenerId);
+  this->_wake.notify_all();
+  if (this->_worker.joinable()) this->_worker.join();
+}
+
+std::size_t Replacer::pending() {
+  std::scoped_lock lock(this->_lock);
+  return this->_pending.size();
+}
+
+Replacer::Stats Replacer::stats() {
+  std::scoped_lock lock(this->_lock);
+  return this->_stats;
+}
+
+bool Replacer::bumpFees(dev::eth::TransactionBase& tx, const dev::u256& baseFee) const {
+  const dev::u256 priority = tx.maxPriorityFeePerGas();
+  const dev::u256 max = tx.maxFeePerGas();
+  if (priority == dev::Invalid256 || max == dev::Invalid256) return false;
+  dev::u256 nextPriority = raise(priority, this->_options.bumpPercent);
+  dev::u256 nextMax = std::max(raise(max, this->_options.bumpPercent), baseFee * BASE_FEE_MULTIPLIER + nextPriority);
+  if (this->_options.maxFeePerGas != 0 && nextMax > this->_options.maxFeePerGas) {
+    // Capping is only worth it while the cap is still a valid replacement.
+    nextMax = this->_options.maxFeePerGas;
+    if (nextMax < raise(max, 10) || nextMax < nextPriority) return false;
+  }
+  tx.setFees(nextMax - nextPriority, nextPriority, 1);
+  return true;
+}
+
+std::future<json> Replacer::track(const dev::eth::TransactionBase& tx, const std::string& privateKey) {
+  std::optional<Signer> signer = Signer::fromPrivateKey(privateKey);
+  return this->track(tx, (signer) ? std::make_shared<const Signer>(*signer) : nullptr);
+}
+
+std::future<json> Replacer::track(const dev::eth::TransactionBase& tx, std::shared_ptr<const Signer> signer) {
+  Pending entry;
+  std::future<json> ret = entry.promise.get_future();
+  if (!signer || !tx.hasSignature() || tx.hasZeroSignature()) {
+    entry.promise.set_value(errorResult("Transaction must be signed and have a signer", ""));
+    return ret;
+  }
+  entry.tx = tx;
+  entry.signer = std::move(signer);
+  entry.nonce = static_cast<uint64_t>(tx.nonce());
+  entry.hashes.push_back("0x" + tx.sha3().hex());
+
+  bool listen = false;
+  {
+    std::scoped_lock lock(this->_lock);
+    this->_pending.push_back(std::move(entry));
+    this->_stats.tracked++;
+    // Start listening with the first transaction, so an unused replacer costs nothing.
+    if (!this->_worker.joinable()) {
+      this->_worker = std::thread([this]{ this->_run(); });
+      listen = true;
+    }
+  }
+  if (listen) {
+    uint64_t id = this->_heads.subscribe([this](const HeadTracker::Event& event){
+      std::scoped_lock lock(this->_lock);
+      this->_haveHead = true;
+      this->_head = event.head.number;
+      const json& header = event.head.header;
+      this->_baseFee = (header.is_object() && header.contains("baseFeePerGas") && header["baseFeePerGas"].is_string())
+        ? Utils::toBN(header["baseFeePerGas"].get<std::string>()) : dev::u256(0);
+      this->_newHead = true;
+      this->_wake.notify_all();
+    });
+    std::scoped_lock lock(this->_lock);
+    this->_listenerId = id;
+  }
+  return ret;
+}
+
+std::vector<json> Replacer::_send(std::vector<json> requests) {
+  std::vector<json> ret;
+  ret.reserve(requests.size());
+  for (std::size_t i = 0; i < requests.size(); i += this->_options.batchSize) {
+    std::size_t end = std::min(requests.size(), i + this->_options.batchSize);
+    std::vector<json> batch(
+      std::make_move_iterator(requests.begin() + i), std::make_move_iterator(requests.begin() + end)
+    );
+    std::vector<json> responses;
+    try {
+      responses = Net::HTTPBatchRequest(this->_provider, std::move(batch));
+    } catch (std::exception &e) {
+      // Tried again on the next head.
+    }
+    responses.resize(end - i, errorResult("Request failed", "")["error"]);
+    for (json& res : responses) ret.push_back(std::move(res));
+  }
+  return ret;
+}
+
+void Replacer::_run() {
+  std::unique_lock lock(this->_lock);
+  while (!this->_stop) {
+    this->_wake.wait(lock, [&]{ return this->_stop || this->_newHead; });
+    if (this->_stop) break;
+    this->_newHead = false;
+    const uint64_t head = this->_head;
+    const dev::u256 baseFee = this->_baseFee;
+    // Entries are only removed by this thread, so the pointers stay valid.
+    std::vector<Pending*> entries;
+    for (Pending& entry : this->_pending) {
+      if (!entry.hasStart) { entry.hasStart = true; entry.startBlock = entry.sentBlock = head; }
+      entries.push_back(&entry);
+    }
+    if (entries.empty()) continue;
+    lock.unlock();
+
+    // Nonces are read before the receipts, so a version mined in between
+    // still shows up in its receipt instead of looking like another
+    // transaction took the nonce.
+    std::vector<json> requests;
+    std::unordered_map<std::string, std::size_t> senderIndex;
+    std::vector<std::size_t> senderOf(entries.size());
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      const std::string& sender = entries[i]->signer->addressHex();
+      auto it = senderIndex.find(sender);
+      if (it == senderIndex.end()) {
+        it = senderIndex.emplace(sender, requests.size()).first;
+        Error err;
+        requests.push_back(RPC::eth_getTransactionCount(sender, BlockTag::latest(), err));
+      }
+      senderOf[i] = it->second;
+    }
+    std::vector<json> counts = this->_send(std::move(requests));
+    requests.clear();
+    for (Pending* entry : entries) {
+      for (const std::string& hash : entry->hashes) {
+        Error err;
+        requests.push_back(RPC::eth_getTransactionReceipt(hash, err));
+      }
+    }
+    std::vector<json> receipts = this->_send(std::move(requests));
+    requests.clear();
+
+    std::vector<std::pair<Pending*, json>> resolved;
+    std::vector<Pending*> bumped;
+    std::vector<dev::eth::TransactionBase> candidates;
+    std::size_t r = 0;
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      Pending& entry = *entries[i];
+      json ret;
+      bool checked = true;  // Whether every receipt was actually read
+      for (const std::string& hash : entry.hashes) {
+        json& res = receipts[r++];
+        if (!res.contains("result")) checked = false;
+        if (!ret.is_null() || !res.contains("result") || !res["result"].is_object()) continue;
+        if (!res["result"].contains("blockNumber") || !res["result"]["blockNumber"].is_string()) continue;
+        ret["result"] = std::move(res["result"]);
+        ret["transactionHash"] = hash;
+        ret["replacements"] = entry.hashes.size() - 1;
+      }
+      if (!ret.is_null()) { resolved.emplace_back(&entry, std::move(ret)); continue; }
+
+      const json& count = counts[senderOf[i]];
+      std::optional<Quantity> next = (count.contains("result") && count["result"].is_string())
+        ? Quantity::fromHex(count["result"].get<std::string>()) : std::nullopt;
+      if (checked && next && static_cast<uint64_t>(next->value()) > entry.nonce) {
+        resolved.emplace_back(&entry, errorResult(
+          "Transaction nonce was used by another transaction", entry.hashes.back()
+        ));
+        continue;
+      }
+      // After a reorg to a shorter chain the head can be below where it started.
+      if (this->_options.blockTimeout != 0 && head >= entry.startBlock
+        && head - entry.startBlock >= this->_options.blockTimeout
+      ) {
+        resolved.emplace_back(&entry, errorResult(
+          "Transaction was not included in " + std::to_string(this->_options.blockTimeout) + " blocks",
+          entry.hashes.back()
+        ));
+        continue;
+      }
+
+      if (entry.capped || entry.bumps >= this->_options.maxBumps) continue;
+      if (head < entry.sentBlock || head - entry.sentBlock < this->_options.stuckBlocks) continue;
+      dev::eth::TransactionBase candidate = entry.tx;
+      if (!this->bumpFees(candidate, baseFee)) { entry.capped = true; continue; }
+      Error err;
+      std::string signedTx = entry.signer->signTransaction(candidate, err);
+      if (err.getCode() != 0) continue;
+      json req = RPC::eth_sendRawTransaction(signedTx, err);
+      if (err.getCode() != 0) continue;
+      requests.push_back(std::move(req));
+      bumped.push_back(&entry);
+      candidates.push_back(std::move(candidate));
+    }
+
+    // Rejected replacements (e.g. still underpriced) are tried again from
+    // the same version once it's been stuck for long enough again.
+    std::vector<json> sent = this->_send(std::move(requests));
+    uint64_t replacements = 0;
+    for (std::size_t i = 0; i < bumped.size(); i++) {
+      Pending& entry = *bumped[i];
+      entry.sentBlock = head;
+      if (!sent[i].contains("result")) continue;
+      entry.tx = std::move(candidates[i]);
+      entry.hashes.push_back("0x" + entry.tx.sha3().hex());
+      entry.bumps++;
+      replacements++;
+    }
+
+    lock.lock();
+    this->_stats.replacements += replacements;
+    std::unordered_set<Pending*> done;
+    for (auto& [entry, ret] : resolved) {
+      if (ret.contains("result")) {
+        this->_stats.mined++;
+        if (ret["transactionHash"] != entry->hashes.front()) this->_stats.replaced++;
+      } else {
+        this->_stats.failed++;
+      }
+      entry->promise.set_value(std::move(ret));
+      done.insert(entry);
+    }
+    for (auto it = this->_pending.begin(); it != this->_pending.end();) {
+      it = (done.count(&*it)) ? this->_pending.erase(it) : std::next(it);
+    }
+  }
+
+  for (Pending& entry : this->_pending) {
+    entry.promise.set_value(errorResult("Replacer was stopped", entry.hashes.back()));
+  }
+  this->_pending.clear();
+}
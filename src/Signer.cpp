@@ -0,0 +1,52 @@
+#include <web3cpp/Signer.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <web3cpp/Utils.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/SHA3.h>
+
+Signer::Signer(const dev::Secret& secret)
+  : _secret(secret), _public(dev::toPublic(secret)), _address(dev::toAddress(_public)),
+  _addressHex(Utils::toChecksumAddress("0x" + _address.hex())) {}
+
+std::optional<Signer> Signer::fromPrivateKey(const std::string& privateKey) {
+  dev::bytes key = dev::fromHex(privateKey);
+  std::optional<Signer> signer;
+  if (key.size() == dev::Secret::size) {
+    signer.emplace(dev::Secret(key));
+    // An invalid key (zero or above the curve order) has no public key.
+    if (signer->_public == dev::Public()) signer.reset();
+  }
+  dev::bytesRef(&key).cleanse();
+  return signer;
+}
+
+bool Signer::isAddress(const std::string& address) const {
+  if (address.size() != 42) return false;
+  return Utils::toLowercaseAddress(address) == "0x" + this->_address.hex();
+}
+
+dev::Signature Signer::signHash(const dev::h256& hash) const {
+  return dev::sign(this->_secret, hash);
+}
+
+std::string Signer::signMessage(const std::string& data) const {
+  std::string signableData = std::string("\x19") + "Ethereum Signed Message:\n"
+    + boost::lexical_cast<std::string>(data.size()) + data;
+  dev::h256 messageHash = dev::sha3(signableData);
+  return std::string("0x") + dev::toHex(this->signHash(messageHash));
+}
+
+std::string Signer::signTransaction(dev::eth::TransactionBase& tx, Error &error) const {
+  try {
+    tx.sign(this->_secret);
+    if (!tx.hasSignature() || tx.hasZeroSignature()) { error.setCode(12); return ""; }
+    std::string signedTx = "0x" + dev::toHex(tx.rlp());
+    error.setCode(0);
+    return signedTx;
+  } catch (std::exception &e) {
+    error.setCode(12);
+    return "";
+  }
+}
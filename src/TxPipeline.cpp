@@ -0,0 +1,322 @@
+#include <web3cpp/TxPipeline.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <web3cpp/BlockTag.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/devcore/CommonData.h>
+
+TxPipeline::TxPipeline(Wallet& wallet) : TxPipeline(wallet, Options()) {}
+
+TxPipeline::TxPipeline(Wallet& wallet, Options options)
+  : _wallet(wallet), _options(options),
+    _gasCache(wallet.gasCache),
+    _buildQueue(options.queueCapacity), _estimateQueue(options.queueCapacity),
+    _signQueue(options.queueCapacity), _broadcastQueue(options.queueCapacity) {
+  if (this->_options.batchSize == 0) this->_options.batchSize = 1;
+  if (this->_options.buildWorkers == 0) this->_options.buildWorkers = 1;
+  if (this->_options.estimateWorkers == 0) this->_options.estimateWorkers = 1;
+  if (this->_options.broadcastWorkers == 0) this->_options.broadcastWorkers = 1;
+  if (this->_options.signWorkers == 0) {
+    this->_options.signWorkers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t i = 0; i < this->_options.buildWorkers; i++) {
+    this->_builders.emplace_back([this]{ this->_runBuild(); });
+  }
+  for (std::size_t i = 0; i < this->_options.estimateWorkers; i++) {
+    this->_estimators.emplace_back([this]{ this->_runEstimate(); });
+  }
+  for (std::size_t i = 0; i < this->_options.signWorkers; i++) {
+    this->_signers.emplace_back([this]{ this->_runSign(); });
+  }
+  for (std::size_t i = 0; i < this->_options.broadcastWorkers; i++) {
+    this->_broadcasters.emplace_back([this]{ this->_runBroadcast(); });
+  }
+}
+
+TxPipeline::~TxPipeline() { this->close(); }
+
+TxPipeline::Ticket TxPipeline::submit(Request request) {
+  JobPtr job = std::make_shared<Job>();
+  job->request = std::move(request);
+  Ticket ticket;
+  ticket.estimated = job->estimatedPromise.get_future().share();
+  ticket.signedTx = job->signedPromise.get_future().share();
+  ticket.submitted = job->submittedPromise.get_future().share();
+  {
+    std::scoped_lock lock(this->_statsLock);
+    this->_stats.submitted++;
+  }
+  if (!this->_buildQueue.push(job)) this->_fail(*job, uint64_t(42), false);  // Transaction Pipeline Closed
+  return ticket;
+}
+
+void TxPipeline::close() {
+  std::scoped_lock lock(this->_closeLock);
+  // Each stage drains before the next one is closed, so nothing in flight
+  // is pushed to a closed queue.
+  for (auto [queue, workers] : {
+    std::make_pair(&this->_buildQueue, &this->_builders),
+    std::make_pair(&this->_estimateQueue, &this->_estimators),
+    std::make_pair(&this->_signQueue, &this->_signers),
+    std::make_pair(&this->_broadcastQueue, &this->_broadcasters)
+  }) {
+    queue->close();
+    for (std::thread& worker : *workers) worker.join();
+    workers->clear();
+  }
+}
+
+TxPipeline::Stats TxPipeline::stats() const {
+  std::scoped_lock lock(this->_statsLock);
+  return this->_stats;
+}
+
+void TxPipeline::_fail(Job& job, const json& error, bool release) {
+  json res;
+  res["error"] = error;
+  if (job.resolved < 1) job.estimatedPromise.set_value(res);
+  if (job.resolved < 2) job.signedPromise.set_value(res);
+  if (job.resolved < 3) job.submittedPromise.set_value(res);
+  job.resolved = 3;
+  if (release && job.nonce && this->_wallet.nonces) {
+    this->_wallet.nonces->release(job.request.from, *job.nonce);
+  }
+  std::scoped_lock lock(this->_statsLock);
+  this->_stats.failed++;
+}
+
+void TxPipeline::_fail(Job& job, uint64_t code, bool release) {
+  Error err;
+  err.setCode(code);
+  json error;
+  error["code"] = code;
+  error["message"] = err.what();
+  this->_fail(job, error, release);
+}
+
+bool TxPipeline::_popBatch(BoundedQueue<JobPtr>& queue, std::vector<JobPtr>& batch) {
+  batch.clear();
+  JobPtr job;
+  if (!queue.pop(job)) return false;
+  batch.push_back(std::move(job));
+  while (batch.size() < this->_options.batchSize && queue.tryPop(job)) batch.push_back(std::move(job));
+  return true;
+}
+
+std::optional<json> TxPipeline::_fees() {
+  // Held during the request, so the other estimators wait for it instead of fetching too.
+  std::scoped_lock lock(this->_feeLock);
+  const auto now = std::chrono::steady_clock::now();
+  if (!this->_feeHistory.is_null() && now - this->_feeTime < this->_options.feeRefresh) {
+    return this->_feeHistory;
+  }
+  Error rpcErr;
+  json req = RPC::eth_feeHistory(5, BlockTag::latest(), {10, 50, 90}, rpcErr);
+  if (rpcErr.getCode() != 0) return std::nullopt;
+  try {
+    json res = json::parse(Net::HTTPRequest(this->_wallet.getProvider(), Net::RequestTypes::POST, req.dump()));
+    if (res.contains("error") || !res.contains("result")) return std::nullopt;
+    this->_feeHistory = res;
+    this->_feeTime = now;
+    return res;
+  } catch (std::exception &e) {
+    return std::nullopt;
+  }
+}
+
+void TxPipeline::_runBuild() {
+  JobPtr job;
+  while (this->_buildQueue.pop(job)) {
+    const Request& req = job->request;
+    Error err;
+    // Reserves the nonce, and releases it if the transaction can't be built.
+    job->skeleton = this->_wallet.buildTransaction(req.from, err, req.to, req.data, req.value, req.accessList);
+    if (err.getCode() != 0) { this->_fail(*job, err.getCode(), false); continue; }
+    job->nonce = static_cast<uint64_t>(job->skeleton.nonce);
+    this->_estimateQueue.push(std::move(job));
+  }
+}
+
+void TxPipeline::_runEstimate() {
+  std::vector<JobPtr> batch;
+  while (this->_popBatch(this->_estimateQueue, batch)) {
+    // Fees are the same for the whole batch.
+    std::shared_ptr<FeeOracle> oracle = this->_wallet.feeOracle;
+    std::optional<FeeOracle::Fees> fees = (oracle) ? oracle->fees() : std::nullopt;
+    std::optional<json> feeHistory = (fees) ? std::nullopt : this->_fees();
+    if (!fees && !feeHistory) {
+      for (JobPtr& job : batch) this->_fail(*job, uint64_t(36), true);  // Transaction Estimate Error
+      continue;
+    }
+
+    // Gas overrides and cache hits need no request, and with a cache, calls
+    // of the same shape within the batch share one. Without one, every
+    // transaction is estimated, since gas can depend on the arguments.
+    std::vector<dev::u256> gas(batch.size(), dev::Invalid256);
+    std::vector<std::size_t> requestOf(batch.size(), SIZE_MAX);
+    std::vector<json> requests;
+    std::vector<std::string> requestKeys;
+    std::unordered_map<std::string, std::size_t> keyRequests;
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      Job& job = *batch[i];
+      if (job.request.gas) { gas[i] = *job.request.gas; continue; }
+      json call = job.skeleton.toJson();
+      std::string key = (this->_gasCache) ? this->_gasCache->key(call) : std::string();
+      if (!key.empty()) {
+        std::optional<dev::u256> cached = this->_gasCache->get(key);
+        if (cached) { gas[i] = *cached; continue; }
+        auto it = keyRequests.find(key);
+        if (it != keyRequests.end()) { requestOf[i] = it->second; continue; }
+      }
+      Error rpcErr;
+      json req = RPC::eth_estimateGas(call, rpcErr);
+      if (rpcErr.getCode() != 0) { this->_fail(job, rpcErr.getCode(), true); continue; }
+      if (!key.empty()) keyRequests[key] = requests.size();
+      requestOf[i] = requests.size();
+      requests.push_back(std::move(req));
+      requestKeys.push_back(std::move(key));
+    }
+
+    std::vector<json> responses;
+    if (!requests.empty()) {
+      {
+        std::scoped_lock lock(this->_statsLock);
+        this->_stats.estimateRequests += requests.size();
+      }
+      try {
+        responses = Net::HTTPBatchRequest(this->_wallet.getProvider(), std::move(requests));
+      } catch (std::exception &e) {
+        // Network error, every estimate in the batch fails below.
+      }
+    }
+    std::vector<dev::u256> estimates(requestKeys.size(), dev::Invalid256);
+    for (std::size_t r = 0; r < responses.size() && r < estimates.size(); r++) {
+      if (!responses[r].contains("result") || !responses[r]["result"].is_string()) continue;
+      estimates[r] = Utils::toBN(responses[r]["result"].get<std::string>());
+      if (!requestKeys[r].empty()) this->_gasCache->put(requestKeys[r], estimates[r]);
+    }
+
+    uint64_t estimated = 0;
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      Job& job = *batch[i];
+      if (job.resolved != 0) continue;  // Failed above
+      const std::size_t r = requestOf[i];
+      if (r != SIZE_MAX) gas[i] = estimates[r];
+      if (gas[i] == dev::Invalid256) {
+        // Keep the node's reason (e.g. a revert) if there is one.
+        if (r < responses.size() && responses[r].contains("error")) {
+          this->_fail(job, responses[r]["error"], true);
+        } else {
+          this->_fail(job, uint64_t(36), true);
+        }
+        continue;
+      }
+      try {
+        job.tx = dev::eth::TransactionBase(job.skeleton);
+        job.tx.setFeeLevel(job.request.feeLevel);
+        job.tx.setGas(gas[i]);
+        if (fees) job.tx.setFees(fees->baseFee, fees->priority(job.tx.feeLevel()));
+        else job.tx.setFees(*feeHistory);
+      } catch (std::exception &e) {
+        this->_fail(job, uint64_t(36), true);
+        continue;
+      }
+      json obj = job.tx.toJson();
+      obj["nonce"] = Utils::toHex(BigNumber(*job.nonce));
+      job.estimatedPromise.set_value(std::move(obj));
+      job.resolved = 1;
+      estimated++;
+      this->_signQueue.push(std::move(batch[i]));
+    }
+    std::scoped_lock lock(this->_statsLock);
+    this->_stats.estimated += estimated;
+  }
+}
+
+void TxPipeline::_runSign() {
+  JobPtr job;
+  while (this->_signQueue.pop(job)) {
+    Error err;
+    job->signedTx = (job->request.signer)
+      ? this->_wallet.signTransaction(job->tx, *job->request.signer, err)
+      : this->_wallet.signTransaction(job->tx, job->request.privateKey, err);
+    if (err.getCode() != 0) { this->_fail(*job, err.getCode(), true); continue; }
+    json res;
+    res["signature"] = job->signedTx;
+    res["hash"] = "0x" + dev::toHex(job->tx.sha3());
+    job->signedPromise.set_value(std::move(res));
+    job->resolved = 2;
+    {
+      std::scoped_lock lock(this->_statsLock);
+      this->_stats.signedTxs++;
+    }
+    this->_broadcastQueue.push(std::move(job));
+  }
+}
+
+void TxPipeline::_runBroadcast() {
+  std::vector<JobPtr> batch;
+  while (this->_popBatch(this->_broadcastQueue, batch)) {
+    // Signing finishes out of order, send each sender's nonces in order.
+    std::sort(batch.begin(), batch.end(), [](const JobPtr& a, const JobPtr& b){ return *a->nonce < *b->nonce; });
+    std::vector<json> requests;
+    requests.reserve(batch.size());
+    for (const JobPtr& job : batch) {
+      Error rpcErr;
+      requests.push_back(RPC::eth_sendRawTransaction(job->signedTx, rpcErr));
+    }
+    std::vector<json> responses;
+    bool networkError = false;
+    try {
+      responses = Net::HTTPBatchRequest(this->_wallet.getProvider(), std::move(requests));
+    } catch (std::exception &e) {
+      networkError = true;
+    }
+    {
+      std::scoped_lock lock(this->_statsLock);
+      this->_stats.batches++;
+    }
+
+    uint64_t sent = 0;
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      Job& job = *batch[i];
+      const std::string& from = job.request.from;
+      if (networkError || i >= responses.size()) {
+        // The node may have got them anyway, so the nonces can't be released.
+        if (this->_wallet.nonces) this->_wallet.nonces->resync(from);
+        this->_fail(job, uint64_t(13), false);  // Transaction Send Error
+        continue;
+      }
+      json res;
+      res["signature"] = job.signedTx;
+      if (responses[i].contains("result") && responses[i]["result"].is_string()) {
+        res["result"] = responses[i]["result"].get<std::string>();
+        job.submittedPromise.set_value(std::move(res));
+        job.resolved = 3;
+        sent++;
+        continue;
+      }
+      // Rejected by the node: a nonce error means the local count drifted.
+      // The nonce is only given back if the rejection proves it unused,
+      // otherwise (e.g. "already known") the node's count is fetched again.
+      const json error = responses[i].value("error", json());
+      if (this->_wallet.nonces && !this->_wallet.nonces->handleError(from, error)) {
+        if (NonceManager::isNonceUnused(error)) {
+          this->_wallet.nonces->release(from, *job.nonce);
+        } else {
+          this->_wallet.nonces->resync(from);
+        }
+      }
+      res["error"] = std::move(responses[i]);
+      job.submittedPromise.set_value(std::move(res));
+      job.resolved = 3;
+      std::scoped_lock lock(this->_statsLock);
+      this->_stats.failed++;
+    }
+    std::scoped_lock lock(this->_statsLock);
+    this->_stats.sent += sent;
+  }
+}
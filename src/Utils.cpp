@@ -2,6 +2,8 @@
 #include <web3cpp/Utils.h>
 #include <web3cpp/Solidity.h>
 
+#include <thread>
+
 std::mutex storageLock;
 
 #ifdef __MINGW32__
@@ -181,6 +183,39 @@ bool Utils::checkAddressChecksum(std::string address) {
   return true;
 }
 
+bool Utils::isBloom(const std::string& bloom) {
+  return bloom.length() == 2 + 512 && isHexStrict(bloom);
+}
+
+bool Utils::isInBloom(const std::string& bloom, const std::string& value) {
+  if (!isBloom(bloom) || !isHexStrict(value)) return false;
+  dev::bytes bytes = dev::fromHex(value);
+  return isInBloom(dev::eth::LogBloom(stripHexPrefix(bloom)), dev::bytesConstRef(&bytes));
+}
+
+bool Utils::isInBloom(const dev::eth::LogBloom& bloom, dev::bytesConstRef value) {
+  // Three 11-bit indexes taken from the hash, same as the node does.
+  return bloom.contains(dev::sha3(value).bloomPart<3, 256>());
+}
+
+bool Utils::isContractAddressInBloom(const std::string& bloom, const std::string& address) {
+  if (!isAddress(address)) return false;
+  return isInBloom(bloom, "0x" + stripHexPrefix(address));
+}
+
+bool Utils::isUserEthereumAddressInBloom(const std::string& bloom, const std::string& address) {
+  if (!isAddress(address)) return false;
+  return isInBloom(bloom, "0x" + padLeft(stripHexPrefix(address), 64));
+}
+
+bool Utils::isTopic(const std::string& topic) {
+  return topic.length() == 2 + 64 && isHexStrict(topic);
+}
+
+bool Utils::isTopicInBloom(const std::string& bloom, const std::string& topic) {
+  return isTopic(topic) && isInBloom(bloom, topic);
+}
+
 std::string Utils::toHex(const std::string& value, bool prefixed) {
   std::stringstream ss;
   if (std::all_of(value.begin(), value.end(), ::isdigit)) { // Number string
@@ -403,6 +438,7 @@ json Utils::readJSONFile(boost::filesystem::path &filePath, Error &err) {
   json ret;
   storageLock.lock();
   if (!boost::filesystem::exists(filePath)) {
+    storageLock.unlock();
     err.setCode(33);  // JSON File Does Not Exist
     return ret;
   }
@@ -501,3 +537,18 @@ json Utils::toJson(dev::eth::AccessList accessList)
         j.push_back(item.toJson());
     return j;
 }
+
+void Utils::parallelFor(
+  std::size_t count, unsigned int threads,
+  const std::function<void(unsigned int, std::size_t, std::size_t)>& work
+) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, count)));
+  const std::size_t share = (count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < threads; t++) {
+    workers.emplace_back(work, t, std::min(count, t * share), std::min(count, (t + 1) * share));
+  }
+  work(0, 0, std::min(count, share));
+  for (std::thread& worker : workers) worker.join();
+}
@@ -4,6 +4,70 @@
 #include "web3cpp/ethcore/Common.h"
 #include <web3cpp/Wallet.h>
 
+#include <algorithm>
+
+namespace {
+  /**
+   * Send Anvil balance calls as parallel JSON-RPC batches, then read the
+   * balances back if asked.
+   * @param add If `true`, uses `anvil_addBalance`, otherwise `anvil_setBalance`.
+   */
+  Wallet::FundResult fundBatched(
+    const std::unique_ptr<Provider>& provider,
+    const std::vector<std::pair<std::string, BigNumber>>& amounts,
+    bool add, bool readBack, Eth::BulkOptions options
+  ) {
+    Wallet::FundResult ret;
+    const std::size_t count = amounts.size();
+    ret.ok = Net::HTTPBulkRequest(provider, count, options.batchSize, options.parallelism,
+      [&](std::size_t i, Error& err){
+        return (add)
+          ? RPC::anvil_addBalance(amounts[i].first, amounts[i].second, err)
+          : RPC::anvil_setBalance(amounts[i].first, amounts[i].second, err);
+      },
+      [](std::size_t, json& res){ return res.contains("result"); }
+    );
+    ret.failed = std::count(ret.ok.begin(), ret.ok.end(), false);
+
+    if (readBack && count > 0) {
+      std::vector<std::string> addresses;
+      addresses.reserve(count);
+      for (const auto& amount : amounts) addresses.push_back(amount.first);
+      Eth::BulkResult balances = Eth(provider).getBalance(addresses, BlockTag::latest(), options).get();
+      ret.balances = std::move(balances.values);
+      ret.block = balances.block;
+    }
+    return ret;
+  }
+
+  /// Hash a message as an "Ethereum Signed Message" (EIP-191), building it in `buffer`.
+  dev::h256 personalHash(std::string_view message, std::string& buffer) {
+    buffer.assign("\x19" "Ethereum Signed Message:\n");
+    buffer.append(std::to_string(message.size()));
+    buffer.append(message.data(), message.size());
+    return dev::sha3(buffer);
+  }
+
+  /// Parse a hex signature (r + s + v), with or without "0x", taking v as 0/1 or 27/28.
+  bool parseSignature(std::string_view hex, dev::Signature& signature) {
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+    if (hex.size() != dev::Signature::size * 2) return false;
+    auto nibble = [](char c) -> int {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+      if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+      return -1;
+    };
+    for (unsigned int i = 0; i < dev::Signature::size; i++) {
+      int high = nibble(hex[2 * i]), low = nibble(hex[2 * i + 1]);
+      if (high < 0 || low < 0) return false;
+      signature[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    if (signature[64] >= 27) signature[64] -= 27;
+    return true;
+  }
+}
+
 Account Wallet::createAccount(
   std::string name,
   std::string seed
@@ -16,7 +80,8 @@ Account Wallet::createAccount(
       addr,
       name,
       k.secret().hex(),
-      provider
+      provider,
+      0  // A new key has sent nothing
   );
 
   return acc;
@@ -24,48 +89,124 @@ Account Wallet::createAccount(
 
 std::optional<Account> Wallet::getAccount(
   std::string address, std::string name,
-  std::string privateKey, uint64_t nonce
+  std::string privateKey, std::optional<uint64_t> nonce
 ) {
-  if (!Utils::isAddress(address))
-      return std::nullopt;
-
-  dev::Secret s(dev::fromHex(privateKey));
+  std::optional<Signer> signer = Signer::fromPrivateKey(privateKey);
+  if (!signer) return std::nullopt;
+  return this->getAccount(address, name, *signer, nonce);
+}
 
-  if (Utils::toLowercaseAddress(address) != "0x" + toAddress(toPublic(s)).hex())
+std::optional<Account> Wallet::getAccount(
+  std::string address, std::string name,
+  const Signer& signer, std::optional<uint64_t> nonce
+) {
+  if (!Utils::isAddress(address) || !signer.isAddress(address))
     return std::nullopt;
 
   Account acc(
       address, name,
-      privateKey, provider,
+      signer.secret().makeInsecure().hex(), provider,
       nonce
   );
 
   return acc;
 }
 
+Wallet::LoadedAccounts Wallet::loadAccounts(
+  const std::vector<AccountEntry>& entries, Error &error,
+  bool withBalances, Eth::BulkOptions options
+) {
+  LoadedAccounts ret;
+  std::vector<std::string> addresses;
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    const AccountEntry& entry = entries[i];
+    std::optional<Signer> signer = Signer::fromPrivateKey(entry.privateKey);
+    std::optional<Account> acc = (signer) ? this->getAccount(entry.address, entry.name, *signer) : std::nullopt;
+    if (!acc) { ret.invalid.push_back(i); continue; }
+    ret.accounts.push_back(*acc);
+    addresses.push_back(entry.address);
+  }
+  if (addresses.empty()) {
+    error.setCode(0);
+    return ret;
+  }
+
+  // Balances are read at the block the nonces were, so both match.
+  Eth eth(this->provider);
+  Eth::BulkResult nonces = eth.getTransactionCount(addresses, BlockTag::latest(), options).get();
+  ret.block = nonces.block;
+  std::size_t failed = nonces.failed;
+  for (std::size_t i = 0; i < ret.accounts.size() && i < nonces.values.size(); i++) {
+    if (nonces.ok[i]) ret.accounts[i].setNonce(static_cast<uint64_t>(nonces.values[i]));
+  }
+  if (withBalances) {
+    Eth::BulkResult balances = eth.getBalance(addresses, nonces.block, options).get();
+    ret.balances = std::move(balances.values);
+    ret.balances.resize(ret.accounts.size());
+    failed += balances.failed;
+  }
+  error.setCode((failed) ? 39 : 0);  // Invalid RPC Response
+  return ret;
+}
+
+std::future<Wallet::FundResult> Wallet::setBalances(
+  const std::vector<std::pair<std::string, BigNumber>>& balances,
+  bool readBack, Eth::BulkOptions options
+) {
+  return std::async(std::launch::async, [=]{
+    return fundBatched(this->provider, balances, false, readBack, options);
+  });
+}
+
+std::future<Wallet::FundResult> Wallet::addBalances(
+  const std::vector<std::pair<std::string, BigNumber>>& amounts,
+  bool readBack, Eth::BulkOptions options
+) {
+  return std::async(std::launch::async, [=]{
+    return fundBatched(this->provider, amounts, true, readBack, options);
+  });
+}
+
 std::string Wallet::sign(std::string dataToSign, std::string privateKey)
 {
-  dev::Secret s(dev::toHex(privateKey));
-  std::string signableData = std::string("\x19") + "Ethereum Signed Message:\n"
-    + boost::lexical_cast<std::string>(dataToSign.size()) + dataToSign;
-  dev::h256 messageHash(dev::toHex(dev::sha3(signableData, false)));
-  dev::h520 signature = dev::sign(s, messageHash);
-  return std::string("0x") + dev::toHex(signature);
+  std::optional<Signer> signer = Signer::fromPrivateKey(privateKey);
+  return (signer) ? this->sign(dataToSign, *signer) : "";
+}
+
+std::string Wallet::sign(std::string dataToSign, const Signer& signer)
+{
+  return signer.signMessage(dataToSign);
 }
 
 std::string Wallet::ecRecover(std::string signedData, std::string signature)
 {
-  // Aleth does some stupidly arcane magic to make this work, better use it for now
-  if (signature.substr(0, 2) == "0x" || signature.substr(0, 2) == "0X") {
-    signature = signature.substr(2); // Remove "0x"
-  }
-  std::string data = std::string("\x19") + "Ethereum Signed Message:\n"
-    + boost::lexical_cast<std::string>(signedData.size())
-    + signedData;
-  dev::h256 messageHash(dev::toHex(dev::sha3(data, false)));
-  dev::h520 sig = dev::FixedHash<65>(signature);
-  dev::Public p = dev::recover(sig, messageHash);
-  return "0x" + dev::toHex(dev::toAddress(p));
+  dev::Address address = this->ecRecover({{signedData, signature}}, 1).front();
+  return (address) ? "0x" + dev::toHex(address) : "";
+}
+
+std::vector<dev::Address> Wallet::ecRecover(
+  const std::vector<std::pair<std::string_view, std::string_view>>& signedMessages,
+  unsigned int threads
+) {
+  std::vector<dev::Address> ret(signedMessages.size());
+  const std::shared_ptr<RecoverCache> cache = this->recoverCache;
+  // Each thread recovers a contiguous share, hashing in its own buffer.
+  Utils::parallelFor(ret.size(), threads, [&](unsigned int, std::size_t begin, std::size_t end) {
+    std::string buffer;
+    dev::Signature signature;
+    for (std::size_t i = begin; i < end; i++) {
+      if (!parseSignature(signedMessages[i].second, signature)) continue;
+      dev::h256 hash = personalHash(signedMessages[i].first, buffer);
+      if (cache) {
+        if (std::optional<dev::Address> hit = cache->get(hash, signature)) { ret[i] = *hit; continue; }
+      }
+      dev::Public pub = dev::recover(signature, hash);
+      if (!pub) continue;
+      ret[i] = dev::toAddress(pub);
+      if (cache) cache->put(hash, signature, ret[i]);
+    }
+  });
+  return ret;
 }
 
 dev::eth::TransactionSkeleton Wallet::buildTransaction(
@@ -90,9 +231,33 @@ dev::eth::TransactionSkeleton Wallet::buildTransaction(
   return tx;
 }
 
+dev::eth::TransactionSkeleton Wallet::buildTransaction(
+    std::string from, Error &error, std::string to,
+    std::string dataHex, BigNumber value, dev::eth::AccessList accessList
+)
+{
+  std::optional<uint64_t> nonce = (this->nonces) ? this->nonces->reserve(from, error) : std::nullopt;
+  if (!nonce) {
+    if (error.getCode() == 0) error.setCode(41);  // Nonce Sync Error, unless reserve() already set a code
+    return dev::eth::TransactionSkeleton();
+  }
+  dev::eth::TransactionSkeleton tx = this->buildTransaction(from, 0, error, to, dataHex, value, accessList);
+  if (error.getCode() != 0) {
+    this->nonces->release(from, *nonce);
+    return tx;
+  }
+  tx.nonce = *nonce;
+  return tx;
+}
+
 Wallet::Estimations Wallet::fetchEstimations(json& txObj)
 {
-    auto estimatedGasFut = std::async(std::launch::async, [this, txObj]() -> std::pair<dev::u256, int> {
+    std::shared_ptr<GasCache> gasCache = this->gasCache;
+    std::string gasKey = (gasCache) ? gasCache->key(txObj) : "";
+    std::optional<dev::u256> cachedGas = (!gasKey.empty()) ? gasCache->get(gasKey) : std::nullopt;
+    auto estimatedGasFut = std::async((cachedGas) ? std::launch::deferred : std::launch::async,
+      [this, txObj, gasCache, gasKey, cachedGas]() -> std::pair<dev::u256, int> {
+        if (cachedGas) return {*cachedGas, 0};
         Error rpcErr;
         std::string rpcStr = RPC::eth_estimateGas(txObj, rpcErr).dump();
         if (rpcErr.getCode() != 0) return {dev::Invalid256, rpcErr.getCode()};
@@ -103,13 +268,18 @@ Wallet::Estimations Wallet::fetchEstimations(json& txObj)
         json reqJson = json::parse(req);
 
         if (reqJson.contains("error")) return {dev::Invalid256, 36};
-        return {Utils::toBN(reqJson["result"].get<std::string>()), 0};
+        dev::u256 gas = Utils::toBN(reqJson["result"].get<std::string>());
+        if (!gasKey.empty()) gasCache->put(gasKey, gas);
+        return {gas, 0};
     });
 
-    auto feeHistoryFut = std::async(std::launch::async, [this]() -> std::pair<json, int> {
+    // With an oracle, fees cost no request at all.
+    std::optional<FeeOracle::Fees> fees = (this->feeOracle) ? this->feeOracle->fees() : std::nullopt;
+    auto feeHistoryFut = std::async((fees) ? std::launch::deferred : std::launch::async, [this, fees]() -> std::pair<json, int> {
+        if (fees) return {json{}, 0};
         Error rpcErr;
         std::string rpcStr = RPC::eth_feeHistory(
-            5, "latest", {10, 50, 90}, rpcErr
+            5, BlockTag::latest(), {10, 50, 90}, rpcErr
         ).dump();
 
         if (rpcErr.getCode() != 0) return {json{}, 36};
@@ -128,6 +298,7 @@ Wallet::Estimations Wallet::fetchEstimations(json& txObj)
     Estimations estim;
     estim.gas = gasRes.first;
     estim.feeHistory = feeRes.first;
+    estim.fees = fees;
 
     if (gasRes.second != 0 || feeRes.second != 0) {
         estim.errorCode = gasRes.second != 0 ? gasRes.second : feeRes.second;
@@ -151,7 +322,8 @@ dev::eth::TransactionBase Wallet::estimateTransaction(
     dev::eth::TransactionBase tx(txObj);
     tx.setFeeLevel(feeLevel);
     tx.setGas(res.gas);
-    tx.setFees(res.feeHistory);
+    if (res.fees) tx.setFees(res.fees->baseFee, res.fees->priority(tx.feeLevel()));
+    else tx.setFees(res.feeHistory);
 
     error.setCode(0);
     return tx;
@@ -169,7 +341,8 @@ dev::eth::TransactionBase Wallet::estimateTransaction(
     }
 
     txObj.setGas(res.gas);
-    txObj.setFees(res.feeHistory);
+    if (res.fees) txObj.setFees(res.fees->baseFee, res.fees->priority(txObj.feeLevel()));
+    else txObj.setFees(res.feeHistory);
     error.setCode(0);
 
     return txObj;
@@ -180,18 +353,101 @@ std::string Wallet::signTransaction(
 )
 {
     try {
-        std::stringstream txHexBuffer;
         dev::Secret s(dev::fromHex(privateKey));
         txObj.sign(s);
-        txHexBuffer << "0x" + dev::toHex(txObj.rlp());
+        std::string signedTx = "0x" + dev::toHex(txObj.rlp());
         error.setCode(0);
-        return txHexBuffer.str();
+        return signedTx;
     } catch (std::exception &e) {
         error.setCode(12);
         return "";
     }
 }
 
+std::string Wallet::signTransaction(
+    dev::eth::TransactionBase& txObj, const Signer& signer, Error &error
+)
+{
+    return signer.signTransaction(txObj, error);
+}
+
+Wallet::SignedBatch Wallet::signTransactions(
+    std::vector<dev::eth::TransactionBase>& txs, std::string privateKey,
+    Error &error, unsigned int threads
+)
+{
+    std::optional<Signer> signer = Signer::fromPrivateKey(privateKey);
+    if (!signer) {
+        error.setCode(12);
+        SignedBatch batch;
+        batch.offsets.assign(txs.size() + 1, 0);
+        return batch;
+    }
+    return this->signTransactions(txs, *signer, error, threads);
+}
+
+Wallet::SignedBatch Wallet::signTransactions(
+    std::vector<dev::eth::TransactionBase>& txs, const Signer& signer,
+    Error &error, unsigned int threads
+)
+{
+    SignedBatch batch;
+    batch.offsets.assign(txs.size() + 1, 0);
+    const dev::Secret& secret = signer.secret();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, txs.size())));
+
+    // Each thread signs a contiguous share and appends its RLP to its own
+    // buffer. The secp256k1 context is shared, signing only reads it.
+    std::vector<dev::bytes> encoded(threads);
+    std::vector<std::size_t> sizes(txs.size(), 0);
+    Utils::parallelFor(txs.size(), threads, [&](unsigned int t, std::size_t begin, std::size_t end) {
+        dev::RLPStream rlp;
+        encoded[t].reserve((end - begin) * 128);
+        for (std::size_t i = begin; i < end; i++) {
+            try {
+                txs[i].sign(secret);
+                if (!txs[i].hasSignature() || txs[i].hasZeroSignature()) continue;
+                rlp.clear();
+                txs[i].streamRLP(rlp);
+                const dev::bytes& out = rlp.out();
+                encoded[t].insert(encoded[t].end(), out.begin(), out.end());
+                sizes[i] = out.size();
+            } catch (std::exception &e) {
+                // Left empty.
+            }
+        }
+    });
+
+    // Offsets are known now, so the arena is allocated once and each
+    // thread writes the hex of its own share.
+    bool failed = false;
+    for (std::size_t i = 0; i < txs.size(); i++) {
+        if (sizes[i] == 0) failed = true;
+        batch.offsets[i + 1] = batch.offsets[i] + ((sizes[i]) ? 2 + sizes[i] * 2 : 0);
+    }
+    batch.arena.resize(batch.offsets.back());
+    Utils::parallelFor(txs.size(), threads, [&](unsigned int t, std::size_t begin, std::size_t end) {
+        static const char digits[] = "0123456789abcdef";
+        const dev::bytes& out = encoded[t];
+        std::size_t read = 0;
+        for (std::size_t i = begin; i < end; i++) {
+            if (sizes[i] == 0) continue;
+            char* write = &batch.arena[batch.offsets[i]];
+            *write++ = '0';
+            *write++ = 'x';
+            for (std::size_t b = read; b < read + sizes[i]; b++) {
+                *write++ = digits[out[b] >> 4];
+                *write++ = digits[out[b] & 0x0f];
+            }
+            read += sizes[i];
+        }
+    });
+
+    error.setCode((failed) ? 12 : 0);
+    return batch;
+}
+
 
 std::future<json> Wallet::sendTransaction(std::string signedTx, Error &error)
 {
@@ -4,10 +4,20 @@
 Web3::Web3() :
   defaultProvider(std::make_unique<Provider>(Provider(""))),
   wallet(defaultProvider),
-  eth(defaultProvider) {}
+  eth(defaultProvider),
+  heads(defaultProvider),
+  receipts(defaultProvider, heads) {}
 
 // Custom provider overload
 Web3::Web3(Provider provider) :
   defaultProvider(std::make_unique<Provider>(provider)),
   wallet(defaultProvider),
-  eth(defaultProvider) {}
+  eth(defaultProvider),
+  heads(defaultProvider),
+  receipts(defaultProvider, heads) {}
+
+Web3::~Web3() {
+  if (this->eth.cache) this->eth.cache->untrack();
+  this->eth.blockCache.reset();
+  this->wallet.feeOracle.reset();
+}
@@ -140,7 +140,7 @@ void TransactionBase::sign(Secret const& _priv)
     if (!signable()) return;
     auto sig = dev::sign(_priv, sha3(WithoutSignature));
     SignatureStruct sigStruct = *(SignatureStruct const*)&sig;
-    if (sigStruct.isValid()) m_vrs = sigStruct;
+    if (sigStruct.isValid()) { m_vrs = sigStruct; m_hashWith = h256(); }
 }
 
 json TransactionBase::toJson() const
@@ -272,14 +272,17 @@ void TransactionBase::setFees(const json& _f, uint64_t _m)
         BOOST_THROW_EXCEPTION(InvalidFeeHistoryResponse() << errinfo_comment("Missing baseFeePerGas in JSON"));
 
     u256 nextBaseFee = Utils::toBN(result["baseFeePerGas"].back());
-    nextBaseFee *= _m;
 
     if (!result.contains("reward") || result["reward"].empty())
         BOOST_THROW_EXCEPTION(InvalidFeeHistoryResponse() << errinfo_comment("Missing reward array in JSON"));
 
     auto& lastRewardArray = result["reward"].back();
-    u256 maxPriorityFee = Utils::toBN(lastRewardArray[m_feeLevel]);
+    setFees(nextBaseFee, Utils::toBN(lastRewardArray[m_feeLevel]), _m);
+}
 
-    m_maxPriorityFeePerGas = maxPriorityFee;
-    m_maxFeePerGas = nextBaseFee + maxPriorityFee;
+void TransactionBase::setFees(u256 const& _baseFee, u256 const& _priorityFee, uint64_t _m)
+{
+    clearSignature();
+    m_maxPriorityFeePerGas = _priorityFee;
+    m_maxFeePerGas = _baseFee * _m + _priorityFee;
 }
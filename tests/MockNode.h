@@ -0,0 +1,122 @@
+#ifndef MOCKNODE_H
+#define MOCKNODE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Provider.h>
+
+using json = nlohmann::ordered_json;
+
+// Local JSON-RPC node for tests that need to control every response
+// (errors, timing, chain state) without a real node.
+// Each request is passed to the handler, which returns its `result` or an
+// object with an `error`. Batches are split into single requests.
+// Connections are served on threads of their own, so the handler must be
+// thread safe.
+
+class MockNode {
+  public:
+    using Handler = std::function<json(const json& request)>;
+
+  private:
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor acceptor;
+    Handler handler;
+    std::atomic<bool> stopping = false;
+    std::mutex lock;
+    std::vector<std::thread> connections;
+    std::thread listener;
+
+    json respond(const json& request) {
+      json ret;
+      ret["jsonrpc"] = "2.0";
+      ret["id"] = (request.is_object() && request.contains("id")) ? request["id"] : json(nullptr);
+      json res = this->handler(request);
+      if (res.is_object() && res.contains("error")) {
+        ret["error"] = res["error"];
+      } else {
+        ret["result"] = res;
+      }
+      return ret;
+    }
+
+    void serve(boost::asio::ip::tcp::socket socket) {
+      namespace http = boost::beast::http;
+      try {
+        boost::beast::flat_buffer buffer;
+        http::request<http::string_body> req;
+        http::read(socket, buffer, req);
+        json body = json::parse(req.body());
+        json out;
+        if (body.is_array()) {
+          out = json::array();
+          for (const json& item : body) out.push_back(this->respond(item));
+        } else {
+          out = this->respond(body);
+        }
+        http::response<http::string_body> res{http::status::ok, req.version()};
+        res.set(http::field::content_type, "application/json");
+        res.keep_alive(false);
+        res.body() = out.dump();
+        res.prepare_payload();
+        http::write(socket, res);
+        boost::system::error_code ec;
+        socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+      } catch (std::exception &e) {
+        // The client went away, nothing to answer.
+      }
+    }
+
+  public:
+    // Start listening on a free local port.
+    MockNode(Handler handler)
+      : acceptor(ioc, {boost::asio::ip::make_address("127.0.0.1"), 0}), handler(std::move(handler))
+    {
+      this->listener = std::thread([this]{
+        while (!this->stopping) {
+          boost::asio::ip::tcp::socket socket(this->ioc);
+          boost::system::error_code ec;
+          this->acceptor.accept(socket, ec);
+          if (ec || this->stopping) continue;
+          std::scoped_lock l(this->lock);
+          this->connections.emplace_back([this, s = std::move(socket)]() mutable { this->serve(std::move(s)); });
+        }
+      });
+    }
+
+    ~MockNode() {
+      this->stopping = true;
+      // Wake the listener up from accept().
+      boost::system::error_code ec;
+      boost::asio::ip::tcp::socket waker(this->ioc);
+      waker.connect(this->acceptor.local_endpoint(), ec);
+      this->listener.join();
+      std::scoped_lock l(this->lock);
+      for (std::thread& connection : this->connections) connection.join();
+    }
+
+    uint16_t port() const { return this->acceptor.local_endpoint().port(); }
+
+    // A provider that sends its requests to this node.
+    std::unique_ptr<Provider> provider() const {
+      return std::make_unique<Provider>("mock", "127.0.0.1", "/", this->port(), 31337, "ETH", "");
+    }
+
+    // Build the `error` response for a handler.
+    static json error(int code, const std::string& message) {
+      return {{"error", {{"code", code}, {"message", message}}}};
+    }
+};
+
+#endif  // MOCKNODE_H
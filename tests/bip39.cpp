@@ -117,5 +117,21 @@ namespace TBip39
             }
         REQUIRE(allOk != false);
         }
+
+        SECTION("Bulk Derivation")
+        {
+            std::string seed = "corn girl crouch desk duck save hedgehog choose kitchen unveil dragon space";
+            BIP39::AccountDeriver deriver(seed);
+            std::vector<BIP39::DerivedAccount> accounts = deriver.derive(0, 1000, 4);
+            REQUIRE(accounts.size() == 1000);
+            REQUIRE(accounts[0].address == "0x3e8467983ba80734654208b274ebf01264526117");
+            REQUIRE(accounts[9].address == "0xcb16f1d7221eaf229cf7a385c1e9993160decce7");
+            for (uint32_t i : {0u, 9u, 250u, 999u})
+            {
+                REQUIRE(accounts[i].index == i);
+                REQUIRE(accounts[i].address == deriver.derive(i).address);
+                REQUIRE(accounts[i].secret == dev::Secret::fromBip3x(BIP39::createKey(seed, "m/44'/60'/0'/0/" + std::to_string(i)).privateKey));
+            }
+        }
     }
 }
\ No newline at end of file
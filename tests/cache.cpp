@@ -0,0 +1,139 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/GasCache.h"
+#include "../include/web3cpp/ImmutableCache.h"
+#include <string>
+#include <thread>
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TCache
+{
+    TEST_CASE("Immutable Cache")
+    {
+        SECTION("Keys ignore case")
+        {
+            string lower = ImmutableCache::key("eth_getTransactionReceipt", json::array({"0xabcdef"}));
+            string upper = ImmutableCache::key("eth_getTransactionReceipt", json::array({"0xABCDEF"}));
+            REQUIRE_THAT(lower, Equals(upper));
+            REQUIRE(lower != ImmutableCache::key("eth_getTransactionByHash", json::array({"0xabcdef"})));
+        }
+
+        SECTION("Hits and misses")
+        {
+            ImmutableCache cache;
+            REQUIRE(!cache.get("a"));
+            cache.put("a", json({{"number", "0x1"}}));
+            auto hit = cache.get("a");
+            REQUIRE(hit);
+            REQUIRE_THAT((*hit)["number"].get<string>(), Equals("0x1"));
+            auto stats = cache.stats();
+            REQUIRE(stats.hits == 1);
+            REQUIRE(stats.misses == 1);
+            REQUIRE(stats.entries == 1);
+            REQUIRE(stats.bytes > 0);
+        }
+
+        SECTION("Evicts the least recently used entries")
+        {
+            ImmutableCache::Options options;
+            options.maxBytes = 2048;
+            ImmutableCache cache(options);
+            string value(400, 'x');
+            cache.put("a", value);
+            cache.put("b", value);
+            cache.put("c", value);
+            REQUIRE(cache.get("a"));  // "b" is now the oldest
+            cache.put("d", value);
+            REQUIRE(cache.get("a"));
+            REQUIRE(!cache.get("b"));
+            REQUIRE(cache.get("c"));
+            REQUIRE(cache.get("d"));
+            REQUIRE(cache.stats().evictions == 1);
+            REQUIRE(cache.stats().bytes <= options.maxBytes);
+            cache.put("big", string(4096, 'x'));  // Larger than the whole budget
+            REQUIRE(!cache.get("big"));
+            REQUIRE(cache.get("a"));
+        }
+
+        SECTION("Block data needs a head")
+        {
+            ImmutableCache cache;
+            REQUIRE(!cache.isFinal(1));
+            REQUIRE(!cache.put("a", "0x", 1));
+            REQUIRE(!cache.get("a"));
+            cache.put("b", "0x");
+            cache.clear();
+            REQUIRE(cache.stats().entries == 0);
+            REQUIRE(!cache.get("b"));
+        }
+    }
+
+    TEST_CASE("Gas Cache")
+    {
+        json transfer = {
+            {"from", "0x1111111111111111111111111111111111111111"},
+            {"to", "0x2222222222222222222222222222222222222222"},
+            {"data", "0xa9059cbb0000000000000000000000003333333333333333333333333333333333333333"}
+        };
+
+        SECTION("Keys follow the call shape")
+        {
+            GasCache cache;
+            json other = transfer;
+            other["from"] = "0x4444444444444444444444444444444444444444";
+            other["data"] = "0xA9059CBB0000000000000000000000005555555555555555555555555555555555555555";
+            REQUIRE_THAT(cache.key(transfer), Equals(cache.key(other)));
+            other["value"] = "0x1";
+            REQUIRE(cache.key(transfer) != cache.key(other));
+            other["value"] = "0x0";
+            REQUIRE_THAT(cache.key(transfer), Equals(cache.key(other)));
+            json creation = transfer;
+            creation.erase("to");
+            REQUIRE(cache.key(creation).empty());
+        }
+
+        SECTION("Keys can include the calldata and sender class")
+        {
+            GasCache::Options options;
+            options.keyByCalldata = true;
+            options.senderClass = [](const json& tx) { return tx.value("from", ""); };
+            GasCache cache(options);
+            json other = transfer;
+            other["data"] = "0xa9059cbb0000000000000000000000005555555555555555555555555555555555555555";
+            REQUIRE(cache.key(transfer) != cache.key(other));
+            other = transfer;
+            other["from"] = "0x4444444444444444444444444444444444444444";
+            REQUIRE(cache.key(transfer) != cache.key(other));
+        }
+
+        SECTION("Estimates expire")
+        {
+            GasCache::Options options;
+            options.ttl = std::chrono::milliseconds(50);
+            GasCache cache(options);
+            std::string key = cache.key(transfer);
+            REQUIRE(!cache.get(key));
+            cache.put(key, 51000);
+            REQUIRE(cache.get(key) == dev::u256(51000));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            REQUIRE(!cache.get(key));
+            REQUIRE(cache.stats().entries == 0);
+        }
+
+        SECTION("Every Nth hit is re-validated")
+        {
+            GasCache::Options options;
+            options.revalidateEvery = 3;
+            GasCache cache(options);
+            std::string key = cache.key(transfer);
+            cache.put(key, 51000);
+            REQUIRE(cache.get(key));
+            REQUIRE(cache.get(key));
+            REQUIRE(!cache.get(key));
+            REQUIRE(cache.stats().revalidations == 1);
+            cache.put(key, 52000);
+            REQUIRE(cache.get(key) == dev::u256(52000));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/Keystore.h"
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TKeystore
+{
+    TEST_CASE("Keystore Tests")
+    {
+        SECTION("Decrypt Test Vector")
+        {
+            // PBKDF2 test vector from the Web3 Secret Storage definition.
+            json keystore = json::parse(R"({"crypto":{"cipher":"aes-128-ctr","cipherparams":{"iv":"6087dab2f9fdbbfaddc31a909735c1e6"},"ciphertext":"5318b4d5bcd28de64ee5559e671353e16f075ecae9f99c7a79a38af5f869aa46","kdf":"pbkdf2","kdfparams":{"c":262144,"dklen":32,"prf":"hmac-sha256","salt":"ae3cd4e7013836a3df6bd7241b12db061dbe2c6785853cce422d148a624ce0bd"},"mac":"517ead924a9d0dc3124507e3393d175ce3ff7c1e96529c6c555ce9e51205e9b2"},"id":"3198bc9c-6672-5ab3-d995-4942343ae5b6","version":3})");
+            Error e1, e2;
+            std::optional<dev::Secret> secret = Keystore::decrypt(keystore, "testpassword", e1);
+            REQUIRE(e1.getCode() == 0);
+            REQUIRE(secret);
+            REQUIRE_THAT(secret->makeInsecure().hex(), Equals("7a28b5ba57c53603b0b07b56bba752f7784bf506fa95edc395f5cf6c7514fe9d"));
+            REQUIRE(!Keystore::decrypt(keystore, "wrongpassword", e2));
+            REQUIRE(e2.getCode() == 15);
+            REQUIRE(Keystore::memoryCost(keystore) == 0);
+        }
+
+        SECTION("Encrypt And Load")
+        {
+            // A low scrypt cost keeps the test fast, the format is the same.
+            Keystore::Options options;
+            options.scryptN = 1 << 12;
+            boost::filesystem::path folder = boost::filesystem::temp_directory_path() / "web3cpp-keystore-test";
+            boost::filesystem::create_directories(folder);
+
+            std::vector<dev::Secret> secrets;
+            std::vector<Keystore::Entry> entries;
+            for (int i = 0; i < 8; i++)
+            {
+                secrets.push_back(dev::Secret::random());
+                entries.push_back({folder / ("key" + std::to_string(i) + ".json"), "password" + std::to_string(i)});
+                Error e;
+                Keystore::exportFile(secrets[i], entries[i].password, entries[i].path, e, options);
+                REQUIRE(e.getCode() == 0);
+            }
+            entries.push_back({folder / "missing.json", "password"});
+            entries.push_back({entries[0].path, "wrongpassword"});
+
+            Error e1;
+            json keystore = Keystore::encrypt(secrets[0], "password", e1, options);
+            REQUIRE(e1.getCode() == 0);
+            REQUIRE(keystore["version"] == 3);
+            REQUIRE(keystore["address"] == dev::toAddress(secrets[0]).hex());
+            REQUIRE(Keystore::memoryCost(keystore) > 128 * 8 * options.scryptN);
+
+            // Let only two derivations run at the same time.
+            Keystore::LoadOptions loadOptions;
+            loadOptions.threads = 4;
+            loadOptions.memoryBudget = 2 * Keystore::memoryCost(keystore);
+            Keystore::LoadResult result = Keystore::load(entries, loadOptions);
+            REQUIRE(result.failed == 2);
+            REQUIRE(result.peakDerivations >= 1);
+            REQUIRE(result.peakDerivations <= 2);
+            for (int i = 0; i < 8; i++)
+            {
+                REQUIRE(result.errors[i] == 0);
+                REQUIRE(result.signers[i]);
+                REQUIRE(result.signers[i]->secret() == secrets[i]);
+            }
+            REQUIRE(!result.signers[8]);
+            REQUIRE(result.errors[8] == 33);
+            REQUIRE(result.errors[9] == 15);
+
+            Error e2;
+            std::optional<Signer> signer = Keystore::importFile(entries[3].path, entries[3].password, e2);
+            REQUIRE(e2.getCode() == 0);
+            REQUIRE(signer);
+            REQUIRE(signer->address() == dev::toAddress(secrets[3]));
+            boost::filesystem::remove_all(folder);
+        }
+    }
+}
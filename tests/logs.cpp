@@ -0,0 +1,302 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/LogScanner.h"
+#include "../include/web3cpp/LogStream.h"
+#include "../include/web3cpp/LogSubscription.h"
+#include "../include/web3cpp/RPC.h"
+#include "../include/web3cpp/Utils.h"
+#include "MockNode.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TLogs
+{
+    const std::string logObject = R"({
+        "address":"0x2e913a79206280b3882860b3ef4df8204a62c8b1",
+        "topics":["0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef"],
+        "data":"0x00000000000000000000000000000000000000000000000000000000000003e8",
+        "blockNumber":"0x1b4",
+        "blockHash":"0x88df016429689c079f3b2f6ad39fa052532c56795b733da78a91ebe6a713944b",
+        "transactionHash":"0xdf829c5a142f1fccd7d8216c5785ac562ff41e2dcfdf5785ac562ff41e2dcfe0",
+        "transactionIndex":"0x1",
+        "logIndex":"0x2",
+        "removed":false
+    })";
+
+    std::string buildResponse(std::size_t count) {
+        std::string ret = R"({"jsonrpc":"2.0","id":1,"result":[)";
+        for (std::size_t i = 0; i < count; i++) {
+            if (i != 0) ret += ',';
+            ret += logObject;
+        }
+        return ret + "]}";
+    }
+
+    TEST_CASE("Log Decoding", "[logs]")
+    {
+        SECTION("Decode a log object")
+        {
+            std::optional<Log> log = Log::fromJSON(json::parse(logObject));
+            REQUIRE(log);
+            REQUIRE(log->address == dev::Address("0x2e913a79206280b3882860b3ef4df8204a62c8b1"));
+            REQUIRE(log->topics.size() == 1);
+            REQUIRE(log->data.size() == 32);
+            REQUIRE(log->blockNumber == 436);
+            REQUIRE(log->logIndex == 2);
+            REQUIRE(Log::fromJSON(log->toJSON())->toJSON() == log->toJSON());
+        }
+
+        SECTION("Reject malformed log objects")
+        {
+            json log = json::parse(logObject);
+            log["address"] = "0x1234";
+            REQUIRE(!Log::fromJSON(log));
+            REQUIRE(!Log::fromJSON(json::array()));
+        }
+    }
+
+    TEST_CASE("Log Streaming", "[logs]")
+    {
+        SECTION("Stream every log in the response")
+        {
+            std::istringstream in(buildResponse(1000));
+            std::size_t count = 0;
+            json ret = LogStream::parse(in, [&](const Log& log){
+                REQUIRE(log.blockNumber == 436);
+                count++;
+                return true;
+            });
+            REQUIRE(count == 1000);
+            REQUIRE(ret["result"] == 1000);
+            REQUIRE(ret["id"] == 1);
+        }
+
+        SECTION("Stop streaming early")
+        {
+            std::istringstream in(buildResponse(10));
+            std::size_t count = 0;
+            json ret = LogStream::parse(in, [&](const Log&){ return ++count < 3; });
+            REQUIRE(count == 3);
+            REQUIRE(!ret.count("error"));
+        }
+
+        SECTION("Keep node errors")
+        {
+            std::istringstream in(
+                R"({"jsonrpc":"2.0","id":1,"error":{"code":-32005,"message":"query returned more than 10000 results"}})"
+            );
+            json ret = LogStream::parse(in, [](const Log&){ return true; });
+            REQUIRE(ret["error"]["code"] == -32005);
+        }
+
+        SECTION("Report malformed responses")
+        {
+            std::istringstream in(R"({"jsonrpc":"2.0","id":1,"result":[{"address":"0x12"}]})");
+            REQUIRE(LogStream::parse(in, [](const Log&){ return true; }).count("error"));
+            std::istringstream truncated(buildResponse(2).substr(0, 200));
+            REQUIRE(LogStream::parse(truncated, [](const Log&){ return true; }).count("error"));
+        }
+
+        SECTION("Finished streams have no logs")
+        {
+            json err;
+            err["error"]["message"] = "Invalid Block Number";
+            LogStream stream(err);
+            std::size_t count = 0;
+            for (const Log& log : stream) { (void)log; count++; }
+            REQUIRE(count == 0);
+            REQUIRE(stream.response() == err);
+        }
+    }
+
+    TEST_CASE("Log Scanning", "[logs]")
+    {
+        SECTION("Detect ranges that are too large")
+        {
+            REQUIRE(LogScanner::isRangeTooLarge(json::parse(
+                R"({"code":-32005,"message":"query returned more than 10000 results"})"
+            )));
+            REQUIRE(LogScanner::isRangeTooLarge(json::parse(
+                R"({"code":-32000,"message":"Log response size exceeded. You can make eth_getLogs requests with up to a 2K block range"})"
+            )));
+            REQUIRE(!LogScanner::isRangeTooLarge(json::parse(
+                R"({"code":-32602,"message":"invalid argument 0: hex string without 0x prefix"})"
+            )));
+        }
+
+        SECTION("Build filters with wildcard topics")
+        {
+            Error err;
+            json filter = {
+                {"fromBlock", "0x1"}, {"toBlock", "0x2"},
+                {"topics", {nullptr, {"0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef", nullptr}}}
+            };
+            json req = RPC::eth_getLogs(filter, err);
+            REQUIRE(err.getCode() == 0);
+            REQUIRE(req["params"].is_array());
+            REQUIRE(req["params"][0]["topics"][0].is_null());
+        }
+
+        // Node that has one log per block and takes a random time to answer.
+        // Ranges wider than maxRange are rejected for having too many results.
+        struct LogNode {
+            std::mutex lock;
+            std::mt19937 rng{42};
+            uint64_t maxRange = UINT64_MAX;
+            std::vector<std::pair<uint64_t, uint64_t>> served, rejected;
+
+            json operator()(const json& request) {
+                const json& filter = request["params"][0];
+                uint64_t from = uint64_t(Utils::hexToBigNumber(filter["fromBlock"].get<std::string>()));
+                uint64_t to = uint64_t(Utils::hexToBigNumber(filter["toBlock"].get<std::string>()));
+                std::chrono::milliseconds delay;
+                {
+                    std::scoped_lock l(lock);
+                    if (to - from + 1 > maxRange) {
+                        rejected.emplace_back(from, to);
+                        return MockNode::error(-32005, "query returned more than 10000 results");
+                    }
+                    served.emplace_back(from, to);
+                    delay = std::chrono::milliseconds(rng() % 20);
+                }
+                std::this_thread::sleep_for(delay);
+                json logs = json::array();
+                for (uint64_t block = from; block <= to; block++) {
+                    json log = json::parse(logObject);
+                    log["blockNumber"] = Utils::toHex(BigNumber(block));
+                    logs.push_back(log);
+                }
+                return logs;
+            }
+        };
+
+        SECTION("Scan in chunks and deliver in block order")
+        {
+            LogNode logNode;
+            MockNode node([&](const json& request){ return logNode(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            LogScanner::Options options;
+            options.initialChunk = 10;
+            options.maxChunk = 10;
+            options.parallelism = 4;
+            LogScanner scanner(provider, options);
+            std::vector<uint64_t> blocks;
+            json ret = scanner.scan(json::object(), 100, 299, [&](const Log& log){
+                blocks.push_back(log.blockNumber);
+                return true;
+            }).get();
+            REQUIRE(ret["result"] == 200);
+            REQUIRE(blocks.size() == 200);
+            for (std::size_t i = 0; i < blocks.size(); i++) REQUIRE(blocks[i] == 100 + i);
+            REQUIRE(logNode.served.size() == 20);
+            for (const auto& [from, to] : logNode.served) REQUIRE(to - from + 1 == 10);
+        }
+
+        SECTION("Bisect ranges with too many results")
+        {
+            LogNode logNode;
+            logNode.maxRange = 8;
+            MockNode node([&](const json& request){ return logNode(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            LogScanner::Options options;
+            options.initialChunk = 64;
+            options.parallelism = 3;
+            options.sparseThreshold = 0;  // Don't grow back
+            LogScanner scanner(provider, options);
+            uint64_t next = 0;
+            json ret = scanner.scan(json::object(), 0, 127, [&](const Log& log){
+                REQUIRE(log.blockNumber == next++);
+                return true;
+            }).get();
+            REQUIRE(ret["result"] == 128);
+            REQUIRE(next == 128);
+            REQUIRE(!logNode.rejected.empty());
+            for (const auto& [from, to] : logNode.served) REQUIRE(to - from + 1 <= 8);
+        }
+
+        SECTION("Failed ranges are reported")
+        {
+            MockNode node([](const json& request) -> json {
+                if (request["params"][0]["fromBlock"] == "0xa") return {{"error", "boom"}};
+                return json::array();
+            });
+            std::unique_ptr<Provider> provider = node.provider();
+            LogScanner::Options options;
+            options.initialChunk = 10;
+            options.maxRetries = 0;
+            LogScanner scanner(provider, options);
+            json ret = scanner.scan(json::object(), 0, 29, [](const Log&){ return true; }).get();
+            REQUIRE(ret["error"]["message"] == "boom");
+            REQUIRE(ret["error"]["fromBlock"] == "0xa");
+            REQUIRE(ret["error"]["toBlock"] == "0x13");
+        }
+    }
+
+    // Bloom of a block with a single log from logObject's emitter and topic.
+    const std::string logBloom = "0x"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
+        "00000000000000000000000800000000000000000000000000000000000000000000000000000000000000000000001000000000000000000000001000000000"
+        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000008000000000000000000000000000000000000"
+        "00000002000000000000000000000000000000000000000000000000008000000000000000000000000000000000000000000000000000000000000000000000";
+
+    TEST_CASE("Log Blooms", "[logs]")
+    {
+        const std::string address = "0x2e913a79206280b3882860b3ef4df8204a62c8b1";
+        const std::string transfer = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+        const std::string approval = "0x8c5be1e5ebec7d5bd14f71427d1e84f3dd0314c0f7b2291e5b200ac8c7c3b925";
+
+        SECTION("Utils test addresses and topics")
+        {
+            REQUIRE(Utils::isBloom(logBloom));
+            REQUIRE(!Utils::isBloom("0x1234"));
+            REQUIRE(Utils::isContractAddressInBloom(logBloom, address));
+            REQUIRE(Utils::isContractAddressInBloom(logBloom, Utils::toChecksumAddress(address)));
+            REQUIRE(!Utils::isContractAddressInBloom(logBloom, "0x0000000000000000000000000000000000000001"));
+            REQUIRE(!Utils::isUserEthereumAddressInBloom(logBloom, address));
+            REQUIRE(Utils::isTopic(transfer));
+            REQUIRE(Utils::isTopicInBloom(logBloom, transfer));
+            REQUIRE(!Utils::isTopicInBloom(logBloom, approval));
+            REQUIRE(!Utils::isTopicInBloom(logBloom, "0x1234"));
+        }
+
+        SECTION("Subscriptions skip blocks that can't match")
+        {
+            std::unique_ptr<Provider> provider;
+            HeadTracker heads(provider);
+            dev::eth::LogBloom bloom(Utils::stripHexPrefix(logBloom));
+            auto matches = [&](json filter) {
+                return LogSubscription(provider, heads, filter, [](const Log&){}).mayMatch(bloom);
+            };
+            REQUIRE(matches(json::object()));
+            REQUIRE(matches({{"address", address}}));
+            REQUIRE(matches({{"address", json::array({"0x0000000000000000000000000000000000000001", address})}}));
+            REQUIRE(!matches({{"address", "0x0000000000000000000000000000000000000001"}}));
+            REQUIRE(matches({{"address", address}, {"topics", json::array({transfer})}}));
+            REQUIRE(matches({{"topics", json::array({json::array({approval, transfer})})}}));
+            REQUIRE(matches({{"topics", json::array({nullptr, nullptr})}}));
+            REQUIRE(!matches({{"topics", json::array({approval})}}));
+            REQUIRE(!matches({{"topics", json::array({transfer, approval})}}));
+        }
+
+        SECTION("Block hash filters have no range")
+        {
+            Error err;
+            json filter = {{"blockHash", "0x" + std::string(64, 'a')}};
+            json req = RPC::eth_getLogs(filter, err);
+            REQUIRE(err.getCode() == 0);
+            REQUIRE(!req["params"][0].contains("fromBlock"));
+            REQUIRE(!req["params"][0].contains("toBlock"));
+            Error hashErr;
+            filter["blockHash"] = "0x1234";
+            RPC::eth_getLogs(filter, hashErr);
+            REQUIRE(hashErr.getCode() != 0);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/Multicall.h"
+#include "MockNode.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TMulticall
+{
+    string word(const string& hex) { return string(64 - hex.size(), '0') + hex; }
+
+    TEST_CASE("Multicall3 Encoding")
+    {
+        SECTION("aggregate3 calldata")
+        {
+            string data = Multicall::encodeAggregate3({
+                {"0x0000000000000000000000000000000000000001", "0x12345678", true},
+                {"0x0000000000000000000000000000000000000002", "0x", false}
+            });
+            string expected = "0x82ad56cb" + word("20") + word("2")
+                + word("40") + word("e0")
+                + word("1") + word("1") + word("60") + word("4") + "12345678" + string(56, '0')
+                + word("2") + word("0") + word("60") + word("0");
+            REQUIRE_THAT(data, Equals(expected));
+        }
+
+        SECTION("aggregate3 return data")
+        {
+            string ret = "0x" + word("20") + word("2")
+                + word("40") + word("c0")
+                + word("1") + word("40") + word("2") + "abcd" + string(60, '0')
+                + word("0") + word("40") + word("0");
+            auto results = Multicall::decodeAggregate3(ret);
+            REQUIRE(results);
+            REQUIRE(results->size() == 2);
+            REQUIRE((*results)[0].first);
+            REQUIRE_THAT((*results)[0].second, Equals("0xabcd"));
+            REQUIRE(!(*results)[1].first);
+            REQUIRE_THAT((*results)[1].second, Equals("0x"));
+        }
+
+        SECTION("Malformed return data")
+        {
+            REQUIRE(!Multicall::decodeAggregate3("0x"));
+            REQUIRE(!Multicall::decodeAggregate3("0x" + word("20") + word("5")));
+            REQUIRE(!Multicall::decodeAggregate3("0xzz"));
+        }
+    }
+
+    TEST_CASE("Multicall3 Installation")
+    {
+        // Anvil node without Multicall3, that answers `aggregate3` once installed.
+        std::mutex lock;
+        std::string installedAt, installed = "0x";
+        MockNode node([&](const json& request) -> json {
+            std::scoped_lock l(lock);
+            const std::string method = request["method"];
+            if (method == "web3_clientVersion") return "anvil/v0.2.0";
+            if (method == "eth_getCode") return installed;
+            if (method == "anvil_setCode") {
+                installedAt = request["params"][0];
+                installed = request["params"][1];
+                return nullptr;
+            }
+            if (method == "eth_call" && request["params"][0]["to"] == Multicall::address) {
+                return "0x" + word("20") + word("1") + word("20")
+                    + word("1") + word("40") + word("2") + "abcd" + string(60, '0');
+            }
+            if (method == "eth_call") return "0xabcd";
+            return MockNode::error(-32601, "Method not found");
+        });
+        std::unique_ptr<Provider> provider = node.provider();
+
+        SECTION("Nothing is installed by default")
+        {
+            Multicall multicall(provider);
+            REQUIRE(multicall.getOptions().runtimeCode.empty());
+            std::future<json> call = multicall.add("0x0000000000000000000000000000000000000001", "0x12345678");
+            multicall.execute().get();
+            REQUIRE(call.get()["result"] == "0xabcd");  // Sent as a plain eth_call
+            std::scoped_lock l(lock);
+            REQUIRE(installedAt.empty());
+        }
+
+        SECTION("The given runtime code is installed on anvil")
+        {
+            Multicall::Options options;
+            options.runtimeCode = "0x6080604052";  // Stands in for the canonical bytecode
+            Multicall multicall(provider, options);
+            std::future<json> call = multicall.add("0x0000000000000000000000000000000000000001", "0x12345678");
+            multicall.execute().get();
+            REQUIRE(call.get()["result"] == "0xabcd");
+            std::scoped_lock l(lock);
+            REQUIRE(installedAt == Multicall::address);
+            REQUIRE(installed == options.runtimeCode);
+        }
+    }
+}
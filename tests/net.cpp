@@ -1,10 +1,22 @@
 #include "../src/libs/catch2/catch_amalgamated.hpp"
 #include "../include/web3cpp/Web3.h"
+#include "../include/web3cpp/BlockFetcher.h"
+#include "../include/web3cpp/MempoolWatcher.h"
+#include "../include/web3cpp/NonceManager.h"
+#include "../include/web3cpp/Replacer.h"
+#include "../include/web3cpp/TxPipeline.h"
+#include "MockNode.h"
 #include "Tests.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <memory>
+#include <thread>
 
 using namespace std;
 using Catch::Matchers::Equals;
@@ -43,4 +55,713 @@ namespace TNet
         }
     }
 
+    TEST_CASE("Batch HTTP Request")
+    {
+        SECTION("Responses match their requests")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            std::vector<json> reqs = {
+                RPC::eth_blockNumber(), RPC::net_version(), RPC::eth_gasPrice()
+            };
+            std::vector<json> resps = Net::HTTPBatchRequest(web3->getProvider(), reqs);
+
+            REQUIRE(resps.size() == 3);
+            for (std::size_t i = 0; i < resps.size(); i++) {
+                REQUIRE(!resps[i].count("error"));
+                REQUIRE(resps[i]["id"] == i);
+            }
+            REQUIRE(resps[1]["result"] == "43114"); // Avalanche C-Chain
+        }
+    }
+
+    TEST_CASE("Bulk State Reads")
+    {
+        SECTION("Values come back in order at one block")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            std::vector<std::string> addresses;
+            for (int i = 1; i <= 25; i++) {
+                std::string hex = Utils::toHex(BigNumber(i)).substr(2);
+                addresses.push_back("0x" + std::string(40 - hex.size(), '0') + hex);
+            }
+            Eth::BulkOptions options;
+            options.batchSize = 10;
+            Eth::BulkResult balances = web3->eth.getBalance(addresses, BlockTag::latest(), options).get();
+            REQUIRE(balances.values.size() == addresses.size());
+            REQUIRE(balances.failed == 0);
+            REQUIRE(balances.block.kind() == BlockTag::Kind::Number);
+            for (std::size_t i = 0; i < addresses.size(); i += 12) {
+                json single = web3->eth.getBalance(addresses[i], balances.block).get();
+                REQUIRE(Utils::toBN(single["result"].get<std::string>()) == balances.values[i]);
+            }
+            addresses.push_back("0x1234");
+            Eth::BulkResult counts = web3->eth.getTransactionCount(addresses, balances.block).get();
+            REQUIRE(counts.failed == 1);
+            REQUIRE(!counts.ok.back());
+        }
+    }
+
+    TEST_CASE("Block Fetcher")
+    {
+        SECTION("Blocks are delivered in order")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            BlockFetcher::Options options;
+            options.batchSize = 5;
+            options.parallelism = 3;
+            BlockFetcher fetcher(web3->getProvider(), 1000000, 1000039, options);
+            uint64_t expected = 1000000;
+            for (const BlockFetcher::Block& block : fetcher) {
+                REQUIRE(block.number == expected);
+                REQUIRE(block.block["number"] == Utils::toHex(BigNumber(expected)));
+                expected++;
+            }
+            REQUIRE(expected == 1000040);
+            REQUIRE(fetcher.response()["result"] == 40);
+        }
+
+        SECTION("Errors that aren't objects are still reported")
+        {
+            MockNode node([](const json& request) -> json {
+                uint64_t number = uint64_t(Utils::toBN(request["params"][0].get<std::string>()));
+                if (number == 20) return {{"error", "rate limited"}};
+                return {{"number", Utils::toHex(BigNumber(number))}};
+            });
+            std::unique_ptr<Provider> provider = node.provider();
+            BlockFetcher::Options options;
+            options.batchSize = 5;
+            options.parallelism = 2;
+            options.maxRetries = 0;
+            BlockFetcher fetcher(provider, 0, 39, options);
+            uint64_t expected = 0;
+            for (const BlockFetcher::Block& block : fetcher) {
+                REQUIRE(block.number == expected);
+                expected++;
+            }
+            REQUIRE(expected <= 20);  // Blocks after the failed batch are never delivered
+            json error = fetcher.response()["error"];
+            REQUIRE(error["message"] == "rate limited");
+            REQUIRE(error["fromBlock"] == "0x14");
+            REQUIRE(error["toBlock"] == "0x18");
+        }
+    }
+
+    TEST_CASE("Head Tracker")
+    {
+        SECTION("Follows the head with a consistent history")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            std::mutex lock;
+            std::vector<HeadTracker::Event> events;
+            uint64_t id = web3->heads.subscribe([&](const HeadTracker::Event& event) {
+                std::scoped_lock l(lock);
+                events.push_back(event);
+            });
+            for (int i = 0; i < 100 && !web3->heads.head(); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            REQUIRE(web3->heads.head());
+            REQUIRE(web3->heads.backend() != HeadTracker::Backend::None);
+            std::vector<HeadTracker::Header> history = web3->heads.history();
+            for (std::size_t i = 1; i < history.size(); i++) {
+                REQUIRE(history[i].number == history[i - 1].number + 1);
+                REQUIRE(history[i].parentHash == history[i - 1].hash);
+            }
+            REQUIRE(web3->heads.unsubscribe(id));
+            web3->heads.stop();
+            REQUIRE(!web3->heads.running());
+            std::scoped_lock l(lock);
+            REQUIRE(!events.empty());
+        }
+    }
+
+    TEST_CASE("Block Cache")
+    {
+        SECTION("Reads at latest are served once per head")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            web3->eth.blockCache = std::make_shared<BlockCache>(web3->heads);
+            REQUIRE(!web3->eth.blockCache->pin(BlockTag::pending()));
+            for (int i = 0; i < 100 && !web3->eth.blockCache->pin(BlockTag::latest()); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            std::optional<BlockCache::Pin> pin = web3->eth.blockCache->pin(BlockTag::latest());
+            REQUIRE(pin);
+            REQUIRE(pin->block.kind() == BlockTag::Kind::Number);
+            const std::string address = "0x0000000000000000000000000000000000000001";
+            json first = web3->eth.getBalance(address, BlockTag::latest()).get();
+            json second = web3->eth.getBalance(address, BlockTag::latest()).get();
+            REQUIRE(first["result"] == second["result"]);
+            // Unless a block came in between, the second read was a hit.
+            BlockCache::Stats stats = web3->eth.blockCache->stats();
+            REQUIRE(stats.hits + stats.clears >= 1);
+        }
+    }
+
+    TEST_CASE("Fee Oracle")
+    {
+        SECTION("Estimates come from the rolling window")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            REQUIRE(!web3->wallet.feeOracle);  // Opt-in
+            web3->wallet.feeOracle = std::make_shared<FeeOracle>(web3->getProvider(), web3->heads);
+            std::optional<FeeOracle::Fees> fees = web3->wallet.feeOracle->fees();
+            REQUIRE(fees);
+            REQUIRE(fees->priority(dev::eth::Low) <= fees->priority(dev::eth::Medium));
+            REQUIRE(fees->priority(dev::eth::Medium) <= fees->priority(dev::eth::High));
+            std::optional<FeeOracle::Fees> again = web3->wallet.feeOracle->fees();
+            REQUIRE(again);
+            REQUIRE(again->block >= fees->block);
+        }
+    }
+
+    TEST_CASE("Mempool Watcher")
+    {
+        SECTION("Lock-free queue keeps every item once")
+        {
+            MpmcQueue<int> queue(1000);
+            REQUIRE(queue.capacity() == 1024);
+            std::vector<std::thread> producers;
+            for (int p = 0; p < 4; p++) {
+                producers.emplace_back([&queue, p]{
+                    for (int i = 0; i < 256; i++) { while (!queue.tryPush(p * 256 + i)) std::this_thread::yield(); }
+                });
+            }
+            std::vector<int> seen(1024, 0);
+            int item;
+            for (int popped = 0; popped < 1024;) {
+                if (queue.tryPop(item)) { seen[item]++; popped++; }
+            }
+            for (std::thread& producer : producers) producer.join();
+            REQUIRE(!queue.tryPop(item));
+            REQUIRE(std::count(seen.begin(), seen.end(), 1) == 1024);
+        }
+
+        SECTION("Follows pending transactions and stops")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            MempoolWatcher::Options options;
+            options.pollInterval = std::chrono::milliseconds(10);
+            MempoolWatcher watcher(web3->getProvider(), options);
+            watcher.start();
+            for (int i = 0; i < 100 && watcher.backend() == MempoolWatcher::Backend::None; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            REQUIRE(watcher.backend() != MempoolWatcher::Backend::None);
+            watcher.stop();
+            REQUIRE(!watcher.running());
+            MempoolWatcher::Pending pending;
+            while (watcher.tryPop(pending)) REQUIRE(!pending.hash.empty());
+        }
+    }
+
+    TEST_CASE("Nonce Manager")
+    {
+        SECTION("Nonce errors are recognized")
+        {
+            REQUIRE(NonceManager::isNonceError({{"code", -32000}, {"message", "nonce too low"}}));
+            REQUIRE(NonceManager::isNonceError({{"code", -32003}, {"message", "Nonce too high. Expected nonce to be 3 but got 5."}}));
+            REQUIRE(NonceManager::isNonceError({{"code", -32010}, {"message", "Transaction nonce is too low. Try incrementing the nonce."}}));
+            REQUIRE(!NonceManager::isNonceError({{"code", -32000}, {"message", "replacement transaction underpriced"}}));
+            REQUIRE(!NonceManager::isNonceError(json::object()));
+        }
+
+        SECTION("Only some rejections leave the nonce unused")
+        {
+            REQUIRE(NonceManager::isNonceUnused({{"code", -32000}, {"message", "insufficient funds for gas * price + value"}}));
+            REQUIRE(NonceManager::isNonceUnused({{"code", -32000}, {"message", "intrinsic gas too low"}}));
+            REQUIRE(NonceManager::isNonceUnused({{"code", -32000}, {"message", "transaction underpriced"}}));
+            REQUIRE(!NonceManager::isNonceUnused({{"code", -32000}, {"message", "replacement transaction underpriced"}}));
+            REQUIRE(!NonceManager::isNonceUnused({{"code", -32000}, {"message", "already known"}}));
+            REQUIRE(!NonceManager::isNonceUnused({{"code", -32000}, {"message", "nonce too low"}}));
+            REQUIRE(!NonceManager::isNonceUnused({{"code", -32000}, {"message", "something unexpected"}}));
+            REQUIRE(!NonceManager::isNonceUnused(json::object()));
+        }
+
+        SECTION("Reservations are unique and released nonces are reused")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            NonceManager nonces(web3->getProvider());
+            const std::string address = "0x0000000000000000000000000000000000000001";
+            REQUIRE(!nonces.peek(address));
+            Error err;
+            std::optional<uint64_t> first = nonces.reserve(address, err);
+            REQUIRE(first);
+            std::mutex lock;
+            std::vector<uint64_t> reserved;
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 8; t++) {
+                threads.emplace_back([&]{
+                    for (int i = 0; i < 50; i++) {
+                        Error threadErr;
+                        std::optional<uint64_t> nonce = nonces.reserve(address, threadErr);
+                        std::scoped_lock l(lock);
+                        if (nonce) reserved.push_back(*nonce);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            std::sort(reserved.begin(), reserved.end());
+            REQUIRE(reserved.size() == 400);
+            for (std::size_t i = 0; i < reserved.size(); i++) REQUIRE(reserved[i] == *first + 1 + i);
+
+            uint64_t last = reserved.back();
+            nonces.release(address, last);  // Taken back
+            nonces.release(address, *first + 10);  // Becomes a gap
+            REQUIRE(nonces.gaps(address) == std::vector<uint64_t>{*first + 10});
+            REQUIRE(nonces.reserve(address, err) == *first + 10);
+            REQUIRE(nonces.reserve(address, err) == last);
+            REQUIRE(nonces.gaps(address).empty());
+
+            REQUIRE(nonces.handleError(address, {{"code", -32000}, {"message", "nonce too low"}}));
+            REQUIRE(!nonces.peek(address));
+            nonces.set(address, 7);
+            REQUIRE(nonces.peek(address) == uint64_t(7));
+        }
+    }
+
+    TEST_CASE("Transaction Pipeline Estimates")
+    {
+        // Anvil's first default account.
+        const std::string from = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
+        const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+        std::mutex lock;
+        std::size_t estimates = 0;
+        MockNode node([&](const json& request) -> json {
+            std::scoped_lock l(lock);
+            const std::string method = request["method"];
+            if (method == "eth_getTransactionCount") return "0x0";
+            if (method == "eth_estimateGas") { estimates++; return "0x5208"; }
+            if (method == "eth_feeHistory") {
+                return {
+                    {"oldestBlock", "0x1"}, {"baseFeePerGas", json::array({"0x3b9aca00", "0x3b9aca00"})},
+                    {"gasUsedRatio", json::array({0.5})}, {"reward", json::array({json::array({"0x1", "0x2", "0x3"})})}
+                };
+            }
+            if (method == "eth_sendRawTransaction") {
+                return "0x" + dev::sha3(dev::fromHex(request["params"][0].get<std::string>())).hex();
+            }
+            return MockNode::error(-32601, "Method not found");
+        });
+        std::unique_ptr<Provider> provider = node.provider();
+        Wallet wallet(provider);
+        TxPipeline::Options options;
+        options.batchSize = 16;
+        options.estimateWorkers = 1;
+
+        auto run = [&](TxPipeline& pipeline) {
+            std::vector<TxPipeline::Ticket> tickets;
+            for (int i = 0; i < 16; i++) {
+                TxPipeline::Request request;
+                request.from = from;
+                request.privateKey = key;
+                request.to = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
+                request.value = i + 1;
+                tickets.push_back(pipeline.submit(request));
+            }
+            for (TxPipeline::Ticket& ticket : tickets) REQUIRE(ticket.estimated.get().count("gas"));
+            pipeline.close();
+        };
+
+        SECTION("Without a gas cache every transaction is estimated")
+        {
+            TxPipeline pipeline(wallet, options);
+            run(pipeline);
+            REQUIRE(pipeline.stats().estimateRequests == 16);
+            std::scoped_lock l(lock);
+            REQUIRE(estimates == 16);
+        }
+
+        SECTION("The wallet's gas cache reuses estimates of the same shape")
+        {
+            wallet.gasCache = std::make_shared<GasCache>();
+            TxPipeline pipeline(wallet, options);
+            run(pipeline);
+            REQUIRE(pipeline.stats().estimateRequests < 16);
+            std::scoped_lock l(lock);
+            REQUIRE(estimates < 16);
+        }
+    }
+
+    // Sends real transactions, so it is hidden and only runs against a local
+    // anvil node when asked for, e.g. `web3cpp-tests "[anvil]"`.
+    TEST_CASE("Transaction Pipeline", "[.][anvil]")
+    {
+        SECTION("Every transaction goes through every stage")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>(Provider("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", ""));
+            // Anvil's first default account.
+            const std::string from = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
+            const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+            // Plain transfers all cost the same, so estimates can be reused.
+            web3->wallet.gasCache = std::make_shared<GasCache>();
+            TxPipeline::Options options;
+            options.signWorkers = 4;
+            options.batchSize = 32;
+            TxPipeline pipeline(web3->wallet, options);
+            std::vector<TxPipeline::Ticket> tickets;
+            for (int i = 0; i < 200; i++) {
+                TxPipeline::Request request;
+                request.from = from;
+                request.privateKey = key;
+                request.to = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
+                request.value = i + 1;
+                tickets.push_back(pipeline.submit(request));
+            }
+            std::vector<uint64_t> nonces;
+            for (TxPipeline::Ticket& ticket : tickets) {
+                json estimated = ticket.estimated.get();
+                REQUIRE(estimated.count("nonce"));
+                nonces.push_back(uint64_t(Utils::toBN(estimated["nonce"].get<std::string>())));
+                REQUIRE(ticket.signedTx.get().count("hash"));
+                json submitted = ticket.submitted.get();
+                REQUIRE(submitted.count("result"));
+                REQUIRE(submitted["signature"] == ticket.signedTx.get()["signature"]);
+            }
+            std::sort(nonces.begin(), nonces.end());
+            for (std::size_t i = 1; i < nonces.size(); i++) REQUIRE(nonces[i] == nonces[0] + i);
+
+            pipeline.close();
+            TxPipeline::Stats stats = pipeline.stats();
+            REQUIRE(stats.sent == 200);
+            REQUIRE(stats.failed == 0);
+            REQUIRE(stats.estimateRequests < 200);  // Same shape, estimates are reused
+            REQUIRE(stats.batches < 200);
+
+            TxPipeline::Ticket closed = pipeline.submit(TxPipeline::Request());
+            REQUIRE(closed.submitted.get()["error"]["code"] == 42);
+        }
+    }
+
+    // Chain that only moves when told to, with transactions mined at given
+    // heights. Sent transactions are mined in the next block, once the
+    // given number of rejections is used up. After reorg(), blocks from the
+    // fork on get other hashes.
+    struct MockChain {
+        std::mutex lock;
+        uint64_t head = 100;
+        uint64_t forkedFrom = UINT64_MAX;
+        uint64_t nonce = 0;
+        unsigned int rejections = 0;
+        std::map<std::string, uint64_t> mined;
+
+        std::string hashOf(uint64_t number) const {
+            BigNumber hash = (number >= forkedFrom) ? (BigNumber(1) << 128) + number : BigNumber(number);
+            return "0x" + Utils::padLeft(Utils::toHex(hash, false), 64);
+        }
+
+        json block(uint64_t number) const {
+            return {
+                {"number", Utils::toHex(BigNumber(number))}, {"hash", hashOf(number)},
+                {"parentHash", hashOf(number - 1)}, {"baseFeePerGas", "0x3b9aca00"}
+            };
+        }
+
+        json operator()(const json& request) {
+            std::scoped_lock l(lock);
+            const std::string method = request["method"];
+            const json& params = request["params"];
+            if (method == "eth_getBlockByNumber") {
+                uint64_t number = (params[0] == "latest") ? head : uint64_t(Utils::toBN(params[0].get<std::string>()));
+                return (number <= head) ? block(number) : json();
+            } else if (method == "eth_getBlockByHash") {
+                const std::string hash = params[0];
+                uint64_t number = uint64_t(Utils::toBN(hash) & BigNumber(UINT64_MAX));
+                return (number <= head && hashOf(number) == hash) ? block(number) : json();
+            } else if (method == "eth_getTransactionReceipt") {
+                auto it = mined.find(params[0].get<std::string>());
+                if (it == mined.end() || it->second > head) return json();
+                return {
+                    {"transactionHash", it->first}, {"blockNumber", Utils::toHex(BigNumber(it->second))},
+                    {"blockHash", hashOf(it->second)}, {"status", "0x1"}
+                };
+            } else if (method == "eth_getTransactionCount") {
+                return Utils::toHex(BigNumber(nonce));
+            } else if (method == "eth_sendRawTransaction") {
+                if (rejections > 0) {
+                    rejections--;
+                    return MockNode::error(-32000, "replacement transaction underpriced");
+                }
+                std::string hash = "0x" + dev::sha3(dev::fromHex(params[0].get<std::string>())).hex();
+                mined[hash] = head + 1;
+                return hash;
+            }
+            return MockNode::error(-32601, "Method not found");  // No filters, so the tracker polls
+        }
+
+        void setHead(uint64_t number) { std::scoped_lock l(lock); head = number; }
+
+        // Replace the blocks from `from` on with a branch that ends at `number`.
+        void reorg(uint64_t from, uint64_t number) { std::scoped_lock l(lock); forkedFrom = from; head = number; }
+    };
+
+    // Tracker that polls a MockChain.
+    HeadTracker::Options pollingTracker() {
+        HeadTracker::Options options;
+        options.subscribe = false;
+        options.pollInterval = std::chrono::milliseconds(10);
+        return options;
+    }
+
+    bool isReady(std::future<json>& future, std::chrono::milliseconds wait) {
+        return future.wait_for(wait) == std::future_status::ready;
+    }
+
+    // Wait up to 5 seconds for a condition on the chain, checked under its lock.
+    bool waitFor(MockChain& chain, const std::function<bool()>& done) {
+        for (int i = 0; i < 500; i++) {
+            {
+                std::scoped_lock l(chain.lock);
+                if (done()) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    TEST_CASE("Receipt Waiter")
+    {
+        SECTION("Options come from the contract options")
+        {
+            Contract::Options contractOptions;
+            contractOptions.transactionBlockTimeout = 50;
+            contractOptions.transactionConfirmationBlocks = 24;
+            contractOptions.transactionPollingTimeout = 750;
+            ReceiptWaiter::Options options = ReceiptWaiter::Options::fromContract(contractOptions);
+            REQUIRE(options.confirmations == 24);
+            REQUIRE(options.timeout == std::chrono::seconds(750));
+            REQUIRE(options.blockTimeout == 50);
+        }
+
+        SECTION("Invalid hashes fail right away")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            json ret = web3->receipts.wait("0x1234").get();
+            REQUIRE(ret.count("error"));
+            REQUIRE(ret["error"]["transactionHash"] == "0x1234");
+            REQUIRE(web3->receipts.pending() == 0);
+        }
+
+        const std::string txHash = "0x88df016429689c079f3b2f6ad39fa052532c56795b733da78a91ebe6a713944b";
+
+        SECTION("Receipts resolve on a new head")
+        {
+            MockChain chain;
+            chain.mined[txHash] = 101;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            ReceiptWaiter waiter(provider, heads);
+            std::future<json> receipt = waiter.wait(txHash);
+            REQUIRE(!isReady(receipt, std::chrono::milliseconds(200)));
+            REQUIRE(waiter.pending() == 1);
+            chain.setHead(101);
+            REQUIRE(isReady(receipt, std::chrono::seconds(5)));
+            json ret = receipt.get();
+            REQUIRE(ret["result"]["transactionHash"] == txHash);
+            REQUIRE(ret["result"]["blockNumber"] == "0x65");
+            REQUIRE(waiter.pending() == 0);
+        }
+
+        SECTION("Receipts wait for their confirmations")
+        {
+            MockChain chain;
+            chain.mined[txHash] = 100;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            ReceiptWaiter waiter(provider, heads);
+            std::future<json> receipt = waiter.wait(txHash, 3);
+            REQUIRE(!isReady(receipt, std::chrono::milliseconds(200)));
+            chain.setHead(101);
+            REQUIRE(!isReady(receipt, std::chrono::milliseconds(200)));
+            chain.setHead(102);
+            REQUIRE(isReady(receipt, std::chrono::seconds(5)));
+            REQUIRE(receipt.get()["result"]["blockNumber"] == "0x64");
+        }
+
+        SECTION("Transactions time out")
+        {
+            MockChain chain;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            ReceiptWaiter::Options options;
+            options.timeout = std::chrono::seconds(1);
+            options.blockTimeout = 2;
+            ReceiptWaiter waiter(provider, heads, options);
+
+            std::future<json> timedOut = waiter.wait(txHash);
+            REQUIRE(isReady(timedOut, std::chrono::seconds(5)));
+            json ret = timedOut.get();
+            REQUIRE(ret["error"]["message"] == "Timed out waiting for the transaction receipt");
+            REQUIRE(ret["error"]["transactionHash"] == txHash);
+
+            std::future<json> notIncluded = waiter.wait(txHash);
+            REQUIRE(!isReady(notIncluded, std::chrono::milliseconds(200)));
+            chain.setHead(102);
+            REQUIRE(isReady(notIncluded, std::chrono::milliseconds(900)));
+            REQUIRE(notIncluded.get()["error"]["message"] == "Transaction was not included in 2 blocks");
+        }
+
+        SECTION("Stopping resolves what is still pending")
+        {
+            MockChain chain;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            std::future<json> receipt;
+            {
+                ReceiptWaiter waiter(provider, heads);
+                receipt = waiter.wait(txHash);
+                REQUIRE(!isReady(receipt, std::chrono::milliseconds(100)));
+            }
+            REQUIRE(isReady(receipt, std::chrono::seconds(0)));
+            json ret = receipt.get();
+            REQUIRE(ret["error"]["message"] == "Receipt waiter was stopped");
+            REQUIRE(ret["error"]["transactionHash"] == txHash);
+        }
+    }
+
+    TEST_CASE("Replacer")
+    {
+        // Anvil's first default account.
+        const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+        std::shared_ptr<const Signer> signer = std::make_shared<const Signer>(*Signer::fromPrivateKey(key));
+
+        SECTION("Fees are bumped by at least 10%")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            Error err;
+            dev::eth::TransactionBase tx(web3->wallet.buildTransaction(signer->addressHex(), 0, err, signer->addressHex(), "", 1));
+            tx.setGas(21000);
+            tx.setFees(dev::u256(10000000000), dev::u256(1000000000));
+            REQUIRE(signer->signTransaction(tx, err) != "");
+            const dev::h256 hash = tx.sha3();
+
+            Replacer::Options options;
+            options.bumpPercent = 5;  // Raised to the minimum
+            options.maxFeePerGas = 30000000000;
+            Replacer replacer(web3->getProvider(), web3->heads, options);
+            REQUIRE(replacer.getOptions().bumpPercent == 10);
+            REQUIRE(replacer.bumpFees(tx, 0));
+            REQUIRE(tx.maxPriorityFeePerGas() == 1100000000);
+            REQUIRE(tx.maxFeePerGas() == 23100000000);
+            REQUIRE(tx.hasZeroSignature());
+            REQUIRE(signer->signTransaction(tx, err) != "");
+            REQUIRE(tx.sha3() != hash);
+
+            // A base fee spike raises the max fee further, up to the cap.
+            REQUIRE(replacer.bumpFees(tx, 13000000000));
+            REQUIRE(tx.maxFeePerGas() == 27210000000);
+            REQUIRE(replacer.bumpFees(tx, 20000000000));
+            REQUIRE(tx.maxFeePerGas() == 30000000000);
+            REQUIRE(!replacer.bumpFees(tx, 20000000000));  // 10% more is above the cap
+            REQUIRE(tx.maxFeePerGas() == 30000000000);
+        }
+
+        SECTION("Only replacements the node accepts count")
+        {
+            MockChain chain;
+            chain.rejections = 1;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            Replacer::Options options;
+            options.stuckBlocks = 1;
+            options.maxBumps = 1;
+            Replacer replacer(provider, heads, options);
+
+            Wallet wallet(provider);
+            Error err;
+            dev::eth::TransactionBase tx(wallet.buildTransaction(signer->addressHex(), 0, err, signer->addressHex(), "", 1));
+            tx.setGas(21000);
+            tx.setFees(dev::u256(10000000000), dev::u256(1000000000));
+            REQUIRE(signer->signTransaction(tx, err) != "");
+            std::future<json> tracked = replacer.track(tx, signer);  // Never mined
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+            chain.setHead(101);  // Stuck, the replacement is rejected
+            REQUIRE(waitFor(chain, [&]{ return chain.rejections == 0; }));
+            chain.setHead(102);  // Stuck again, and still one replacement left
+            REQUIRE(waitFor(chain, [&]{ return !chain.mined.empty(); }));
+            chain.setHead(103);
+            REQUIRE(isReady(tracked, std::chrono::seconds(5)));
+            json ret = tracked.get();
+            REQUIRE(ret.count("result"));
+            REQUIRE(ret["replacements"] == 1);
+            REQUIRE(ret["transactionHash"] != "0x" + tx.sha3().hex());
+            REQUIRE(replacer.stats().replacements == 1);
+            REQUIRE(replacer.stats().replaced == 1);
+        }
+
+        SECTION("A head that moves back doesn't count as blocks passed")
+        {
+            MockChain chain;
+            MockNode node([&](const json& request){ return chain(request); });
+            std::unique_ptr<Provider> provider = node.provider();
+            HeadTracker heads(provider, pollingTracker());
+            Replacer::Options options;
+            options.stuckBlocks = 2;
+            options.blockTimeout = 5;
+            Replacer replacer(provider, heads, options);
+
+            Wallet wallet(provider);
+            Error err;
+            dev::eth::TransactionBase tx(wallet.buildTransaction(signer->addressHex(), 0, err, signer->addressHex(), "", 1));
+            tx.setGas(21000);
+            tx.setFees(dev::u256(10000000000), dev::u256(1000000000));
+            REQUIRE(signer->signTransaction(tx, err) != "");
+            std::future<json> tracked = replacer.track(tx, signer);  // Never mined
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+            chain.reorg(96, 98);  // Shorter chain, the head drops from 100 to 98
+            for (int i = 0; i < 500 && (!heads.head() || heads.head()->number != 98); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            REQUIRE(heads.head()->number == 98);
+            REQUIRE(!isReady(tracked, std::chrono::milliseconds(300)));  // No timeout
+            {
+                std::scoped_lock l(chain.lock);
+                REQUIRE(chain.mined.empty());  // No replacement
+            }
+
+            chain.setHead(102);  // Stuck for two blocks since it was sent
+            REQUIRE(waitFor(chain, [&]{ return !chain.mined.empty(); }));
+            chain.setHead(103);
+            REQUIRE(isReady(tracked, std::chrono::seconds(5)));
+            json ret = tracked.get();
+            REQUIRE(ret.count("result"));
+            REQUIRE(ret["replacements"] == 1);
+        }
+    }
+
+    // Sends a real transaction, so it is hidden and only runs against a
+    // local anvil node when asked for, e.g. `web3cpp-tests "[anvil]"`.
+    TEST_CASE("Replacer on anvil", "[.][anvil]")
+    {
+        // Anvil's first default account.
+        const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+        std::shared_ptr<const Signer> signer = std::make_shared<const Signer>(*Signer::fromPrivateKey(key));
+
+        SECTION("Mined transactions are resolved with their receipt")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>(Provider("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", ""));
+            Error err;
+            dev::eth::TransactionBase tx(web3->wallet.buildTransaction(signer->addressHex(), err, signer->addressHex(), "", 1));
+            REQUIRE(err.getCode() == 0);
+            tx.setGas(21000);
+            tx.setFees(dev::u256(10000000000), dev::u256(1000000000));
+            std::string signedTx = signer->signTransaction(tx, err);
+            Replacer replacer(web3->getProvider(), web3->heads);
+            std::future<json> tracked = replacer.track(tx, signer);
+            REQUIRE(web3->wallet.sendTransaction(signedTx, err).get().count("result"));
+            json ret = tracked.get();
+            REQUIRE(ret.count("result"));
+            REQUIRE(ret["transactionHash"] == "0x" + tx.sha3().hex());
+            REQUIRE(ret["replacements"] == 0);
+            REQUIRE(replacer.stats().mined == 1);
+        }
+    }
+
 }
\ No newline at end of file
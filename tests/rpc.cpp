@@ -0,0 +1,140 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/RPC.h"
+#include "../include/web3cpp/RPCMethods.h"
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TRPC
+{
+    static_assert(RPC::methodInfo(RPC::Method::eth_getBalance).name == "eth_getBalance");
+    static_assert(RPC::methodInfo(RPC::Method::eth_getBalance).readOnly);
+    static_assert(!RPC::methodInfo(RPC::Method::eth_sendTransaction).idempotent);
+    static_assert(RPC::findMethod("txpool_status")->id == RPC::Method::geth_txPoolStatus);
+    static_assert(RPC::findMethod("eth_doesNotExist") == nullptr);
+
+    TEST_CASE("RPC Method Descriptors", "[rpc]")
+    {
+        SECTION("Descriptor table matches the method enum")
+        {
+            for (std::size_t i = 0; i < RPC::methodTable.size(); i++) {
+                REQUIRE(static_cast<std::size_t>(RPC::methodTable[i].id) == i);
+            }
+        }
+
+        SECTION("Find descriptor from a built request")
+        {
+            const RPC::MethodInfo* info = RPC::findRequestMethod(RPC::eth_blockNumber());
+            REQUIRE(info != nullptr);
+            REQUIRE(info->id == RPC::Method::eth_blockNumber);
+            REQUIRE(RPC::findRequestMethod(json::object()) == nullptr);
+        }
+
+        SECTION("Serialize typed parameters")
+        {
+            dev::Address add("0x2e913a79206280b3882860b3ef4df8204a62c8b1");
+            std::string req = RPC::serialize<RPC::Method::eth_getBalance>(7, add, BlockTag::latest());
+            REQUIRE_THAT(req, Equals(
+                R"({"jsonrpc":"2.0","method":"eth_getBalance","params":["0x2e913a79206280b3882860b3ef4df8204a62c8b1","latest"],"id":7})"
+            ));
+            Error err;
+            REQUIRE(json::parse(req)["params"] == RPC::eth_getBalance(
+                "0x2e913a79206280b3882860b3ef4df8204a62c8b1", "latest", err
+            )["params"]);
+
+            std::string noParams = RPC::serialize<RPC::Method::eth_blockNumber>(1);
+            REQUIRE_THAT(noParams, Equals(R"({"jsonrpc":"2.0","method":"eth_blockNumber","params":[],"id":1})"));
+
+            std::string quantities = RPC::serialize<RPC::Method::eth_getStorageAt>(
+                1, add, BigNumber(0), BlockTag::number(0x1b4)
+            );
+            REQUIRE(json::parse(quantities)["params"][1] == "0x0");
+            REQUIRE(json::parse(quantities)["params"][2] == "0x1b4");
+        }
+
+        SECTION("Decode typed results")
+        {
+            Error e1, e2, e3;
+            BigNumber balance = RPC::decode<RPC::Method::eth_getBalance>(
+                json::parse(R"({"jsonrpc":"2.0","id":1,"result":"0x0234c8a3397aab58"})"), e1
+            );
+            REQUIRE(e1.getCode() == 0);
+            REQUIRE(balance == BigNumber("158972490234375000"));
+
+            uint64_t blockNumber = RPC::decode<RPC::Method::eth_blockNumber>(
+                json::parse(R"({"jsonrpc":"2.0","id":1,"result":"0x4b7"})"), e2
+            );
+            REQUIRE(e2.getCode() == 0);
+            REQUIRE(blockNumber == 1207);
+
+            RPC::decode<RPC::Method::eth_blockNumber>(
+                json::parse(R"({"jsonrpc":"2.0","id":1,"error":{"code":-32000,"message":"x"}})"), e3
+            );
+            REQUIRE(e3.getCode() == 39);
+        }
+    }
+
+    TEST_CASE("Block Tags", "[rpc]")
+    {
+        SECTION("Parse block tags")
+        {
+            REQUIRE(BlockTag::parse("latest") == BlockTag::latest());
+            REQUIRE(BlockTag::parse("finalized") == BlockTag::finalized());
+            REQUIRE(BlockTag::parse("0x1b4") == BlockTag::number(436));
+            REQUIRE(BlockTag::parse("436") == BlockTag::number(436));
+            REQUIRE(BlockTag::parse(
+                "0x88df016429689c079f3b2f6ad39fa052532c56795b733da78a91ebe6a713944b"
+            )->kind() == BlockTag::Hash);
+            REQUIRE(!BlockTag::parse("newest"));
+            REQUIRE(!BlockTag::parse("0xzz"));
+            REQUIRE(!BlockTag::parse("0x10000000000000000"));
+        }
+
+        SECTION("Format block tags")
+        {
+            REQUIRE(BlockTag::number(0).toString() == "0x0");
+            REQUIRE(BlockTag::number(436).toJSON() == "0x1b4");
+            dev::h256 hash("0x88df016429689c079f3b2f6ad39fa052532c56795b733da78a91ebe6a713944b");
+            REQUIRE(BlockTag::hash(hash).toJSON()["blockHash"] == "0x" + hash.hex());
+            REQUIRE(Quantity(BigNumber("1000000000000000000")).hex() == "0xde0b6b3a7640000");
+            REQUIRE(Quantity::fromHex("0xde0b6b3a7640000")->value() == BigNumber("1000000000000000000"));
+        }
+
+        SECTION("Build requests with block tags")
+        {
+            Error e1, e2, e3;
+            json balance = RPC::eth_getBalance(
+                "0x2e913a79206280b3882860b3ef4df8204a62c8b1", BlockTag::safe(), e1
+            );
+            REQUIRE(e1.getCode() == 0);
+            REQUIRE(balance["params"][1] == "safe");
+
+            json genesis = RPC::eth_getBlockByNumber(BigNumber(0), false, e2);
+            REQUIRE(e2.getCode() == 0);
+            REQUIRE(genesis["params"][0] == "0x0");
+
+            dev::h256 hash("0x88df016429689c079f3b2f6ad39fa052532c56795b733da78a91ebe6a713944b");
+            json byHash = RPC::eth_getBlockByNumber(BlockTag::hash(hash), false);
+            REQUIRE(byHash["method"] == "eth_getBlockByHash");
+
+            RPC::eth_getBalance("0xnotanaddress", BlockTag::latest(), e3);
+            REQUIRE(e3.getCode() == 5);
+        }
+
+        SECTION("Reject quantities that aren't numbers")
+        {
+            Error e1, e2, e3, e4;
+            REQUIRE(RPC::eth_getStorageAt(
+                "0x2e913a79206280b3882860b3ef4df8204a62c8b1", "0x", BigNumber(1), e1
+            ).empty());
+            REQUIRE(e1.getCode() == 4);
+            RPC::eth_getTransactionByBlockNumberAndIndex(BigNumber(1), "", e2);
+            REQUIRE(e2.getCode() == 4);
+            RPC::eth_getUncleByBlockNumberAndIndex(BigNumber(1), "0x" + std::string(65, '1'), e3);
+            REQUIRE(e3.getCode() == 4);
+            json uncle = RPC::eth_getUncleByBlockNumberAndIndex(BigNumber(1), "0x1", e4);
+            REQUIRE(e4.getCode() == 0);
+            REQUIRE(uncle["params"][1] == "0x1");
+        }
+    }
+}
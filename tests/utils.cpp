@@ -51,3 +51,23 @@ using Catch::Matchers::Equals;
             REQUIRE(weiConversion);
         }
     }
+
+    TEST_CASE("Parallel For")
+    {
+        SECTION("Every item is processed once, in contiguous shares")
+        {
+            for (std::size_t count : {0, 1, 3, 4, 5, 1000, 1001}) {
+                for (unsigned int threads : {0u, 1u, 2u, 4u, 7u}) {
+                    std::vector<unsigned int> owner(count, 99);
+                    std::vector<std::pair<std::size_t, std::size_t>> shares(std::max(threads, 64u), {0, 0});
+                    Utils::parallelFor(count, threads, [&](unsigned int t, std::size_t begin, std::size_t end) {
+                        shares[t] = {begin, end};
+                        for (std::size_t i = begin; i < end; i++) owner[i] = t;
+                    });
+                    for (std::size_t i = 0; i < count; i++) REQUIRE(owner[i] != 99);
+                    for (std::size_t i = 1; i < count; i++) REQUIRE(owner[i] >= owner[i - 1]);
+                    if (threads != 0 && count > 0) REQUIRE(owner.back() < std::min<std::size_t>(threads, count));
+                }
+            }
+        }
+    }
@@ -194,4 +194,211 @@ namespace TWallet
             }
         }
     }
-}
\ No newline at end of file
+
+    TEST_CASE("Account Loading", "[wallet]")
+    {
+        // Anvil's first two default accounts.
+        const std::vector<Wallet::AccountEntry> anvil = {
+            {"0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266", "first", "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80"},
+            {"0x70997970C51812dc3A010C7d01b50e0d17dc79C8", "second", "59c6995e998f97a5a0044966f0945389dc9e86dae88c7a8412f4603b6b78690d"}
+        };
+
+        SECTION("Accounts make no requests until the nonce is asked for")
+        {
+            // Nothing listens there, so a request would fail.
+            std::unique_ptr<Provider> provider = std::make_unique<Provider>("none", "127.0.0.1", "/", 1, 31337, "ETH", "");
+            Account lazy(anvil[0].address, anvil[0].name, anvil[0].privateKey, provider);
+            REQUIRE(!lazy.knownNonce());
+            Account fresh(anvil[0].address, anvil[0].name, anvil[0].privateKey, provider, 0);
+            REQUIRE(fresh.knownNonce() == uint64_t(0));
+            REQUIRE(fresh.nonce() == 0);
+            lazy.setNonce(5);
+            REQUIRE(lazy.nonce() == 5);
+            REQUIRE(Account(lazy).knownNonce() == uint64_t(5));
+        }
+
+        SECTION("Nonces and balances are loaded in bulk")
+        {
+            std::unique_ptr<Web3>web3 = std::make_unique<Web3>();
+            std::vector<Wallet::AccountEntry> entries = anvil;
+            entries.push_back({anvil[0].address, "mismatch", anvil[1].privateKey});
+            Error err;
+            Wallet::LoadedAccounts loaded = web3->wallet.loadAccounts(entries, err, true);
+            REQUIRE(err.getCode() == 0);
+            REQUIRE(loaded.accounts.size() == 2);
+            REQUIRE(loaded.invalid == std::vector<std::size_t>{2});
+            REQUIRE(loaded.balances.size() == 2);
+            for (const Account& acc : loaded.accounts) REQUIRE(acc.knownNonce());
+        }
+    }
+
+    // Uses anvil_* methods, so it is hidden and only runs against a local
+    // anvil node when asked for, e.g. `web3cpp-tests "[anvil]"`.
+    TEST_CASE("Bulk Funding", "[.][anvil]")
+    {
+        std::unique_ptr<Web3>web3 = std::make_unique<Web3>(Provider("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", ""));
+        std::vector<std::pair<std::string, BigNumber>> amounts;
+        for (int i = 1; i <= 1000; i++) {
+          std::string address = "0x" + std::string(40, '0');
+          std::string index = std::to_string(i);
+          address.replace(address.size() - index.size(), index.size(), index);
+          amounts.emplace_back("0xfeed" + address.substr(6), BigNumber(i) * 1000000000);
+        }
+        amounts.emplace_back("0xnotanaddress", 1);
+
+        Wallet::FundResult set = web3->wallet.setBalances(amounts, false, {100, 4}).get();
+        REQUIRE(set.ok.size() == amounts.size());
+        REQUIRE(set.failed == 1);
+        REQUIRE(!set.ok.back());
+        REQUIRE(set.balances.empty());
+
+        Wallet::FundResult added = web3->wallet.addBalances(amounts, true, {100, 4}).get();
+        REQUIRE(added.failed == 1);
+        REQUIRE(added.balances.size() == amounts.size());
+        for (std::size_t i = 0; i + 1 < amounts.size(); i++) {
+          REQUIRE(added.balances[i] == amounts[i].second * 2);
+        }
+    }
+
+    TEST_CASE("Signer", "[wallet]")
+    {
+        SECTION("Keys are parsed and checked once")
+        {
+            // Anvil's first default account.
+            std::optional<Signer> signer = Signer::fromPrivateKey("0xac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80");
+            REQUIRE(signer);
+            REQUIRE(signer->addressHex() == "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266");
+            REQUIRE(signer->isAddress("0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266"));
+            REQUIRE(!signer->isAddress("0x70997970C51812dc3A010C7d01b50e0d17dc79C8"));
+            REQUIRE(!Signer::fromPrivateKey("0x1234"));
+            REQUIRE(!Signer::fromPrivateKey(std::string(64, '0')));  // Zero
+            REQUIRE(!Signer::fromPrivateKey(std::string(64, 'f')));  // Above the curve order
+        }
+
+        SECTION("Signing matches the private key overloads")
+        {
+            const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+            std::unique_ptr<Provider> provider = std::make_unique<Provider>("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", "");
+            Wallet wallet(provider);
+            std::optional<Signer> signer = Signer::fromPrivateKey(key);
+            REQUIRE(signer);
+            REQUIRE(wallet.sign("Hello", *signer) == wallet.sign("Hello", key));
+            REQUIRE(wallet.ecRecover("Hello", wallet.sign("Hello", *signer)) == "0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266");
+
+            Error buildErr;
+            dev::eth::TransactionBase tx(wallet.buildTransaction(signer->addressHex(), 0, buildErr, signer->addressHex(), "", 1));
+            tx.setGas(21000);
+            tx.setFees(dev::u256(25000000000), dev::u256(1000000000));
+            dev::eth::TransactionBase copy = tx;
+            Error signErr, keyErr;
+            REQUIRE(wallet.signTransaction(tx, *signer, signErr) == wallet.signTransaction(copy, key, keyErr));
+            REQUIRE(signErr.getCode() == 0);
+
+            REQUIRE(wallet.getAccount(signer->addressHex(), "anvil", *signer, 0));
+            REQUIRE(!wallet.getAccount("0x70997970C51812dc3A010C7d01b50e0d17dc79C8", "anvil", *signer, 0));
+        }
+    }
+
+    TEST_CASE("Batch Recovery", "[wallet]")
+    {
+        std::unique_ptr<Provider> provider = std::make_unique<Provider>("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", "");
+        Wallet wallet(provider);
+        std::optional<Signer> signer = Signer::fromPrivateKey("ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80");
+        REQUIRE(signer);
+        std::vector<std::string> messages, signatures;
+        for (int i = 0; i < 200; i++) {
+          messages.push_back("order " + std::to_string(i));
+          signatures.push_back(signer->signMessage(messages.back()));
+        }
+        // v as 27/28, like most other signers produce it.
+        std::string legacy = signatures[0];
+        legacy.replace(legacy.size() - 2, 2, (legacy.substr(legacy.size() - 2) == "00") ? "1b" : "1c");
+        std::vector<std::pair<std::string_view, std::string_view>> batch;
+        for (std::size_t i = 0; i < messages.size(); i++) batch.emplace_back(messages[i], signatures[i]);
+        batch.emplace_back(messages[0], legacy);
+        batch.emplace_back(messages[0], "0x1234");
+
+        SECTION("Every signer is recovered")
+        {
+            std::vector<dev::Address> addresses = wallet.ecRecover(batch, 4);
+            REQUIRE(addresses.size() == batch.size());
+            for (std::size_t i = 0; i + 1 < addresses.size(); i++) REQUIRE(addresses[i] == signer->address());
+            REQUIRE(!addresses.back());
+            REQUIRE(wallet.ecRecover(messages[1], signatures[1]) == "0x" + signer->address().hex());
+        }
+
+        SECTION("Recovered signers are cached")
+        {
+            wallet.recoverCache = std::make_shared<RecoverCache>();
+            wallet.ecRecover(batch, 4);
+            REQUIRE(wallet.recoverCache->stats().hits == 0);
+            std::vector<dev::Address> addresses = wallet.ecRecover(batch, 4);
+            REQUIRE(wallet.recoverCache->stats().hits == messages.size() + 1);
+            for (std::size_t i = 0; i + 1 < addresses.size(); i++) REQUIRE(addresses[i] == signer->address());
+        }
+    }
+
+    TEST_CASE("Batch Signing", "[wallet]")
+    {
+        // Signing needs no node, only the chain ID.
+        std::unique_ptr<Provider> provider = std::make_unique<Provider>("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", "");
+        Wallet wallet(provider);
+        // Anvil's first default account.
+        const std::string from = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
+        const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+        auto makeTxs = [&](std::size_t count) {
+            std::vector<dev::eth::TransactionBase> txs;
+            for (std::size_t i = 0; i < count; i++) {
+                Error err;
+                dev::eth::TransactionBase tx(wallet.buildTransaction(from, i, err, from, "", i + 1));
+                tx.setGas(21000);
+                tx.setFees(dev::u256(25000000000), dev::u256(1000000000));
+                txs.push_back(std::move(tx));
+            }
+            return txs;
+        };
+
+        SECTION("Batch matches signing one by one")
+        {
+            std::vector<dev::eth::TransactionBase> txs = makeTxs(100);
+            std::vector<dev::eth::TransactionBase> copies = txs;
+            Error err;
+            Wallet::SignedBatch batch = wallet.signTransactions(txs, key, err, 4);
+            REQUIRE(err.getCode() == 0);
+            REQUIRE(batch.size() == 100);
+            for (std::size_t i = 0; i < copies.size(); i++) {
+                Error signErr;
+                REQUIRE(batch[i] == wallet.signTransaction(copies[i], key, signErr));
+            }
+
+            Error keyErr;
+            REQUIRE(wallet.signTransactions(txs, "0xnotakey", keyErr).size() == 100);
+            REQUIRE(keyErr.getCode() == 12);
+        }
+    }
+
+    // Hidden, run with `web3cpp-tests "[benchmark]"`.
+    TEST_CASE("Batch Signing Benchmark", "[.][benchmark]")
+    {
+        std::unique_ptr<Provider> provider = std::make_unique<Provider>("anvil", "127.0.0.1", "/", 8545, 31337, "ETH", "");
+        Wallet wallet(provider);
+        const std::string from = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
+        const std::string key = "ac0974bec39a17e36ba4a6b4d238ff944bacb478cbed5efcae784d7bf4f2ff80";
+        std::vector<dev::eth::TransactionBase> txs;
+        for (std::size_t i = 0; i < 2000; i++) {
+            Error err;
+            dev::eth::TransactionBase tx(wallet.buildTransaction(from, i, err, from, "", i + 1));
+            tx.setGas(21000);
+            tx.setFees(dev::u256(25000000000), dev::u256(1000000000));
+            txs.push_back(std::move(tx));
+        }
+
+        const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int threads : {1u, 2u, 4u, cores}) {
+            BENCHMARK("Sign 2000 transactions, " + std::to_string(threads) + " threads") {
+                Error err;
+                return wallet.signTransactions(txs, key, err, threads);
+            };
+        }
+    }
+}